@@ -123,12 +123,13 @@ mpfr_acos (mpfr_ptr acos, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       mpfr_ui_sub (tmp, 1, tmp, MPFR_RNDN);
       mpfr_sqrt (tmp, tmp, MPFR_RNDN);
       mpfr_div (tmp, x, tmp, MPFR_RNDN);
-      mpfr_atan (arcc, tmp, MPFR_RNDN);
+      mpfr_atan (arcc, tmp, MPFR_RNDF);
       mpfr_const_pi (tmp, MPFR_RNDN);
       mpfr_div_2ui (tmp, tmp, 1, MPFR_RNDN);
       mpfr_sub (arcc, tmp, arcc, MPFR_RNDN);
 
-      if (MPFR_LIKELY (MPFR_CAN_ROUND (arcc, prec - supplement,
+      /* one bit less for the faithful arctangent */
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (arcc, prec - supplement - 1,
                                        MPFR_PREC (acos), rnd_mode)))
         break;
       MPFR_ZIV_NEXT (loop, prec);
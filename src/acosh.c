@@ -102,12 +102,12 @@ mpfr_acosh (mpfr_ptr y, mpfr_srcptr x , mpfr_rnd_t rnd_mode)
                assume that we obtain the same result by evaluating ln(2x).
                We need to compute ln(x) + ln(2) as 2x can overflow. TODO:
                write a proof and add an MPFR_ASSERTN. */
-            mpfr_log (t, x, MPFR_RNDN);  /* err(log) < 1/2 ulp(t) */
+            mpfr_log (t, x, MPFR_RNDF);  /* err(log) < 1 ulp(t) */
             pln2 = Nt - MPFR_PREC_MIN < MPFR_GET_EXP (t) ?
               MPFR_PREC_MIN : Nt - MPFR_GET_EXP (t);
             mpfr_init2 (ln2, pln2);
             mpfr_const_log2 (ln2, MPFR_RNDN);  /* err(ln2) < 1/2 ulp(t) */
-            mpfr_add (t, t, ln2, MPFR_RNDN);  /* err <= 3/2 ulp(t) */
+            mpfr_add (t, t, ln2, MPFR_RNDN);  /* err <= 2 ulp(t) */
             mpfr_clear (ln2);
             err = 1;
           }
@@ -130,12 +130,14 @@ mpfr_acosh (mpfr_ptr y, mpfr_srcptr x , mpfr_rnd_t rnd_mode)
                 d = exp_te - MPFR_GET_EXP (t);
                 mpfr_sqrt (t, t, MPFR_RNDN);        /* sqrt(x^2-1) */
                 mpfr_add (t, t, x, MPFR_RNDN);      /* sqrt(x^2-1)+x */
-                mpfr_log (t, t, MPFR_RNDN);         /* ln(sqrt(x^2-1)+x) */
+                mpfr_log (t, t, MPFR_RNDF);         /* ln(sqrt(x^2-1)+x) */
 
-                /* error estimate -- see algorithms.tex */
+                /* error estimate -- see algorithms.tex, where the error
+                   of the logarithm is 1 ulp instead of 1/2 ulp since it
+                   is only faithful */
                 err = 3 + MAX (1, d) - MPFR_GET_EXP (t);
-                /* error is bounded by 1/2 + 2^err <= 2^(max(0,1+err)) */
-                err = MAX (0, 1 + err);
+                /* error is bounded by 1 + 2^err <= 2^(max(1,1+err)) */
+                err = MAX (1, 1 + err);
               }
           }
 
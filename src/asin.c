@@ -108,8 +108,9 @@ mpfr_asin (mpfr_ptr asin, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
           mpfr_ui_sub (xp, 1, xp, MPFR_RNDN);
           mpfr_sqrt (xp, xp, MPFR_RNDN);
           mpfr_div (xp, x, xp, MPFR_RNDN);
-          mpfr_atan (xp, xp, MPFR_RNDN);
-          if (MPFR_LIKELY (MPFR_CAN_ROUND (xp, prec - xp_exp,
+          mpfr_atan (xp, xp, MPFR_RNDF);
+          /* one bit less for the faithful arctangent */
+          if (MPFR_LIKELY (MPFR_CAN_ROUND (xp, prec - xp_exp - 1,
                                            MPFR_PREC (asin), rnd_mode)))
             break;
           MPFR_ZIV_NEXT (loop, prec);
@@ -93,12 +93,14 @@ mpfr_asinh (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       mpfr_add_ui (t, t, 1, MPFR_RNDD);                 /* x^2+1 */
       mpfr_sqrt (t, t, MPFR_RNDN);                      /* sqrt(x^2+1) */
       (neg ? mpfr_sub : mpfr_add) (t, t, x, MPFR_RNDN); /* sqrt(x^2+1)+x */
-      mpfr_log (t, t, MPFR_RNDN);                       /* ln(sqrt(x^2+1)+x)*/
+      mpfr_log (t, t, MPFR_RNDF);                       /* ln(sqrt(x^2+1)+x)*/
 
       if (MPFR_LIKELY (MPFR_IS_PURE_FP (t)))
         {
-          /* error estimate -- see algorithms.tex */
-          err = Nt - (MAX (4 - MPFR_GET_EXP (t), 0) + 1);
+          /* error estimate -- see algorithms.tex, with 1 ulp instead of
+             1/2 ulp for the faithful logarithm: the error is at most
+             (2+5*2^(2-EXP(t))) ulp(t) <= 2^(max(5-EXP(t),1)+1) ulp(t) */
+          err = Nt - (MAX (5 - MPFR_GET_EXP (t), 1) + 1);
           if (MPFR_LIKELY (MPFR_IS_ZERO (t)
                            || MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
             break;
@@ -186,6 +186,40 @@ mpfr_atan_aux (mpfr_ptr y, mpz_ptr p, long r, int m, mpz_t *tab)
   MPFR_SET_EXP (y, MPFR_EXP(y) + expo - r * (i - 1));
 }
 
+/* Put in atan the value of atan(x) rounded in the direction rnd_mode,
+   using the bit-burst algorithm (see bitburst.c), which avoids the square
+   roots of the argument reduction and the full-precision divisions of the
+   generic code. Assumes x is a regular number with |x| <> 1, and that the
+   exponent range has been extended. */
+int
+mpfr_atan_bitburst (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t t;
+  mpfr_prec_t prec;
+  mpfr_exp_t ex = MPFR_GET_EXP (x);
+  int err, inexact;
+  MPFR_ZIV_DECL (loop);
+
+  prec = MPFR_PREC (atan) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (atan)) + 10
+    + (ex < 0 ? -ex : 0);
+  mpfr_init2 (t, prec);
+  MPFR_ZIV_INIT (loop, prec);
+  for (;;)
+    {
+      /* the absolute error on t is at most 2^(err-prec) */
+      err = mpfr_bitburst_atan (t, x);
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, prec - err + MPFR_GET_EXP (t),
+                                       MPFR_PREC (atan), rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, prec);
+      mpfr_set_prec (t, prec);
+    }
+  MPFR_ZIV_FREE (loop);
+  inexact = mpfr_set (atan, t, rnd_mode);
+  mpfr_clear (t);
+  return inexact;
+}
+
 int
 mpfr_atan (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
@@ -266,6 +300,18 @@ mpfr_atan (mpfr_ptr atan, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       return mpfr_check_range (atan, inexact, rnd_mode);
     }
 
+  /* At large precision, use the bit-burst algorithm, unless |x| is so
+     large that its integer part would not fit in the working precision
+     (then atan(x) = Pi/2 - atan(1/x) with 1/x tiny, which the generic
+     code handles quickly). */
+  if (MPFR_PREC (atan) >= MPFR_ATAN_THRESHOLD
+      && MPFR_GET_EXP (xp) < (mpfr_exp_t) MPFR_PREC (atan))
+    {
+      inexact = mpfr_atan_bitburst (atan, x, rnd_mode);
+      MPFR_SAVE_EXPO_FREE (expo);
+      return mpfr_check_range (atan, inexact, rnd_mode);
+    }
+
   realprec = MPFR_PREC (atan) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (atan)) + 4;
   prec = realprec + GMP_NUMB_BITS;
 
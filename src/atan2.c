@@ -230,8 +230,9 @@ mpfr_atan2 (mpfr_ptr dest, mpfr_srcptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
             return mpfr_underflow (dest, rnd_mode, sign);
           }
 
-        mpfr_atan (tmp, tmp, MPFR_RNDN);   /* Error <= 2*ulp (tmp) since
-                                             abs(D(arctan)) <= 1 */
+        mpfr_atan (tmp, tmp, MPFR_RNDF);   /* Error <= 5/2*ulp (tmp) since
+                                             abs(D(arctan)) <= 1 and the
+                                             arctangent is faithful */
         /* TODO: check that the error bound is correct in case of overflow. */
         /* FIXME: Error <= ulp(tmp) ? */
         if (MPFR_LIKELY (MPFR_CAN_ROUND (tmp, prec - 2, MPFR_PREC (dest),
@@ -250,14 +251,15 @@ mpfr_atan2 (mpfr_ptr dest, mpfr_srcptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
           /* If tmp is 0, we have |y/x| <= 2^(-emin-2), thus
              atan|y/x| < 2^(-emin-2). */
           MPFR_SET_POS (tmp);               /* no error */
-          mpfr_atan (tmp, tmp, MPFR_RNDN);   /* Error <= 2*ulp (tmp) since
+          mpfr_atan (tmp, tmp, MPFR_RNDF);   /* Error <= 5/2*ulp (tmp) since
                                                abs(D(arctan)) <= 1 */
           mpfr_const_pi (pi, MPFR_RNDN);     /* Error <= ulp(pi) /2 */
           e = MPFR_NOTZERO(tmp) ? MPFR_GET_EXP (tmp) : __gmpfr_emin - 1;
           mpfr_sub (tmp, pi, tmp, MPFR_RNDN);          /* see above */
           if (MPFR_IS_NEG (y))
             MPFR_CHANGE_SIGN (tmp);
-          /* Error(tmp) <= (1/2+2^(EXP(pi)-EXP(tmp)-1)+2^(e-EXP(tmp)+1))*ulp
+          /* Error(tmp) <= (1/2+2^(EXP(pi)-EXP(tmp)-1)
+                            +5/4*2^(e-EXP(tmp)+1))*ulp
                         <= 2^(MAX (MAX (EXP(PI)-EXP(tmp)-1, e-EXP(tmp)+1),
                                         -1)+2)*ulp(tmp) */
           e = MAX (MAX (MPFR_GET_EXP (pi)-MPFR_GET_EXP (tmp) - 1,
@@ -0,0 +1,187 @@
+/* mpfr_atan2u -- arc-tangent of y/x in units of u
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+#define ULONG_BITS ((mpfr_prec_t) (sizeof (unsigned long) * CHAR_BIT))
+
+/* Set z to (-1)^neg * m*u/8 for 1 <= m <= 4, which is exact on
+   ULONG_BITS + 2 bits. */
+static int
+set_u8 (mpfr_ptr z, unsigned long m, unsigned long u, int neg,
+        mpfr_rnd_t rnd_mode)
+{
+  mpfr_t t;
+  int inex;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+  mpfr_init2 (t, ULONG_BITS + 2);
+  mpfr_set_ui (t, u, MPFR_RNDN);
+  mpfr_mul_ui (t, t, m, MPFR_RNDN);
+  mpfr_div_2ui (t, t, 3, MPFR_RNDN);
+  if (neg)
+    mpfr_neg (t, t, MPFR_RNDN);
+  inex = mpfr_set (z, t, rnd_mode);
+  mpfr_clear (t);
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (z, inex, rnd_mode);
+}
+
+/* atan2u(y, x) = atan2(y, x) * u/(2*Pi), thus in [-u/2, u/2]. The special
+   values are those of mpfr_atan2 scaled by u/(2*Pi): for example,
+   atan2u(+Inf, -Inf) = 3u/8, and these are exact when representable. */
+int
+mpfr_atan2u (mpfr_ptr z, mpfr_srcptr y, mpfr_srcptr x, unsigned long u,
+             mpfr_rnd_t rnd_mode)
+{
+  mpfr_t t, pi, ys;
+  mpfr_srcptr yy = y;
+  mpfr_prec_t prec, w;
+  mpfr_exp_t k = 0;
+  int inexact;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_LOG_FUNC
+    (("y[%Pu]=%.*Rg x[%Pu]=%.*Rg u=%lu rnd=%d",
+      mpfr_get_prec (y), mpfr_log_prec, y,
+      mpfr_get_prec (x), mpfr_log_prec, x, u, rnd_mode),
+     ("z[%Pu]=%.*Rg inexact=%d",
+      mpfr_get_prec (z), mpfr_log_prec, z, inexact));
+
+  if (MPFR_ARE_SINGULAR (x, y) || u == 0)
+    {
+      if (MPFR_IS_NAN (x) || MPFR_IS_NAN (y) || u == 0)
+        {
+          MPFR_SET_NAN (z);
+          MPFR_RET_NAN;
+        }
+      if (MPFR_IS_ZERO (y))
+        {
+          if (MPFR_IS_NEG (x)) /* +/- u/2 */
+            return set_u8 (z, 4, u, MPFR_IS_NEG (y), rnd_mode);
+        set_zero:
+          MPFR_SET_ZERO (z);
+          MPFR_SET_SAME_SIGN (z, y);
+          MPFR_RET (0);
+        }
+      if (MPFR_IS_ZERO (x)) /* +/- u/4 */
+        return set_u8 (z, 2, u, MPFR_IS_NEG (y), rnd_mode);
+      if (MPFR_IS_INF (y))
+        {
+          if (!MPFR_IS_INF (x)) /* +/- u/4 */
+            return set_u8 (z, 2, u, MPFR_IS_NEG (y), rnd_mode);
+          /* +/- u/8 or +/- 3u/8 */
+          return set_u8 (z, MPFR_IS_POS (x) ? 1 : 3, u, MPFR_IS_NEG (y),
+                         rnd_mode);
+        }
+      MPFR_ASSERTD (MPFR_IS_INF (x));
+      if (MPFR_IS_NEG (x)) /* +/- u/2 */
+        return set_u8 (z, 4, u, MPFR_IS_NEG (y), rnd_mode);
+      goto set_zero;
+    }
+
+  /* atan2(y, x) = +/-Pi/4 or +/-3Pi/4 when |y| = |x| */
+  if (mpfr_cmpabs (y, x) == 0)
+    return set_u8 (z, MPFR_IS_POS (x) ? 1 : 3, u, MPFR_IS_NEG (y), rnd_mode);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  prec = MPFR_PREC (z);
+  w = prec + MPFR_INT_CEIL_LOG2 (prec) + 10;
+  mpfr_init2 (t, w);
+  mpfr_init2 (pi, w);
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      MPFR_BLOCK_DECL (flags);
+
+      MPFR_BLOCK (flags, mpfr_atan2 (t, yy, x, MPFR_RNDN));
+      if (MPFR_UNLIKELY (MPFR_UNDERFLOW (flags)))
+        {
+          int sign = MPFR_SIGN (y);
+
+          /* Then x > 0 and |y/x| < 2^(MPFR_EMIN_MIN-1), but u/(2*Pi) may
+             be large. Since atan(y/x) = y/x*(1+O((y/x)^2)), we compute
+             atan2u(y*2^k, x)*2^(-k) instead. If it still underflows, then
+             |atan2u(y, x)| < 2^(MPFR_EMIN_MIN-1-k+ULONG_BITS-2), which is
+             less than 2^(emin-2). */
+          if (k == 0)
+            {
+              k = ULONG_BITS;
+              mpfr_init2 (ys, MPFR_PREC (y));
+              mpfr_mul_2si (ys, y, k, MPFR_RNDN); /* exact */
+              yy = ys;
+              continue;
+            }
+          MPFR_ZIV_FREE (loop);
+          mpfr_clear (ys);
+          mpfr_clear (t);
+          mpfr_clear (pi);
+          MPFR_SAVE_EXPO_FREE (expo);
+          return mpfr_underflow (z, (rnd_mode == MPFR_RNDN) ? MPFR_RNDZ :
+                                 rnd_mode, sign);
+        }
+      mpfr_mul_ui (t, t, u, MPFR_RNDN);
+      mpfr_const_pi (pi, MPFR_RNDN);
+      mpfr_div (t, t, pi, MPFR_RNDN);
+      mpfr_div_2ui (t, t, 1, MPFR_RNDN);
+      /* The relative error is at most (1+2^(-w))^4 - 1 < 2^(3-w), thus the
+         error is less than 2^(EXP(t)+4-w). If k != 0, the relative error
+         of atan(y/x*2^k) with respect to atan(y/x)*2^k is of the order of
+         (y/x*2^k)^2 < 2^(2*(MPFR_EMIN_MIN+ULONG_BITS)), which is covered
+         by the above bound. */
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, w - 4, prec, rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (t, w);
+      mpfr_set_prec (pi, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  inexact = mpfr_set (z, t, rnd_mode);
+  mpfr_clear (t);
+  mpfr_clear (pi);
+  if (k != 0)
+    mpfr_clear (ys);
+  MPFR_SAVE_EXPO_FREE (expo);
+
+  if (MPFR_UNLIKELY (k != 0))
+    {
+      int inex2;
+
+      /* See mpfr_pow_general and trigu.c */
+      if (rnd_mode == MPFR_RNDN && MPFR_INT_SIGN (z) * inexact < 0
+          && MPFR_GET_EXP (z) == __gmpfr_emin - 1 + k
+          && mpfr_powerof2_raw (z))
+        {
+          MPFR_ASSERTN (MPFR_PREC_MIN > 1);
+          mpfr_nexttoinf (z);
+        }
+      inex2 = mpfr_mul_2si (z, z, -k, rnd_mode);
+      if (inex2 != 0) /* underflow */
+        return inex2;
+    }
+  return mpfr_check_range (z, inexact, rnd_mode);
+}
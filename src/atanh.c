@@ -31,7 +31,7 @@ mpfr_atanh (mpfr_ptr y, mpfr_srcptr xt , mpfr_rnd_t rnd_mode)
 {
   int inexact;
   mpfr_t x, t, te;
-  mpfr_prec_t Nx, Ny, Nt;
+  mpfr_prec_t Ny, Nt;
   mpfr_exp_t err;
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
@@ -80,13 +80,15 @@ mpfr_atanh (mpfr_ptr y, mpfr_srcptr xt , mpfr_rnd_t rnd_mode)
 
   MPFR_SAVE_EXPO_MARK (expo);
 
-  /* Compute initial precision */
-  Nx = MPFR_PREC (xt);
+  /* Compute initial precision: it only depends on the output precision,
+     1-x and 1+x being rounded, plus the cancellation in the logarithm
+     when x is small, since log((1+x)/(1-x)) ~ 2x */
   MPFR_TMP_INIT_ABS (x, xt);
   Ny = MPFR_PREC (y);
-  Nt = MAX (Nx, Ny);
   /* the optimal number of bits : see algorithms.ps */
-  Nt = Nt + MPFR_INT_CEIL_LOG2 (Nt) + 4;
+  Nt = Ny + MPFR_INT_CEIL_LOG2 (Ny) + 4;
+  if (MPFR_GET_EXP (x) < 0)
+    Nt -= MPFR_GET_EXP (x);
 
   /* initialise of intermediary variable */
   mpfr_init2 (t, Nt);
@@ -100,13 +102,14 @@ mpfr_atanh (mpfr_ptr y, mpfr_srcptr xt , mpfr_rnd_t rnd_mode)
       mpfr_ui_sub (te, 1, x, MPFR_RNDU);   /* (1-xt)*/
       mpfr_add_ui (t,  x, 1, MPFR_RNDD);   /* (xt+1)*/
       mpfr_div (t, t, te, MPFR_RNDN);      /* (1+xt)/(1-xt)*/
-      mpfr_log (t, t, MPFR_RNDN);          /* ln((1+xt)/(1-xt))*/
+      mpfr_log (t, t, MPFR_RNDF);          /* ln((1+xt)/(1-xt))*/
       mpfr_div_2ui (t, t, 1, MPFR_RNDN);   /* (1/2)*ln((1+xt)/(1-xt))*/
 
       /* error estimate: see algorithms.tex */
       /* FIXME: this does not correspond to the value in algorithms.tex!!! */
       /* err=Nt-__gmpfr_ceil_log2(1+5*pow(2,1-MPFR_EXP(t)));*/
-      err = Nt - (MAX (4 - MPFR_GET_EXP (t), 0) + 1);
+      /* one more ulp(t) for the faithful logarithm */
+      err = Nt - (MAX (5 - MPFR_GET_EXP (t), 1) + 1);
 
       if (MPFR_LIKELY (MPFR_IS_ZERO (t)
                        || MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
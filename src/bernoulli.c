@@ -1,4 +1,4 @@
-/* bernoulli -- internal function to compute Bernoulli numbers.
+/* bernoulli -- internal functions to compute and cache Bernoulli numbers.
 
 Copyright 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012, 2013 Free Software Foundation, Inc.
 Contributed by the AriC and Caramel projects, INRIA.
@@ -20,9 +20,48 @@ along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
 http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
 
+#define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
-/* assuming b[0]...b[2(n-1)] are computed, computes and stores B[2n]*(2n+1)!
+/* We compute and cache C[n] = B[2n]*(2n+1)!, which is an integer (see
+   below), for n >= 0. The cache is thread-local (like the cache of the
+   constants), grows as needed, and is freed by mpfr_free_cache. Since the
+   C[n] are computed independently of each other for large n, the entries
+   that would make the cache larger than MPFR_CACHE_TABLE_LIMBS limbs
+   are not kept, but recomputed on each call. Likewise, C[n] is computed
+   directly when C[0], ..., C[n] cannot all fit in the cache, instead of
+   first filling the cache up to its limit. */
+
+/* C[n] is computed from the recurrence below for n < BERNOULLI_ZETA_MIN,
+   and from zeta(2n) otherwise. */
+#define BERNOULLI_ZETA_MIN 40
+
+/* The rounded values C[n] are kept for the BERNOULLI_FR_SLOTS precisions
+   that were used last, so that calls alternating between a few working
+   precisions (e.g., in successive Ziv iterations) do not round the whole
+   table again each time. Each slot may take up to MPFR_CACHE_TABLE_LIMBS
+   / BERNOULLI_FR_SLOTS limbs. */
+#define BERNOULLI_FR_SLOTS 4
+
+static MPFR_THREAD_ATTR mpz_t *bernoulli_table = NULL;
+static MPFR_THREAD_ATTR mpfr_t *bernoulli_fr[BERNOULLI_FR_SLOTS];
+static MPFR_THREAD_ATTR unsigned long bernoulli_size = 0;
+static MPFR_THREAD_ATTR unsigned long bernoulli_alloc = 0;
+static MPFR_THREAD_ATTR size_t bernoulli_limbs = 0;
+/* bernoulli_fr[i][0..bernoulli_fr_size[i]-1] are rounded to
+   bernoulli_fr_prec[i] (0 for an unused slot), and bernoulli_fr_last[i]
+   is the value of bernoulli_fr_clock when slot i was last used */
+static MPFR_THREAD_ATTR unsigned long bernoulli_fr_size[BERNOULLI_FR_SLOTS];
+static MPFR_THREAD_ATTR mpfr_prec_t bernoulli_fr_prec[BERNOULLI_FR_SLOTS];
+static MPFR_THREAD_ATTR unsigned long bernoulli_fr_last[BERNOULLI_FR_SLOTS];
+static MPFR_THREAD_ATTR unsigned long bernoulli_fr_clock = 0;
+/* entries that do not fit in the cache */
+static MPFR_THREAD_ATTR int bernoulli_scratch_init = 0;
+static MPFR_THREAD_ATTR mpz_t bernoulli_scratch;
+static MPFR_THREAD_ATTR mpfr_t bernoulli_scratch_fr;
+
+/* assuming b[0]...b[n-1] are computed, computes and stores B[2n]*(2n+1)!
+   in b[n], which must be initialized.
 
    t/(exp(t)-1) = sum(B[j]*t^j/j!, j=0..infinity)
    thus t = (exp(t)-1) * sum(B[j]*t^j/j!, n=0..infinity).
@@ -35,22 +74,16 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
    Then C[n] = -sum(binomial(n+1,k)*C[k]*n!/(k+1)!,  k=0..n-1),
    which proves that the C[n] are integers.
 */
-mpz_t*
-mpfr_bernoulli_internal (mpz_t *b, unsigned long n)
+static void
+bernoulli_rec (mpz_t *b, unsigned long n)
 {
   if (n == 0)
-    {
-      b = (mpz_t *) (*__gmp_allocate_func) (sizeof (mpz_t));
-      mpz_init_set_ui (b[0], 1);
-    }
+    mpz_set_ui (b[0], 1);
   else
     {
       mpz_t t;
       unsigned long k;
 
-      b = (mpz_t *) (*__gmp_reallocate_func)
-        (b, n * sizeof (mpz_t), (n + 1) * sizeof (mpz_t));
-      mpz_init (b[n]);
       /* b[n] = -sum(binomial(2n+1,2k)*C[k]*(2n)!/(2k+1)!,  k=0..n-1) */
       mpz_init_set_ui (t, 2 * n + 1);
       mpz_mul_ui (t, t, 2 * n - 1);
@@ -76,5 +109,309 @@ mpfr_bernoulli_internal (mpz_t *b, unsigned long n)
       mpz_neg (b[n], b[n]);
       mpz_clear (t);
     }
-  return b;
+}
+
+static int
+is_prime (unsigned long p)
+{
+  unsigned long q;
+
+  if (p < 4)
+    return p >= 2;
+  if ((p & 1) == 0)
+    return 0;
+  for (q = 3; q <= p / q; q += 2)
+    if (p % q == 0)
+      return 0;
+  return 1;
+}
+
+/* Put in c the value of C[n] = B[2n]*(2n+1)! for n >= 2, using
+   |B[2n]| = 2*(2n)!/(2*Pi)^(2n)*zeta(2n). By the von Staudt-Clausen
+   theorem, the denominator of B[2n] is the product D of the primes p such
+   that p-1 divides 2n, thus N = B[2n]*D is an integer, which we get by
+   computing an approximation y of |N| with an error less than 1/4.
+   Then C[n] = N*(2n+1)!/D.
+
+   Let s = 2n, w the working precision and u = 2^(-w). We compute
+   1/zeta(s) by the Euler product over the primes p <= P, with
+   P^(s-1) >= 2^(w+1), which gives 1/zeta(s) with a relative error less
+   than 2^(1-w) [since sum(p^(-s), p > P) <= P^(1-s)/(s-1)]. Each factor
+   1 - p^(-s) gets 3 roundings [computation of p^(-s) and subtraction,
+   where p^(-s) <= 1/4 amplifies the error on p^(-s) by at most 1/3, and
+   the product]. The numerator 2*D*(2n)! is exact and gets one rounding,
+   (2*Pi)^s gets s+1 roundings, and there are two more roundings in the
+   final product and division. With K = s + 3*np + 7, where np is the
+   number of primes p <= P, the relative error is bounded by
+   (1+u)^K - 1 <= 2*K*u, and the absolute error by
+   2^(EXP(y)+1+ceil(log2(K))-w). */
+static void
+bernoulli_zeta (mpz_ptr c, unsigned long n)
+{
+  mpz_t num, den;
+  mpfr_t y, z, t;
+  mpfr_prec_t w;
+  mpfr_exp_t ey;
+  unsigned long s = 2 * n, d, p, P, np, K;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_ASSERTD (n >= 2);
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* den = D, von Staudt-Clausen */
+  mpz_init_set_ui (den, 1);
+  for (d = 1; d <= s / d; d++)
+    if (s % d == 0)
+      {
+        if (is_prime (d + 1))
+          mpz_mul_ui (den, den, d + 1);
+        if (d != s / d && is_prime (s / d + 1))
+          mpz_mul_ui (den, den, s / d + 1);
+      }
+
+  /* num = 2*D*s! */
+  mpz_init (num);
+  mpz_fac_ui (num, s);
+  mpz_mul (num, num, den);
+  mpz_mul_2exp (num, num, 1);
+
+  /* log2((2*Pi)^s) > 2.6514*s, and zeta(s) < 2 */
+  w = (mpfr_prec_t) mpz_sizeinbase (num, 2)
+    - (mpfr_prec_t) (2.6514 * (double) s) + 1;
+  w += MPFR_INT_CEIL_LOG2 (s) + 10;
+  mpfr_init2 (y, w);
+  mpfr_init2 (z, w);
+  mpfr_init2 (t, w);
+  for (;;)
+    {
+      P = (unsigned long) __gmpfr_ceil_exp2 ((double) (w + 1)
+                                             / (double) (s - 1));
+      P = MAX (P, 2);
+      /* z <- product of 1 - p^(-s) for p <= P */
+      mpfr_set_ui (z, 1, MPFR_RNDN);
+      for (p = 2, np = 0; p <= P; p++)
+        if (is_prime (p))
+          {
+            mpfr_ui_pow_ui (t, p, s, MPFR_RNDN);
+            mpfr_ui_div (t, 1, t, MPFR_RNDN);
+            mpfr_ui_sub (t, 1, t, MPFR_RNDN);
+            mpfr_mul (z, z, t, MPFR_RNDN);
+            np ++;
+          }
+      /* y <- num/((2*Pi)^s * z) */
+      mpfr_const_pi (t, MPFR_RNDN);
+      mpfr_mul_2ui (t, t, 1, MPFR_RNDN);
+      mpfr_pow_ui (t, t, s, MPFR_RNDN);
+      mpfr_mul (z, z, t, MPFR_RNDN);
+      mpfr_set_z (y, num, MPFR_RNDN);
+      mpfr_div (y, y, z, MPFR_RNDN);
+      K = s + 3 * np + 7;
+      ey = MPFR_GET_EXP (y);
+      /* check that the error is less than 1/4 */
+      if (ey + 1 + MPFR_INT_CEIL_LOG2 (K) - w <= -2)
+        break;
+      w = ey + MPFR_INT_CEIL_LOG2 (K) + 4;
+      mpfr_set_prec (y, w);
+      mpfr_set_prec (z, w);
+      mpfr_set_prec (t, w);
+    }
+  mpfr_get_z (c, y, MPFR_RNDN);
+  if ((n & 1) == 0) /* B[2n] < 0 for n even */
+    mpz_neg (c, c);
+  /* c <- N*(2n+1)!/D */
+  mpz_fac_ui (num, s + 1);
+  mpz_mul (c, c, num);
+  mpz_divexact (c, c, den);
+
+  mpz_clear (num);
+  mpz_clear (den);
+  mpfr_clear (y);
+  mpfr_clear (z);
+  mpfr_clear (t);
+  MPFR_SAVE_EXPO_FREE (expo);
+}
+
+/* Return non-zero if C[bernoulli_size], ..., C[n] may be added to the
+   cache without exceeding MPFR_CACHE_TABLE_LIMBS limbs. By Stirling's
+   formula, |C[k]| >= 2*((2k)!)^2/(2*Pi)^(2k) has at least
+   2k*(2*log2(2k/e) - log2(2*Pi)) bits, which is at least
+   n*(2*floor(log2(n)) - 5.54) when 2k >= n. We sum this lower bound over
+   the indices k >= max(bernoulli_size, n/2) not yet in the cache. */
+static int
+bernoulli_may_fit (unsigned long n)
+{
+  unsigned long k0;
+  double bits;
+
+  if (n < BERNOULLI_ZETA_MIN)
+    return 1;
+  bits = (double) n * (2.0 * (double) __gmpfr_floor_log2 ((double) n)
+                       - 5.54);
+  if (bits <= 0.0)
+    return 1;
+  k0 = MAX (bernoulli_size, (n + 1) / 2);
+  return (double) bernoulli_limbs + (double) (n + 1 - k0) * bits
+    / (double) GMP_NUMB_BITS <= (double) MPFR_CACHE_TABLE_LIMBS;
+}
+
+/* Return C[n] = B[2n]*(2n+1)!. The result is valid until the next call
+   to mpfr_bernoulli_cache, mpfr_bernoulli_cache_fr or mpfr_free_cache. */
+mpz_srcptr
+mpfr_bernoulli_cache (unsigned long n)
+{
+  while (n >= bernoulli_size)
+    {
+      int i;
+
+      if (bernoulli_limbs > MPFR_CACHE_TABLE_LIMBS
+          || ! bernoulli_may_fit (n))
+        {
+          /* the cache is full, or would be before reaching C[n] */
+          MPFR_ASSERTN (n >= BERNOULLI_ZETA_MIN);
+          if (bernoulli_scratch_init == 0)
+            {
+              mpz_init (bernoulli_scratch);
+              mpfr_init2 (bernoulli_scratch_fr, MPFR_PREC_MIN);
+              bernoulli_scratch_init = 1;
+            }
+          bernoulli_zeta (bernoulli_scratch, n);
+          return bernoulli_scratch;
+        }
+      if (bernoulli_size == bernoulli_alloc)
+        {
+          unsigned long new_alloc = bernoulli_alloc == 0 ? 16
+            : 2 * bernoulli_alloc;
+
+          if (bernoulli_alloc == 0)
+            {
+              bernoulli_table = (mpz_t *) (*__gmp_allocate_func)
+                (new_alloc * sizeof (mpz_t));
+              for (i = 0; i < BERNOULLI_FR_SLOTS; i++)
+                bernoulli_fr[i] = (mpfr_t *) (*__gmp_allocate_func)
+                  (new_alloc * sizeof (mpfr_t));
+            }
+          else
+            {
+              bernoulli_table = (mpz_t *) (*__gmp_reallocate_func)
+                (bernoulli_table, bernoulli_alloc * sizeof (mpz_t),
+                 new_alloc * sizeof (mpz_t));
+              for (i = 0; i < BERNOULLI_FR_SLOTS; i++)
+                bernoulli_fr[i] = (mpfr_t *) (*__gmp_reallocate_func)
+                  (bernoulli_fr[i], bernoulli_alloc * sizeof (mpfr_t),
+                   new_alloc * sizeof (mpfr_t));
+            }
+          bernoulli_alloc = new_alloc;
+        }
+      mpz_init (bernoulli_table[bernoulli_size]);
+      if (bernoulli_size < BERNOULLI_ZETA_MIN)
+        bernoulli_rec (bernoulli_table, bernoulli_size);
+      else
+        bernoulli_zeta (bernoulli_table[bernoulli_size], bernoulli_size);
+      for (i = 0; i < BERNOULLI_FR_SLOTS; i++)
+        mpfr_init2 (bernoulli_fr[i][bernoulli_size], MPFR_PREC_MIN);
+      bernoulli_limbs += mpz_size (bernoulli_table[bernoulli_size]);
+      bernoulli_size ++;
+    }
+  return bernoulli_table[n];
+}
+
+/* Return C[n] = B[2n]*(2n+1)! rounded to nearest on prec bits. The rounded
+   values of the cache are kept for the last BERNOULLI_FR_SLOTS values of
+   prec. The result is valid until the next call to mpfr_bernoulli_cache,
+   mpfr_bernoulli_cache_fr or mpfr_free_cache. */
+mpfr_srcptr
+mpfr_bernoulli_cache_fr (unsigned long n, mpfr_prec_t prec)
+{
+  mpz_srcptr c;
+  mpfr_ptr r;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  c = mpfr_bernoulli_cache (n);
+  MPFR_SAVE_EXPO_MARK (expo);
+  if (n >= bernoulli_size
+      || (n + 1) * MPFR_PREC2LIMBS (prec)
+      > MPFR_CACHE_TABLE_LIMBS / BERNOULLI_FR_SLOTS)
+    {
+      /* not in the cache, or the rounded values would take too much
+         memory */
+      if (bernoulli_scratch_init == 0)
+        {
+          mpz_init (bernoulli_scratch);
+          mpfr_init2 (bernoulli_scratch_fr, MPFR_PREC_MIN);
+          bernoulli_scratch_init = 1;
+        }
+      r = bernoulli_scratch_fr;
+      mpfr_set_prec (r, prec);
+      mpfr_set_z (r, c, MPFR_RNDN);
+    }
+  else
+    {
+      int i, j = 0;
+
+      /* look for the slot of prec, otherwise take the least recently used
+         one */
+      for (i = 0; i < BERNOULLI_FR_SLOTS; i++)
+        {
+          if (bernoulli_fr_prec[i] == prec)
+            break;
+          if (bernoulli_fr_last[i] < bernoulli_fr_last[j])
+            j = i;
+        }
+      if (i == BERNOULLI_FR_SLOTS)
+        {
+          i = j;
+          bernoulli_fr_prec[i] = prec;
+          bernoulli_fr_size[i] = 0;
+        }
+      bernoulli_fr_last[i] = ++bernoulli_fr_clock;
+      for (; bernoulli_fr_size[i] <= n; bernoulli_fr_size[i]++)
+        {
+          mpfr_ptr b = bernoulli_fr[i][bernoulli_fr_size[i]];
+
+          mpfr_set_prec (b, prec);
+          mpfr_set_z (b, bernoulli_table[bernoulli_fr_size[i]], MPFR_RNDN);
+        }
+      r = bernoulli_fr[i][n];
+    }
+  MPFR_SAVE_EXPO_FREE (expo);
+  return r;
+}
+
+/* Free the Bernoulli numbers cache. */
+void
+mpfr_bernoulli_freecache (void)
+{
+  unsigned long i;
+  int j;
+
+  for (i = 0; i < bernoulli_size; i++)
+    {
+      mpz_clear (bernoulli_table[i]);
+      for (j = 0; j < BERNOULLI_FR_SLOTS; j++)
+        mpfr_clear (bernoulli_fr[j][i]);
+    }
+  if (bernoulli_alloc != 0)
+    {
+      (*__gmp_free_func) (bernoulli_table, bernoulli_alloc * sizeof (mpz_t));
+      for (j = 0; j < BERNOULLI_FR_SLOTS; j++)
+        (*__gmp_free_func) (bernoulli_fr[j],
+                            bernoulli_alloc * sizeof (mpfr_t));
+    }
+  bernoulli_table = NULL;
+  for (j = 0; j < BERNOULLI_FR_SLOTS; j++)
+    {
+      bernoulli_fr[j] = NULL;
+      bernoulli_fr_size[j] = 0;
+      bernoulli_fr_prec[j] = 0;
+      bernoulli_fr_last[j] = 0;
+    }
+  bernoulli_size = bernoulli_alloc = 0;
+  bernoulli_limbs = 0;
+  bernoulli_fr_clock = 0;
+  if (bernoulli_scratch_init)
+    {
+      mpz_clear (bernoulli_scratch);
+      mpfr_clear (bernoulli_scratch_fr);
+      bernoulli_scratch_init = 0;
+    }
 }
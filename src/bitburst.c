@@ -0,0 +1,459 @@
+/* mpfr_bitburst_exp, mpfr_bitburst_atan -- bit-burst evaluation of
+   exp and atan at large precision
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* The bit-burst algorithm writes the argument as a sum of chunks
+   x = x_1 + x_2 + x_4 + ..., where x_k = y_k/2^(2k) with |y_k| < 2^k,
+   evaluates the series of each chunk by binary splitting, and combines
+   the results with the addition formula of the function. The number of
+   terms needed for x_k is about n/k for a precision of n bits, so that
+   each chunk costs O(M(n) log(n)), and the total cost is O(M(n) log(n)^2)
+   with a smooth dependency on n. This is the same scheme as sincos_aux in
+   sin_cos.c, with a binary splitting shared by exp and atan. */
+
+#define BS_EXP  0 /* t_k = x^k/k! */
+#define BS_ATAN 1 /* t_k = (-x)^k/(2k+1) */
+
+/* Binary splitting for S(n1,n2) = sum(prod(p(j)/q(j), j=n1..k)/b(k),
+   k=n1..n2-1) with p(0)/q(0) = 1 and b(0) = 1, where for j >= 1:
+   BS_EXP:  p(j) = u,  q(j) = j*2^r, b(j) = 1,
+   BS_ATAN: p(j) = -u, q(j) = 2^r,   b(j) = 2j+1.
+   Then S(0,N) is the sum of the first N terms of exp(u/2^r) for BS_EXP,
+   and of atan(x)/x with x^2 = u/2^r for BS_ATAN.
+   We compute P = prod(p(j)) [only if need_p is non-zero], Q = prod(q(j))
+   without its power of two, B = prod(b(j)), and T = B*Q*S including the
+   power of two of Q, using:
+   T(n1,n2) = B(m,n2)*Q(m,n2)*T(n1,m) + B(n1,m)*P(n1,m)*T(m,n2).
+   The power of two of Q(n1,n2) is 2^(r*c) with c = n2-n1 if n1 > 0 and
+   c = n2-n1-1 otherwise. Q = 1 for BS_ATAN and B = 1 for BS_EXP. */
+static void
+bs_rec (mpz_ptr T, mpz_ptr Q, mpz_ptr B, mpz_ptr P, int need_p, int kind,
+        mpz_srcptr u, mpfr_prec_t r, unsigned long n1, unsigned long n2)
+{
+  unsigned long m;
+  mpz_t T2, Q2, B2, P2;
+
+  if (n2 - n1 == 1)
+    {
+      if (n1 == 0)
+        {
+          mpz_set_ui (P, 1);
+          mpz_set_ui (T, 1);
+          mpz_set_ui (Q, 1);
+          mpz_set_ui (B, 1);
+        }
+      else if (kind == BS_EXP)
+        {
+          mpz_set (P, u);
+          mpz_set (T, u);
+          mpz_set_ui (Q, n1);
+          mpz_set_ui (B, 1);
+        }
+      else
+        {
+          mpz_neg (P, u);
+          mpz_neg (T, u);
+          mpz_set_ui (Q, 1);
+          mpz_set_ui (B, 2 * n1 + 1);
+        }
+      return;
+    }
+
+  m = n1 + (n2 - n1) / 2;
+  bs_rec (T, Q, B, P, 1, kind, u, r, n1, m);
+  mpz_init (T2);
+  mpz_init (Q2);
+  mpz_init (B2);
+  mpz_init (P2);
+  bs_rec (T2, Q2, B2, P2, need_p, kind, u, r, m, n2);
+  if (kind == BS_EXP)
+    mpz_mul (T, T, Q2);
+  else
+    {
+      mpz_mul (T, T, B2);
+      mpz_mul (T2, T2, B);
+      mpz_mul (B, B, B2);
+    }
+  mpz_mul_2exp (T, T, r * (n2 - m));
+  mpz_mul (T2, T2, P);
+  mpz_add (T, T, T2);
+  if (kind == BS_EXP)
+    mpz_mul (Q, Q, Q2);
+  if (need_p)
+    mpz_mul (P, P, P2);
+  mpz_clear (T2);
+  mpz_clear (Q2);
+  mpz_clear (B2);
+  mpz_clear (P2);
+}
+
+/* Truncate Q from R to at most prec bits.
+   Return the number of truncated bits. */
+static mpfr_prec_t
+reduce (mpz_ptr Q, mpz_srcptr R, mpfr_prec_t prec)
+{
+  mpfr_prec_t l = mpz_sizeinbase (R, 2);
+
+  l = (l > prec) ? l - prec : 0;
+  mpz_fdiv_q_2exp (Q, R, l);
+  return l;
+}
+
+/* Put in T, Q, B an approximation of the series of kind 'kind' for
+   x = u/2^r with u odd and positive (x^2 = u/2^r for BS_ATAN), such that
+   T/(B*Q*2^l) approximates the sum with an absolute error at most
+   2^(-w-1) + 2^(3-w)*sum, where l is the return value. The terms are
+   at most 2^(-d) times the previous one [and even 2^(-d)/k for BS_EXP],
+   where d >= 1 for BS_ATAN since x^2 <= 1/4, and d >= 0 for BS_EXP with
+   x <= 1/2 (then the sum of the remaining terms is at most twice the
+   first one). */
+static mpfr_prec_t
+bs_series (mpz_ptr T, mpz_ptr Q, mpz_ptr B, int kind, mpz_srcptr u,
+           mpfr_prec_t r, mpfr_prec_t w)
+{
+  mpfr_prec_t d, acc, l;
+  unsigned long n;
+  mpz_t P;
+
+  MPFR_ASSERTD (mpz_sgn (u) > 0 && mpz_odd_p (u));
+  d = (mpz_cmp_ui (u, 1) == 0) ? r : r - (mpfr_prec_t) mpz_sizeinbase (u, 2);
+  MPFR_ASSERTD (d >= (kind == BS_ATAN));
+  /* find the first term t_n < 2^(-w-2), and sum the terms of index < n */
+  for (n = 1, acc = 0; ; n++)
+    {
+      acc += d;
+      if (kind == BS_EXP)
+        acc += MPFR_INT_CEIL_LOG2 (n + 1) - 1; /* floor(log2(n)) */
+      if (acc >= w + 2)
+        break;
+    }
+  mpz_init (P);
+  bs_rec (T, Q, B, P, 0, kind, u, r, 0, n);
+  mpz_clear (P);
+  l = r * (mpfr_prec_t) (n - 1);
+  l -= reduce (T, T, w);
+  l += reduce (Q, Q, w);
+  l += reduce (B, B, w);
+  return l;
+}
+
+/* Put in y an approximation of exp(x) for |x| < 1, and return err such
+   that the relative error is at most 2^(err - PREC(y)).
+   Assumes PREC(y) >= 10.
+
+   Let w = PREC(y) and n the number of chunks. Each chunk exp(x_k) is
+   approximated by T/(Q*2^l) with a relative error at most
+   2^(-w-1) + 2*2^(1-w) (tail of the series, at most 2^(-w-1) since
+   exp(x_k) >= 1, and truncation of T and Q), or z^2/2*exp(z) <= 2^(-w)
+   for the last chunk z, for which exp(z) ~ 1 + z. The accumulated
+   numerator and denominator are truncated to w bits after each product,
+   which adds 2*2^(1-w), and the final division and conversions add
+   2*2^(-w). Thus the relative error is bounded by (9n+2)*2^(-w) up to
+   second order terms, and by (10n+4)*2^(-w). The same bound holds for
+   1/exp(|x|) when x < 0. */
+int
+mpfr_bitburst_exp (mpfr_ptr y, mpfr_srcptr x)
+{
+  mpfr_t x2;
+  mpfr_prec_t w = MPFR_PREC (y), sh, l, l2;
+  mpz_t A, D, T, Q, B, u;
+  unsigned long n = 0;
+  int err;
+
+  MPFR_ASSERTD (w >= 10);
+  MPFR_ASSERTD (MPFR_GET_EXP (x) <= 0);
+
+  mpz_init_set_ui (A, 1);
+  mpz_init_set_ui (D, 1);
+  mpz_init (T);
+  mpz_init (Q);
+  mpz_init (B);
+  mpz_init (u);
+  mpfr_init2 (x2, MPFR_PREC (x));
+  mpfr_abs (x2, x, MPFR_RNDN); /* exact */
+  l = 0;
+
+  /* Invariant: |x| = X + x2/2^(sh-1), where exp(X) ~ A/(D*2^l) and
+     0 <= x2 < 1. */
+  for (sh = 1; !MPFR_IS_ZERO (x2) && sh <= w; sh <<= 1)
+    {
+      if (sh > w / 2) /* exp(z) = 1 + z + O(z^2) with z = x2/2^(sh-1) */
+        {
+          l2 = sh - 1 - mpfr_get_z_2exp (u, x2); /* z = u/2^l2 */
+          mpz_set_ui (T, 1);
+          mpz_mul_2exp (T, T, l2);
+          mpz_add (T, T, u);
+          mpz_set_ui (Q, 1);
+          mpfr_set_ui (x2, 0, MPFR_RNDN);
+        }
+      else
+        {
+          mpfr_prec_t z;
+
+          /* u <- trunc(x2 * 2^sh), the next chunk is u/2^(2sh-1) */
+          mpfr_mul_2ui (x2, x2, sh, MPFR_RNDN); /* exact */
+          mpfr_get_z (u, x2, MPFR_RNDZ);
+          if (mpz_sgn (u) == 0)
+            continue;
+          mpfr_sub_z (x2, x2, u, MPFR_RNDN); /* exact */
+          z = mpz_scan1 (u, 0);
+          mpz_fdiv_q_2exp (u, u, z);
+          l2 = bs_series (T, Q, B, BS_EXP, u, 2 * sh - 1 - z, w);
+        }
+      mpz_mul (A, A, T);
+      mpz_mul (D, D, Q);
+      l += l2;
+      l -= reduce (A, A, w);
+      l += reduce (D, D, w);
+      n++;
+    }
+
+  if (MPFR_IS_POS (x))
+    {
+      mpfr_set_z (y, A, MPFR_RNDN);
+      mpfr_div_z (y, y, D, MPFR_RNDN);
+      mpfr_div_2si (y, y, l, MPFR_RNDN);
+    }
+  else
+    {
+      mpfr_set_z (y, D, MPFR_RNDN);
+      mpfr_div_z (y, y, A, MPFR_RNDN);
+      mpfr_mul_2si (y, y, l, MPFR_RNDN);
+    }
+
+  mpz_clear (A);
+  mpz_clear (D);
+  mpz_clear (T);
+  mpz_clear (Q);
+  mpz_clear (B);
+  mpz_clear (u);
+  mpfr_clear (x2);
+  err = MPFR_INT_CEIL_LOG2 (10 * n + 4);
+  return err;
+}
+
+/* Scale A and B by the same power of two, truncating if needed, so that
+   the larger one has exactly prec bits. */
+static void
+reduce_pair (mpz_ptr A, mpz_ptr B, mpfr_prec_t prec)
+{
+  mpfr_prec_t la = mpz_sizeinbase (A, 2);
+  mpfr_prec_t lb = mpz_sizeinbase (B, 2);
+  mpfr_prec_t l;
+
+  l = (la > lb) ? la : lb;
+  if (l > prec)
+    {
+      mpz_fdiv_q_2exp (A, A, l - prec);
+      mpz_fdiv_q_2exp (B, B, l - prec);
+    }
+  else
+    {
+      mpz_mul_2exp (A, A, prec - l);
+      mpz_mul_2exp (B, B, prec - l);
+    }
+}
+
+/* Put in y an approximation of atan(x), and return err such that the
+   absolute error is at most 2^(err - PREC(y)).
+   Assumes PREC(y) >= 10.
+
+   We follow the angle of a + i*b, with b/a = x initially, and multiply it
+   by 1 - i*c for chunks c of b/a, which subtracts atan(c) from the angle
+   and only needs multiplications: atan(x) = sum(atan(c)) + atan(b/a),
+   where b/a is small enough at the end so that atan(b/a) ~ b/a.
+   If |x| > 1, we start with a + i*b = x - i, whose angle is atan(x)-Pi/2,
+   and we multiply by 1 +/- i (an angle of -/+ Pi/4) when |b/a| > 2/5, so
+   that |b/a| <= 3/7 < 1/2. Since the series of the first chunks would
+   converge slowly, we then halve the angle h times, replacing a by
+   a + sqrt(a^2+b^2), so that |b/a| < 2^(-h-1) before the first chunk.
+
+   Error analysis (w = PREC(y) + h, n the number of chunks): the
+   truncation of a and b to w + 2 bits changes the angle by at most
+   2^(-w), initially and after each rotation, and similarly for the
+   integer square root in each halving. For each chunk, |atan(c)| < 1/2
+   is computed with a relative error at most (6+1/2)*2^(-w) [tail and
+   truncations in bs_series, division, multiplication by the numerator of
+   c], and the sum s of the atan(c), with |s| < 1, gets a rounding error
+   at most 2^(-w-1), thus each chunk contributes at most 5*2^(-w). The
+   final atan(b/a) ~ b/a with |b/a| < 2^(-w/3) contributes 2*2^(-w). All
+   these errors are multiplied by 2^h when undoing the halvings, but
+   since the angle error of the j-th halving is multiplied by 2^j only,
+   the halvings contribute at most 2^(h-w). Finally the multiple of Pi/4
+   [at most 3Pi/4, computed with one rounding on Pi and one on the
+   product] and the final addition contribute at most 7*2^(h-w). Thus the
+   absolute error is bounded by (5n+11)*2^(h-w). */
+int
+mpfr_bitburst_atan (mpfr_ptr y, mpfr_srcptr x)
+{
+  mpfr_t s, t, q;
+  mpfr_prec_t w = MPFR_PREC (y), h, k, z, l;
+  mpfr_exp_t e;
+  mpz_t A, Bz, T, Q, B, u, v;
+  unsigned long n = 0;
+  int o = 0, neg, err;
+
+  MPFR_ASSERTD (w >= 10);
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x));
+
+  /* number of halvings of the angle */
+  h = MPFR_INT_CEIL_LOG2 (w) / 2;
+  w += h;
+
+  mpz_init (A);
+  mpz_init (Bz);
+  mpz_init (T);
+  mpz_init (Q);
+  mpz_init (B);
+  mpz_init (u);
+  mpz_init (v);
+  mpfr_init2 (s, w);
+  mpfr_init2 (t, w);
+  mpfr_init2 (q, MPFR_PREC_MIN);
+
+  neg = MPFR_IS_NEG (x);
+  e = mpfr_get_z_2exp (Bz, x); /* x = Bz*2^e */
+  mpz_abs (Bz, Bz);
+  /* a + i*b = 1 + i*x, or x - i if |x| > 1 */
+  mpz_set_ui (A, 1);
+  if (e >= 0)
+    mpz_mul_2exp (Bz, Bz, e);
+  else
+    mpz_mul_2exp (A, A, -e);
+  if (mpfr_cmp_si (x, 1) > 0 || mpfr_cmp_si (x, -1) < 0)
+    {
+      mpz_swap (A, Bz);
+      mpz_neg (Bz, Bz);
+      o = 2;
+    }
+  reduce_pair (A, Bz, w + 2);
+  /* if |b/a| > 2/5, rotate by -/+ Pi/4 */
+  mpz_mul_ui (T, Bz, 5);
+  mpz_mul_ui (Q, A, 2);
+  if (mpz_cmpabs (T, Q) > 0)
+    {
+      mpz_add (T, A, Bz);
+      mpz_sub (Q, A, Bz);
+      if (mpz_sgn (Bz) > 0)
+        {
+          /* (a + i*b)*(1 - i) = (a + b) + i*(b - a) */
+          mpz_swap (A, T);
+          mpz_neg (Bz, Q);
+          o ++;
+        }
+      else
+        {
+          /* (a + i*b)*(1 + i) = (a - b) + i*(a + b) */
+          mpz_swap (A, Q);
+          mpz_swap (Bz, T);
+          o --;
+        }
+    }
+  /* (a + i*b) <- a + sqrt(a^2+b^2) + i*b, which halves the angle */
+  for (k = 0; k < h; k++)
+    {
+      mpz_mul (T, A, A);
+      mpz_addmul (T, Bz, Bz);
+      mpz_sqrt (T, T);
+      mpz_add (A, A, T);
+      reduce_pair (A, Bz, w + 2);
+    }
+  mpfr_set_ui (s, 0, MPFR_RNDN);
+
+  /* Invariant: |b/a| < 2^(-k). */
+  for (k = h + 1; 3 * k < w && mpz_sgn (Bz) != 0; k <<= 1)
+    {
+      /* u <- round(b/a*2^(2k)), where b/a is approximated to 2k+8 bits,
+         so that the error on u/2^(2k) is at most 2^(-2k-1) + 2^(-3k-6),
+         and the next value of |b/a| is less than 2^(-2k) */
+      mpfr_set_prec (q, 2 * k + 8);
+      mpfr_set_prec (t, 2 * k + 8);
+      mpfr_set_z (q, Bz, MPFR_RNDN);
+      mpfr_set_z (t, A, MPFR_RNDN);
+      mpfr_div (q, q, t, MPFR_RNDN);
+      mpfr_mul_2ui (q, q, 2 * k, MPFR_RNDN);
+      mpfr_get_z (u, q, MPFR_RNDN);
+      mpfr_set_prec (t, w);
+      n++;
+      if (mpz_sgn (u) == 0)
+        continue;
+
+      /* a + i*b <- (a + i*b)*(2^(2k) - i*u) */
+      mpz_mul (T, Bz, u);
+      mpz_mul (Q, A, u);
+      mpz_mul_2exp (A, A, 2 * k);
+      mpz_add (A, A, T);
+      mpz_mul_2exp (Bz, Bz, 2 * k);
+      mpz_sub (Bz, Bz, Q);
+      reduce_pair (A, Bz, w + 2);
+
+      /* s <- s + atan(c), c = u/2^(2k) = u'/2^(2k-z) with u' odd */
+      z = mpz_scan1 (u, 0);
+      mpz_fdiv_q_2exp (u, u, z);
+      mpz_mul (v, u, u);
+      l = bs_series (T, Q, B, BS_ATAN, v, 2 * (2 * k - z), w);
+      /* atan(c)/c ~ T/(B*2^l) */
+      mpfr_set_z (t, T, MPFR_RNDN); /* exact */
+      mpfr_div_z (t, t, B, MPFR_RNDN);
+      mpfr_mul_z (t, t, u, MPFR_RNDN);
+      mpfr_div_2si (t, t, l + 2 * k - z, MPFR_RNDN);
+      mpfr_add (s, s, t, MPFR_RNDN);
+    }
+
+  /* atan(b/a) ~ b/a */
+  if (mpz_sgn (Bz) != 0)
+    {
+      mpfr_set_z (t, Bz, MPFR_RNDN);
+      mpfr_div_z (t, t, A, MPFR_RNDN);
+      mpfr_add (s, s, t, MPFR_RNDN);
+    }
+
+  /* y <- o*Pi/4 + s*2^h */
+  mpfr_mul_2ui (s, s, h, MPFR_RNDN);
+  if (o != 0)
+    {
+      mpfr_const_pi (t, MPFR_RNDN);
+      mpfr_mul_si (t, t, o, MPFR_RNDN);
+      mpfr_div_2ui (t, t, 2, MPFR_RNDN);
+      mpfr_add (y, s, t, MPFR_RNDN);
+    }
+  else
+    mpfr_set (y, s, MPFR_RNDN);
+  if (neg)
+    mpfr_neg (y, y, MPFR_RNDN);
+
+  mpz_clear (A);
+  mpz_clear (Bz);
+  mpz_clear (T);
+  mpz_clear (Q);
+  mpz_clear (B);
+  mpz_clear (u);
+  mpz_clear (v);
+  mpfr_clear (s);
+  mpfr_clear (t);
+  mpfr_clear (q);
+  err = MPFR_INT_CEIL_LOG2 (5 * n + 11);
+  return err;
+}
@@ -25,7 +25,6 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 void
 mpfr_clear (mpfr_ptr m)
 {
-  (*__gmp_free_func) (MPFR_GET_REAL_PTR (m),
-                      MPFR_MALLOC_SIZE (MPFR_GET_ALLOC_SIZE (m)));
+  mpfr_pool_free_mant (MPFR_MANT (m));
   MPFR_MANT (m) = (mp_limb_t *) 0;
 }
@@ -26,13 +26,13 @@ int
 mpfr_cmp_d (mpfr_srcptr b, double d)
 {
   mpfr_t tmp;
+  mp_limb_t tmpmant[MPFR_LIMBS_PER_DOUBLE];
   int res;
 
-  mpfr_init2 (tmp, IEEE_DBL_MANT_DIG);
+  MPFR_TMP_INIT1 (tmpmant, tmp, IEEE_DBL_MANT_DIG);
   res = mpfr_set_d (tmp, d, MPFR_RNDN);
   MPFR_ASSERTD (res == 0);
   res = mpfr_cmp (b, tmp);
-  mpfr_clear (tmp);
 
   return res;
 }
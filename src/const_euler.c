@@ -34,219 +34,218 @@ mpfr_const_euler (mpfr_ptr x, mpfr_rnd_t rnd_mode) {
 }
 
 
-static void mpfr_const_euler_S2 (mpfr_ptr, mpfr_t);
-static void mpfr_const_euler_R (mpfr_ptr, unsigned long);
-
-int
-mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
+/* We use the refined Brent-McMillan formula (algorithm B3 in Brent and
+   McMillan, "Some new algorithms for high-precision computation of Euler's
+   constant", Math. Comp. 34, 1980):
+
+     gamma = A/B - C/B^2 - log(n) + E(n)
+
+   with, for N >= alpha*n where alpha = 4.9706... satisfies
+   alpha*(log(alpha)-1) = 3,
+     u(k) = (n^k/k!)^2,  B = sum(u(k), k=0..N),  A = sum(u(k)*H(k), k=0..N),
+     C = 1/(4n) * sum((2k)!^3/(k!^4*(16n)^(2k)), k=0..2n),
+   where H(k) = 1 + 1/2 + ... + 1/k, and |E(n)| < 24*exp(-8n) (Brent and
+   Johansson, "A bound for the error term in the Brent-McMillan algorithm",
+   Math. Comp. 84, 2015). We take N = 5n.
+
+   All the sums are computed exactly by binary splitting. */
+
+/* Binary splitting for A and B: for a <= k < b, with p(k) = n^2 and
+   q(k) = k^2, P = prod(p(k)), Q = prod(q(k)), D = prod(k), and
+     T/Q = sum(prod(p(j)/q(j), j=a..k), k=a..b-1),
+     C/D = sum(1/k, k=a..b-1),
+     V/(Q*D) = sum(prod(p(j)/q(j), j=a..k) * (H(k) - H(a-1)), k=a..b-1).
+   Thus B = 1 + T/Q and A = V/(Q*D) for a = 1 and b = N+1. */
+static void
+euler_ab (mpz_ptr P, mpz_ptr Q, mpz_ptr T, mpz_ptr C, mpz_ptr D, mpz_ptr V,
+          unsigned long n, unsigned long a, unsigned long b, int need_P)
 {
-  mpfr_prec_t prec = MPFR_PREC(x), m, log2m;
-  mpfr_t y, z, l2;
-  unsigned long n;
-  int inexact;
-  MPFR_ZIV_DECL (loop);
-
-  MPFR_LOG_FUNC (
-    ("rnd=%d", rnd),
-    ("x[%Pu]=%.*Rg inex=%d", mpfr_get_prec(x), mpfr_log_prec, x, inexact));
-
-  log2m = MPFR_INT_CEIL_LOG2 (prec);
-  m = MPFR_ADD_PREC (prec, 2 * log2m + 23);
-
-  mpfr_init2 (y, m);
-  mpfr_init2 (z, m);
-
-  mpfr_init2 (l2, sizeof (mpfr_prec_t) * CHAR_BIT);
-  mpfr_const_log2 (l2, MPFR_RNDU);
-  mpfr_div_2ui (l2, l2, 1, MPFR_RNDU);  /* log(2)/2, rounded upward */
-
-  MPFR_ZIV_INIT (loop, m);
-  for (;;)
+  if (a + 1 == b)
     {
-      mpfr_exp_t exp_S, err;
-      MPFR_BLOCK_DECL (flags);
-
-      /* since prec >= 1, we have m >= 24 here, which ensures n >= 9 below */
-      /* Compute n >= prec * log(2)/2 (see algorithms.tex). */
-      mpfr_set_exp_t (z, m, MPFR_RNDU);
-      mpfr_mul (z, z, l2, MPFR_RNDU);
-      mpfr_ceil (z, z);
-      MPFR_LOG_VAR (z);
-      MPFR_BLOCK (flags, n = mpfr_get_ui (z, MPFR_RNDN));
-      MPFR_ASSERTD (n >= 9 && ! MPFR_ERANGEFLAG (flags));
-      mpfr_const_euler_S2 (y, z); /* error <= 3 ulps */
-      exp_S = MPFR_EXP(y);
-      mpfr_log (z, z, MPFR_RNDD); /* error <= 1 ulp */
-      mpfr_sub (y, y, z, MPFR_RNDN); /* S'(n) - log(n) */
-      /* the error is less than 1/2 + 3*2^(exp_S-EXP(y)) + 2^(EXP(z)-EXP(y))
-         <= 1/2 + 2^(exp_S+2-EXP(y)) + 2^(EXP(z)-EXP(y))
-         <= 1/2 + 2^(1+MAX(exp_S+2,EXP(z))-EXP(y)) */
-      err = 1 + MAX(exp_S + 2, MPFR_EXP(z)) - MPFR_EXP(y);
-      err = (err >= -1) ? err + 1 : 0; /* error <= 2^err ulp(y) */
-      exp_S = MPFR_EXP(y);
-      mpfr_const_euler_R (z, n); /* err <= ulp(1/2) = 2^(-m) */
-      mpfr_sub (y, y, z, MPFR_RNDN);
-      /* err <= 1/2 ulp(y) + 2^(-m) + 2^(err + exp_S - EXP(y)) ulp(y).
-         Since the result is between 0.5 and 1, ulp(y) = 2^(-m).
-         So we get 3/2*ulp(y) + 2^(err + exp_S - EXP(y)) ulp(y).
-         3/2 + 2^e <= 2^(e+1) for e>=1, and <= 2^2 otherwise */
-      err = err + exp_S - MPFR_EXP(y);
-      err = (err >= 1) ? err + 1 : 2;
-      if (MPFR_LIKELY (MPFR_CAN_ROUND (y, m - err, prec, rnd)))
-        break;
-      MPFR_ZIV_NEXT (loop, m);
-      mpfr_set_prec (y, m);
-      mpfr_set_prec (z, m);
+      mpz_set_ui (P, n);
+      mpz_mul_ui (P, P, n);
+      mpz_set_ui (D, a);
+      mpz_mul_ui (Q, D, a);
+      mpz_set (T, P);
+      mpz_set_ui (C, 1);
+      mpz_set (V, P);
     }
-  MPFR_ZIV_FREE (loop);
-
-  inexact = mpfr_set (x, y, rnd);
-
-  mpfr_clear (y);
-  mpfr_clear (z);
-  mpfr_clear (l2);
+  else
+    {
+      unsigned long c = a + (b - a) / 2;
+      mpz_t P2, Q2, T2, C2, D2, V2, t;
 
-  return inexact; /* always inexact */
+      mpz_init (P2);
+      mpz_init (Q2);
+      mpz_init (T2);
+      mpz_init (C2);
+      mpz_init (D2);
+      mpz_init (V2);
+      mpz_init (t);
+      euler_ab (P, Q, T, C, D, V, n, a, c, 1);
+      euler_ab (P2, Q2, T2, C2, D2, V2, n, c, b, need_P);
+      /* V = V1*Q2*D2 + P1*(V2*D1 + C1*T2*D2) */
+      mpz_mul (t, T2, D2);
+      mpz_mul (t, t, C);
+      mpz_mul (V2, V2, D);
+      mpz_add (V2, V2, t);
+      mpz_mul (V2, V2, P);
+      mpz_mul (V, V, Q2);
+      mpz_mul (V, V, D2);
+      mpz_add (V, V, V2);
+      /* C = C1*D2 + C2*D1, D = D1*D2 */
+      mpz_mul (C, C, D2);
+      mpz_mul (C2, C2, D);
+      mpz_add (C, C, C2);
+      mpz_mul (D, D, D2);
+      /* T = T1*Q2 + P1*T2, Q = Q1*Q2 */
+      mpz_mul (T, T, Q2);
+      mpz_mul (T2, T2, P);
+      mpz_add (T, T, T2);
+      mpz_mul (Q, Q, Q2);
+      if (need_P)
+        mpz_mul (P, P, P2);
+      mpz_clear (P2);
+      mpz_clear (Q2);
+      mpz_clear (T2);
+      mpz_clear (C2);
+      mpz_clear (D2);
+      mpz_clear (V2);
+      mpz_clear (t);
+    }
 }
 
+/* Binary splitting for C: for a <= k < b, with p(k) = (2k-1)^3 and
+   q(k) = 32*k*n^2, P = prod(p(k)), Q = prod(q(k)) and
+   T/Q = sum(prod(p(j)/q(j), j=a..k), k=a..b-1).
+   Thus 4n*C = 1 + T/Q for a = 1 and b = 2n+1. */
 static void
-mpfr_const_euler_S2_aux (mpz_t P, mpz_t Q, mpz_t T, mpfr_t n,
-                         unsigned long a, unsigned long b, int need_P)
+euler_c (mpz_ptr P, mpz_ptr Q, mpz_ptr T, unsigned long n,
+         unsigned long a, unsigned long b, int need_P)
 {
   if (a + 1 == b)
     {
-      int inex;
-      MPFR_BLOCK_DECL (flags);
-
-      MPFR_BLOCK (flags, MPFR_DBGRES (inex = mpfr_get_z (P, n, MPFR_RNDN)));
-      MPFR_ASSERTD (inex == 0 && ! MPFR_ERANGEFLAG (flags));
-      if (a > 1)
-        mpz_mul_si (P, P, 1 - (long) a);
+      mpz_set_ui (P, 2 * a - 1);
+      mpz_pow_ui (P, P, 3);
+      mpz_set_ui (Q, 32 * a);
+      mpz_mul_ui (Q, Q, n);
+      mpz_mul_ui (Q, Q, n);
       mpz_set (T, P);
-      mpz_set_ui (Q, a);
-      mpz_mul_ui (Q, Q, a);
     }
   else
     {
-      unsigned long c = (a + b) / 2;
+      unsigned long c = a + (b - a) / 2;
       mpz_t P2, Q2, T2;
-      mpfr_const_euler_S2_aux (P, Q, T, n, a, c, 1);
+
       mpz_init (P2);
       mpz_init (Q2);
       mpz_init (T2);
-      mpfr_const_euler_S2_aux (P2, Q2, T2, n, c, b, 1);
+      euler_c (P, Q, T, n, a, c, 1);
+      euler_c (P2, Q2, T2, n, c, b, need_P);
       mpz_mul (T, T, Q2);
       mpz_mul (T2, T2, P);
       mpz_add (T, T, T2);
+      mpz_mul (Q, Q, Q2);
       if (need_P)
         mpz_mul (P, P, P2);
-      mpz_mul (Q, Q, Q2);
       mpz_clear (P2);
       mpz_clear (Q2);
       mpz_clear (T2);
-      /* divide by 2 if possible */
-      {
-        unsigned long v2;
-        v2 = mpz_scan1 (P, 0);
-        c = mpz_scan1 (Q, 0);
-        if (c < v2)
-          v2 = c;
-        c = mpz_scan1 (T, 0);
-        if (c < v2)
-          v2 = c;
-        if (v2)
-          {
-            mpz_tdiv_q_2exp (P, P, v2);
-            mpz_tdiv_q_2exp (Q, Q, v2);
-            mpz_tdiv_q_2exp (T, T, v2);
-          }
-      }
     }
 }
 
-/* computes S(n) = sum(n^k*(-1)^(k-1)/k!/k, k=1..ceil(4.319136566 * n))
-   using binary splitting.
-   We have S(n) = sum(f(k), k=1..N) with N=ceil(4.319136566 * n)
-   and f(k) = n^k*(-1)*(k-1)/k!/k,
-   thus f(k)/f(k-1) = -n*(k-1)/k^2
-*/
-static void
-mpfr_const_euler_S2 (mpfr_t x, mpfr_t n)
+int
+mpfr_const_euler_internal (mpfr_t x, mpfr_rnd_t rnd)
 {
-  mpz_t P, Q, T;
-  unsigned long N;
-  mpfr_t NN;
-  MPFR_BLOCK_DECL (flags);
-
-  mpfr_init2 (NN, 64);
-  mpfr_set_str_binary (NN, /* a+2 = a*log(a), rounded to +infinity */
-    "100.01010001101100101110111100011011001011011111001111001111");
-  mpfr_mul (NN, NN, n, MPFR_RNDU);
-  MPFR_LOG_VAR (NN);
-  /* N = ceil(a.n) upper bound */
-  MPFR_BLOCK (flags, N = mpfr_get_ui (NN, MPFR_RNDU));
-  MPFR_ASSERTD (! MPFR_ERANGEFLAG (flags));
+  mpfr_prec_t prec = MPFR_PREC(x), m;
+  mpz_t P, Q, T, C, D, V;
+  mpfr_t a, b, c, l;
+  mpfr_exp_t err;
+  unsigned long n;
+  int inexact;
+  MPFR_ZIV_DECL (loop);
+
+  MPFR_LOG_FUNC (
+    ("rnd=%d", rnd),
+    ("x[%Pu]=%.*Rg inex=%d", mpfr_get_prec(x), mpfr_log_prec, x, inexact));
+
+  m = MPFR_ADD_PREC (prec, MPFR_INT_CEIL_LOG2 (prec) + 10);
+
+  mpfr_init2 (a, m);
+  mpfr_init2 (b, m);
+  mpfr_init2 (c, m);
+  mpfr_init2 (l, m);
   mpz_init (P);
   mpz_init (Q);
   mpz_init (T);
-  mpfr_const_euler_S2_aux (P, Q, T, n, 1, N + 1, 0);
-  mpfr_set_z (x, T, MPFR_RNDN);
-  mpfr_div_z (x, x, Q, MPFR_RNDN);
-  mpz_clear (P);
-  mpz_clear (Q);
-  mpz_clear (T);
-  mpfr_clear (NN);
-}
-
-/* computes R(n) = exp(-n)/n * sum(k!/(-n)^k, k=0..n-2)
-   with error at most 4*ulp(x). Assumes n>=2.
-   Since x <= exp(-n)/n <= 1/8, then 4*ulp(x) <= ulp(1).
-*/
-static void
-mpfr_const_euler_R (mpfr_t x, unsigned long n)
-{
-  unsigned long k, m;
-  mpz_t a, s;
-  mpfr_t y;
+  mpz_init (C);
+  mpz_init (D);
+  mpz_init (V);
 
-  MPFR_ASSERTN (n >= 2); /* ensures sum(k!/(-n)^k, k=0..n-2) >= 2/3 */
+  MPFR_ZIV_INIT (loop, m);
+  for (;;)
+    {
+      /* 24*exp(-8n) <= 2^(-m) for 8n*log2(e) >= m + 5, and since
+         1/(8*log2(e)) < 0.0867, n = 0.0867*(m+5) + 1 is enough */
+      n = (unsigned long) (0.0867 * (double) (m + 5)) + 1;
+
+      /* a = A/B = V/(D*(Q+T)) */
+      euler_ab (P, Q, T, C, D, V, n, 1, 5 * n + 1, 0);
+      mpz_add (T, Q, T);                  /* B*Q */
+      mpfr_set_z (a, V, MPFR_RNDN);       /* (1+u) */
+      mpfr_set_z (b, D, MPFR_RNDN);       /* (1+u) */
+      mpfr_set_z (c, T, MPFR_RNDN);       /* (1+u) */
+      mpfr_mul (b, b, c, MPFR_RNDN);      /* (1+u)^3 */
+      mpfr_div (a, a, b, MPFR_RNDN);      /* (1+u)^5 */
+      /* b = B = (Q+T)/Q */
+      mpfr_set_z (b, Q, MPFR_RNDN);
+      mpfr_div (b, c, b, MPFR_RNDN);      /* (1+u)^3 */
+      /* c = C = (1 + T/Q)/(4n) = (Q+T)/(4n*Q) */
+      euler_c (P, Q, T, n, 1, 2 * n + 1, 0);
+      mpz_add (T, Q, T);
+      mpz_mul_ui (Q, Q, 4 * n);
+      mpfr_set_z (c, T, MPFR_RNDN);       /* (1+u) */
+      mpfr_set_z (l, Q, MPFR_RNDN);       /* (1+u) */
+      mpfr_div (c, c, l, MPFR_RNDN);      /* (1+u)^3 */
+      /* c = C/B^2 */
+      mpfr_sqr (b, b, MPFR_RNDN);         /* (1+u)^7 */
+      mpfr_div (c, c, b, MPFR_RNDN);      /* (1+u)^11 */
+      mpfr_sub (a, a, c, MPFR_RNDN);
+      mpfr_set_ui (l, n, MPFR_RNDN);
+      mpfr_log (l, l, MPFR_RNDN);
+      err = MAX (MPFR_GET_EXP (a), MPFR_GET_EXP (l));
+      mpfr_sub (a, a, l, MPFR_RNDN);
+      /* Let e = MAX(EXP(a), EXP(log(n))) where a is the computed value of
+         A/B - C/B^2. Since m >= 10, the error on A/B is at most
+         6*2^(-m)*A/B and that on C/B^2 at most 12*2^(-m)*C/B^2. We have
+         n >= 2 thus 0 <= C/B^2 <= A/B/2, so that A/B <= 2a (up to a
+         negligible factor), and the error on a is at most 36*2^(-m)*a
+         + 2^(e-m-1) <= 2^(e+6-m). Adding the rounding errors of log(n) and
+         of the last subtraction (2^(e-m-1) each) and the error of the
+         formula (2^(-m)), the total error is at most 2^(e+7-m). */
+      err = MPFR_GET_EXP (a) + m - err - 7;
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (a, err, prec, rnd)))
+        break;
+      MPFR_ZIV_NEXT (loop, m);
+      mpfr_set_prec (a, m);
+      mpfr_set_prec (b, m);
+      mpfr_set_prec (c, m);
+      mpfr_set_prec (l, m);
+    }
+  MPFR_ZIV_FREE (loop);
 
-  /* as we multiply the sum by exp(-n), we need only PREC(x) - n/LOG2 bits */
-  m = MPFR_PREC(x) - (unsigned long) ((double) n / LOG2);
+  inexact = mpfr_set (x, a, rnd);
 
-  mpz_init_set_ui (a, 1);
-  mpz_mul_2exp (a, a, m);
-  mpz_init_set (s, a);
+  mpfr_clear (a);
+  mpfr_clear (b);
+  mpfr_clear (c);
+  mpfr_clear (l);
+  mpz_clear (P);
+  mpz_clear (Q);
+  mpz_clear (T);
+  mpz_clear (C);
+  mpz_clear (D);
+  mpz_clear (V);
 
-  for (k = 1; k <= n; k++)
-    {
-      mpz_mul_ui (a, a, k);
-      mpz_fdiv_q_ui (a, a, n);
-      /* the error e(k) on a is e(k) <= 1 + k/n*e(k-1) with e(0)=0,
-         i.e. e(k) <= k */
-      if (k % 2)
-        mpz_sub (s, s, a);
-      else
-        mpz_add (s, s, a);
-    }
-  /* the error on s is at most 1+2+...+n = n*(n+1)/2 */
-  mpz_fdiv_q_ui (s, s, n); /* err <= 1 + (n+1)/2 */
-  MPFR_ASSERTN (MPFR_PREC(x) >= mpz_sizeinbase(s, 2));
-  mpfr_set_z (x, s, MPFR_RNDD); /* exact */
-  mpfr_div_2ui (x, x, m, MPFR_RNDD);
-  /* now x = 1/n * sum(k!/(-n)^k, k=0..n-2) <= 1/n */
-  /* err(x) <= (n+1)/2^m <= (n+1)*exp(n)/2^PREC(x) */
-
-  mpfr_init2 (y, m);
-  mpfr_set_si (y, -(long)n, MPFR_RNDD); /* assumed exact */
-  mpfr_exp (y, y, MPFR_RNDD); /* err <= ulp(y) <= exp(-n)*2^(1-m) */
-  mpfr_mul (x, x, y, MPFR_RNDD);
-  /* err <= ulp(x) + (n + 1 + 2/n) / 2^prec(x)
-     <= ulp(x) + (n + 1 + 2/n) ulp(x)/x since x*2^(-prec(x)) < ulp(x)
-     <= ulp(x) + (n + 1 + 2/n) 3/(2n) ulp(x) since x >= 2/3*n for n >= 2
-     <= 4 * ulp(x) for n >= 2 */
-  mpfr_clear (y);
-
-  mpz_clear (a);
-  mpz_clear (s);
+  return inexact; /* always inexact */
 }
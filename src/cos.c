@@ -33,19 +33,23 @@ mpfr_cos_fast (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   return (inex == 2) ? -1 : inex;
 }
 
-/* f <- 1 - r/2! + r^2/4! + ... + (-1)^l r^l/(2l)! + ...
+/* f <- 1 - r/2! + r^2/4! + ... + (-1)^l r^l/(2l)! + ...       if i0 = 1,
+   f <- 1 - r/3! + r^2/5! + ... + (-1)^l r^l/(2l+1)! + ...     if i0 = 2,
+   i.e., f approximates cos(x) or sin(x)/x for r = x^2.
    Assumes |r| < 1/2, and f, r have the same precision.
    Returns e such that the error on f is bounded by 2^e ulps.
 */
-static int
-mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
+int
+mpfr_sincos2_aux (mpfr_ptr f, mpfr_srcptr r, unsigned long i0)
 {
   mpz_t x, t, s;
   mpfr_exp_t ex, l, m;
   mpfr_prec_t p, q;
   unsigned long i, maxi, imax;
+  int neg = 1;
 
   MPFR_ASSERTD(mpfr_get_exp (r) <= -1);
+  MPFR_ASSERTD(i0 == 1 || i0 == 2);
 
   /* compute minimal i such that i*(i+1) does not fit in an unsigned long,
      assuming that there are no padding bits. */
@@ -80,7 +84,7 @@ mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
   mpz_set_ui (s, 1); /* initialize sum with 1 */
   mpz_mul_2exp (s, s, p + q); /* scale all values by 2^(p+q) */
   mpz_set (t, s); /* invariant: t is previous term */
-  for (i = 1; (m = mpz_sizeinbase (t, 2)) >= q; i += 2)
+  for (i = i0; (m = mpz_sizeinbase (t, 2)) >= q; i += 2)
     {
       /* adjust precision of x to that of t */
       l = mpz_sizeinbase (x, 2);
@@ -110,10 +114,11 @@ mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
          4/3*(3l)*2^(-m)*t <= 4*l since |t| < 2^m.
          Therefore the error on s is bounded by 2*l*(l+1). */
       /* add or subtract to s */
-      if (i % 4 == 1)
+      if (neg)
         mpz_sub (s, s, t);
       else
         mpz_add (s, s, t);
+      neg = !neg;
     }
 
   mpfr_set_z (f, s, MPFR_RNDN);
@@ -123,17 +128,60 @@ mpfr_cos2_aux (mpfr_ptr f, mpfr_srcptr r)
   mpz_clear (s);
   mpz_clear (t);
 
-  l = (i - 1) / 2; /* number of iterations */
+  l = (i - i0) / 2; /* number of iterations */
   return 2 * MPFR_INT_CEIL_LOG2 (l + 1) + 1; /* bound is 2l(l+1) */
 }
 
+/* Put in s an approximation of cos(x), assuming 0 < |x| < 1, which holds
+   in particular when x has been reduced to [-Pi/4, Pi/4] by mpfr_reduce_pi2.
+   Then cos(x) > 1/2 and there is no cancellation.
+   Return e such that |s - cos(x)| <= 2^e ulp(s). */
+int
+mpfr_cos_reduced (mpfr_ptr s, mpfr_srcptr x)
+{
+  mpfr_prec_t m, K, k;
+  mpfr_t r;
+  int l;
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x) && MPFR_NOTZERO (x));
+  MPFR_ASSERTD (MPFR_GET_EXP (x) <= 0);
+
+  m = MPFR_PREC (s);
+  mpfr_init2 (r, m);
+  mpfr_sqr (r, x, MPFR_RNDU); /* err <= 1 ulp */
+
+  /* we need |r| < 1/2 for mpfr_sincos2_aux, i.e., EXP(r) - 2K <= -1,
+     which holds since EXP(r) <= 0 and K >= 1 */
+  K = __gmpfr_isqrt (m / 3) + 1;
+  MPFR_SET_EXP (r, MPFR_GET_EXP (r) - 2 * K); /* Can't overflow! */
+
+  /* s <- 1 - r/2! + ... + (-1)^l r^l/(2l)! */
+  l = mpfr_sincos2_aux (s, r, 1);
+  /* l is the error bound in ulps on s */
+  MPFR_SET_ONE (r);
+  for (k = 0; k < K; k++)
+    {
+      mpfr_sqr (s, s, MPFR_RNDU);            /* err <= 2*olderr */
+      MPFR_SET_EXP (s, MPFR_GET_EXP (s) + 1); /* Can't overflow */
+      mpfr_sub (s, s, r, MPFR_RNDN);         /* err <= 4*olderr */
+      /* s approximates cos(x/2^(K-1-k)) > cos(1) > 1/2 */
+      MPFR_ASSERTD (MPFR_GET_EXP (s) >= 0 && MPFR_GET_EXP (s) <= 1);
+    }
+  mpfr_clear (r);
+
+  /* The absolute error on s is bounded by (2l+1/3)*2^(2K-m), with
+     2l+1/3 <= 2l+1. Since s >= 1/2, ulp(s) >= 2^(-m). */
+  return MPFR_INT_CEIL_LOG2 (2 * l + 1) + 2 * K;
+}
+
 int
 mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
-  mpfr_prec_t K0, K, precy, m, k, l;
-  int inexact, reduce = 0;
-  mpfr_t r, s, xr, c;
-  mpfr_exp_t exps, cancel = 0, expx;
+  mpfr_prec_t K0, precy, m;
+  int inexact, reduce, q;
+  mpfr_t s, xr;
+  mpfr_srcptr xx;
+  mpfr_exp_t err, exps, cancel = 0, expx;
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_GROUP_DECL (group);
@@ -169,87 +217,52 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
   if (precy >= MPFR_SINCOS_THRESHOLD)
     {
+      /* the argument reduction needs the extended exponent range */
+      inexact = mpfr_cos_fast (y, x, rnd_mode);
       MPFR_SAVE_EXPO_FREE (expo);
-      return mpfr_cos_fast (y, x, rnd_mode);
+      return mpfr_check_range (y, inexact, rnd_mode);
     }
 
   K0 = __gmpfr_isqrt (precy / 3);
-  m = precy + 2 * MPFR_INT_CEIL_LOG2 (precy) + 2 * K0;
+  m = precy + 2 * MPFR_INT_CEIL_LOG2 (precy) + 2 * K0 + 4;
 
-  if (expx >= 3)
-    {
-      reduce = 1;
-      /* As expx + m - 1 will silently be converted into mpfr_prec_t
-         in the mpfr_init2 call, the assert below may be useful to
-         avoid undefined behavior. */
-      MPFR_ASSERTN (expx + m - 1 <= MPFR_PREC_MAX);
-      mpfr_init2 (c, expx + m - 1);
-      mpfr_init2 (xr, m);
-    }
+  /* if |x| >= 1, reduce x into [-Pi/4, Pi/4] */
+  reduce = expx > 0;
 
-  MPFR_GROUP_INIT_2 (group, m, r, s);
+  MPFR_GROUP_INIT_2 (group, m, s, xr);
   MPFR_ZIV_INIT (loop, m);
   for (;;)
     {
-      /* If |x| >= 4, first reduce x cmod (2*Pi) into xr, using mpfr_remainder:
-         let e = EXP(x) >= 3, and m the target precision:
-         (1) c <- 2*Pi              [precision e+m-1, nearest]
-         (2) xr <- remainder (x, c) [precision m, nearest]
-         We have |c - 2*Pi| <= 1/2ulp(c) = 2^(3-e-m)
-                 |xr - x - k c| <= 1/2ulp(xr) <= 2^(1-m)
-                 |k| <= |x|/(2*Pi) <= 2^(e-2)
-         Thus |xr - x - 2kPi| <= |k| |c - 2Pi| + 2^(1-m) <= 2^(2-m).
-         It follows |cos(xr) - cos(x)| <= 2^(2-m). */
+      /* Let xx = x - q*Pi/2 - 2k*Pi. Then |xr - xx| <= 2^(1-m), thus
+         |cos(xr + q*Pi/2) - cos(x)| <= 2^(1-m). */
       if (reduce)
         {
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN); /* 2Pi */
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
-          if (MPFR_IS_ZERO(xr))
+          q = mpfr_reduce_pi2 (xr, x);
+          if (MPFR_IS_ZERO (xr))
             goto ziv_next;
-          /* now |xr| <= 4, thus r <= 16 below */
-          mpfr_mul (r, xr, xr, MPFR_RNDU); /* err <= 1 ulp */
+          xx = xr;
         }
       else
-        mpfr_mul (r, x, x, MPFR_RNDU); /* err <= 1 ulp */
-
-      /* now |x| < 4 (or xr if reduce = 1), thus |r| <= 16 */
-
-      /* we need |r| < 1/2 for mpfr_cos2_aux, i.e., EXP(r) - 2K <= -1 */
-      K = K0 + 1 + MAX(0, MPFR_GET_EXP(r)) / 2;
-      /* since K0 >= 0, if EXP(r) < 0, then K >= 1, thus EXP(r) - 2K <= -3;
-         otherwise if EXP(r) >= 0, then K >= 1/2 + EXP(r)/2, thus
-         EXP(r) - 2K <= -1 */
-
-      MPFR_SET_EXP (r, MPFR_GET_EXP (r) - 2 * K); /* Can't overflow! */
-
-      /* s <- 1 - r/2! + ... + (-1)^l r^l/(2l)! */
-      l = mpfr_cos2_aux (s, r);
-      /* l is the error bound in ulps on s */
-      MPFR_SET_ONE (r);
-      for (k = 0; k < K; k++)
         {
-          mpfr_sqr (s, s, MPFR_RNDU);            /* err <= 2*olderr */
-          MPFR_SET_EXP (s, MPFR_GET_EXP (s) + 1); /* Can't overflow */
-          mpfr_sub (s, s, r, MPFR_RNDN);         /* err <= 4*olderr */
-          if (MPFR_IS_ZERO(s))
-            goto ziv_next;
-          MPFR_ASSERTD (MPFR_GET_EXP (s) <= 1);
+          q = 0;
+          xx = x;
         }
 
-      /* The absolute error on s is bounded by (2l+1/3)*2^(2K-m)
-         2l+1/3 <= 2l+1.
-         If |x| >= 4, we need to add 2^(2-m) for the argument reduction
-         by 2Pi: if K = 0, this amounts to add 4 to 2l+1/3, i.e., to add
-         2 to l; if K >= 1, this amounts to add 1 to 2*l+1/3. */
-      l = 2 * l + 1;
-      if (reduce)
-        l += (K == 0) ? 4 : 1;
-      k = MPFR_INT_CEIL_LOG2 (l) + 2*K;
-      /* now the error is bounded by 2^(k-m) = 2^(EXP(s)-err) */
+      /* cos(xx + q*Pi/2) is cos(xx), -sin(xx), -cos(xx), sin(xx)
+         for q = 0, 1, 2, 3 respectively */
+      if (q & 1)
+        err = mpfr_sin_reduced (s, xx);
+      else
+        err = mpfr_cos_reduced (s, xx);
+      if (q == 1 || q == 2)
+        MPFR_CHANGE_SIGN (s);
 
+      /* The error on s is at most 2^err ulp(s), plus 2^(1-m) in case of
+         argument reduction, which is 2^(1-exps) ulp(s). */
       exps = MPFR_GET_EXP (s);
-      if (MPFR_LIKELY (MPFR_CAN_ROUND (s, exps + m - k, precy, rnd_mode)))
+      if (reduce)
+        err = MAX (err, 1 - exps) + 1;
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (s, m - err, precy, rnd_mode)))
         break;
 
       if (MPFR_UNLIKELY (exps == 1))
@@ -258,17 +271,19 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
            than 2^(-precy) for directed rounding, or 2^(-precy-1) for rounding
            to nearest. */
         {
-          if (m > k && (m - k >= precy + (rnd_mode == MPFR_RNDN)))
+          if (m - err - 1 >= precy + (rnd_mode == MPFR_RNDN))
             {
               /* If round to nearest or away, result is s = 1 or -1,
                  otherwise it is round(nexttoward (s, 0)). However in order to
                  have the inexact flag correctly set below, we set |s| to
                  1 - 2^(-m) in all cases. */
+              mpfr_set_si (s, MPFR_INT_SIGN (s), MPFR_RNDN);
               mpfr_nexttozero (s);
               break;
             }
         }
 
+      /* x is near an odd multiple of Pi/2: cancellation in the reduction */
       if (exps < cancel)
         {
           m += cancel - exps;
@@ -277,21 +292,11 @@ mpfr_cos (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
     ziv_next:
       MPFR_ZIV_NEXT (loop, m);
-      MPFR_GROUP_REPREC_2 (group, m, r, s);
-      if (reduce)
-        {
-          mpfr_set_prec (xr, m);
-          mpfr_set_prec (c, expx + m - 1);
-        }
+      MPFR_GROUP_REPREC_2 (group, m, s, xr);
     }
   MPFR_ZIV_FREE (loop);
   inexact = mpfr_set (y, s, rnd_mode);
   MPFR_GROUP_CLEAR (group);
-  if (reduce)
-    {
-      mpfr_clear (xr);
-      mpfr_clear (c);
-    }
 
   MPFR_SAVE_EXPO_FREE (expo);
   return mpfr_check_range (y, inexact, rnd_mode);
@@ -28,6 +28,7 @@ mpfr_d_div (mpfr_ptr a, double b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 {
   int inexact;
   mpfr_t d;
+  mp_limb_t tmpmant[MPFR_LIMBS_PER_DOUBLE];
   MPFR_SAVE_EXPO_DECL (expo);
 
   MPFR_LOG_FUNC (
@@ -36,7 +37,7 @@ mpfr_d_div (mpfr_ptr a, double b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 
   MPFR_SAVE_EXPO_MARK (expo);
 
-  mpfr_init2 (d, IEEE_DBL_MANT_DIG);
+  MPFR_TMP_INIT1 (tmpmant, d, IEEE_DBL_MANT_DIG);
   inexact = mpfr_set_d (d, b, rnd_mode);
   MPFR_ASSERTN (inexact == 0);
 
@@ -44,7 +45,6 @@ mpfr_d_div (mpfr_ptr a, double b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   inexact = mpfr_div (a, d, c, rnd_mode);
   MPFR_SAVE_EXPO_UPDATE_FLAGS (expo, __gmpfr_flags);
 
-  mpfr_clear(d);
   MPFR_SAVE_EXPO_FREE (expo);
   return mpfr_check_range (a, inexact, rnd_mode);
 }
@@ -144,7 +144,7 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
   mp_size_t vsize = MPFR_LIMB_SIZE(v);
   mp_size_t qsize; /* number of limbs wanted for the computed quotient */
   mp_size_t qqsize;
-  mp_size_t k;
+  mp_size_t k, vz;
   mpfr_limb_ptr q0p = MPFR_MANT(q), qp;
   mpfr_limb_ptr up = MPFR_MANT(u);
   mpfr_limb_ptr vp = MPFR_MANT(v);
@@ -272,9 +272,15 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
   /* sh is the number of zero bits in the low limb of the quotient */
   MPFR_UNSIGNED_MINUS_MODULO(sh, MPFR_PREC(q));
 
-  like_rndz = rnd_mode == MPFR_RNDZ ||
+  /* the exact quotient is faithfully rounded by a truncation */
+  like_rndz = rnd_mode == MPFR_RNDZ || rnd_mode == MPFR_RNDF ||
     rnd_mode == (sign_quotient < 0 ? MPFR_RNDU : MPFR_RNDD);
 
+  /* vz is the number of zero low limbs of the divisor (e.g. for a small
+     integer or a dyadic number stored in a large precision); the integer
+     division below skips them, thus only the significant limbs count. */
+  for (vz = 0; vp[vz] == 0; vz++);
+
   /**************************************************************************
    *                                                                        *
    *       We first try Mulders' short division (for large operands)        *
@@ -282,7 +288,7 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
    **************************************************************************/
 
   if (MPFR_UNLIKELY(q0size >= MPFR_DIV_THRESHOLD &&
-                    vsize >= MPFR_DIV_THRESHOLD))
+                    vsize - vz >= MPFR_DIV_THRESHOLD))
     {
       mp_size_t n = q0size + 1; /* we will perform a short (2n)/n division */
       mpfr_limb_ptr ap, bp, qp;
@@ -316,9 +322,14 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
       p = n * GMP_NUMB_BITS - MPFR_INT_CEIL_LOG2 (2 * n + 2);
       /* if qh is 1, then we need only PREC(q)-1 bits of {qp,n},
          if rnd=RNDN, we need to be able to round with a directed rounding
-            and one more bit */
-      if (MPFR_LIKELY (mpfr_round_p (qp, n, p,
-                                 MPFR_PREC(q) + (rnd_mode == MPFR_RNDN) - qh)))
+            and one more bit,
+         if rnd=RNDF, rounding to nearest is faithful as soon as the error
+            is at most 1/4 ulp, which always holds since p > PREC(q) + 2 */
+      MPFR_ASSERTD (p >= MPFR_PREC(q) + 2);
+      if (MPFR_LIKELY (rnd_mode == MPFR_RNDF ||
+                       mpfr_round_p (qp, n, p,
+                                     MPFR_PREC(q) + (rnd_mode == MPFR_RNDN)
+                                     - qh)))
         {
           /* we can round correctly whatever the rounding mode */
           if (qh == 0)
@@ -330,7 +341,7 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
             }
           q0p[0] &= ~MPFR_LIMB_MASK(sh); /* put to zero low sh bits */
 
-          if (rnd_mode == MPFR_RNDN) /* round to nearest */
+          if (MPFR_IS_RNDN_OR_RNDF (rnd_mode)) /* round to nearest */
             {
               /* we know we can round, thus we are never in the even rule case:
                  if the round bit is 0, we truncate
@@ -422,6 +433,7 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
           MPN_COPY(bp, vp, vsize);
         }
       sticky_v = sticky_v || mpfr_mpn_cmpzero (vp, k);
+      vz = vz > k ? vz - k : 0; /* zero low limbs of {bp, qsize} */
       k = 0;
     }
   else /* vsize < qsize: small divisor case */
@@ -436,8 +448,12 @@ mpfr_div (mpfr_ptr q, mpfr_srcptr u, mpfr_srcptr v, mpfr_rnd_t rnd_mode)
    *                                                                        *
    **************************************************************************/
 
-  /* if Mulders' short division failed, we revert to division with remainder */
-  qh = mpn_divrem (qp, 0, ap + k, qqsize - k, bp, qsize - k);
+  /* if Mulders' short division failed, we revert to division with remainder.
+     The vz zero low limbs of {bp, qsize-k} are skipped: this does not change
+     the quotient, and the low limbs of the remainder are those of the
+     dividend, which are left unchanged in {ap+k, vz}. */
+  qh = mpn_divrem (qp, 0, ap + k + vz, qqsize - k - vz, bp + vz,
+                   qsize - k - vz);
   /* warning: qh may be 1 if u1 == v1, but u < v */
 #ifdef DEBUG2
   printf ("q="); mpfr_mpn_print (qp, qsize);
@@ -179,10 +179,10 @@ mpfr_eint_asympt (mpfr_ptr y, mpfr_srcptr x)
     }
   /* add the truncation error bounded by ulp(y): 1 ulp */
   mpfr_mul (y, y, invx, MPFR_RNDN); /* err <= 2*err + 3/2 */
-  mpfr_exp (t, x, MPFR_RNDN); /* err(t) <= 1/2*ulp(t) */
-  mpfr_mul (y, y, t, MPFR_RNDN); /* again: err <= 2*err + 3/2 */
+  mpfr_exp (t, x, MPFR_RNDF); /* faithful: err(t) <= ulp(t) */
+  mpfr_mul (y, y, t, MPFR_RNDN); /* err <= 2*err + 5/2 */
   mpfr_mul_2ui (err, err, 2, MPFR_RNDU);
-  mpfr_add_ui (err, err, 8, MPFR_RNDU);
+  mpfr_add_ui (err, err, 9, MPFR_RNDU);
   err_exp = MPFR_GET_EXP(err);
   mpfr_clear (t);
   mpfr_clear (invx);
@@ -0,0 +1,81 @@
+/* mpfr_erandom (rop, state, rnd_mode) -- Generate an exponential deviate with
+   mean 1 and round it to the precision of rop according to the given
+   rounding mode.
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* We use von Neumann's algorithm (J. von Neumann, Various techniques used
+   in connection with random digits, 1951), as described in Karney's paper
+   cited in nrandom.c: it only needs random bits and comparisons of
+   uniform deviates, and returns the correct rounding of an exact
+   exponential deviate. */
+
+/* Return true with probability exp(-x): with p1, p2, ... uniform deviates,
+   the length of the longest decreasing sequence x > p1 > p2 > ... is even
+   with probability exp(-x). */
+static int
+E (mpfr_random_deviate_ptr x, mpfr_random_deviate_ptr p,
+   mpfr_random_deviate_ptr q, gmp_randstate_t r)
+{
+  mpfr_random_deviate_reset (p);
+  if (!mpfr_random_deviate_less (p, x, r))
+    return 1;
+  for (;;)
+    {
+      mpfr_random_deviate_reset (q);
+      if (!mpfr_random_deviate_less (q, p, r))
+        return 0;
+      mpfr_random_deviate_reset (p);
+      if (!mpfr_random_deviate_less (p, q, r))
+        return 1;
+    }
+}
+
+int
+mpfr_erandom (mpfr_ptr z, gmp_randstate_t r, mpfr_rnd_t rnd)
+{
+  mpfr_random_deviate_t x, p, q;
+  unsigned long k = 0;
+  int inex;
+
+  mpfr_random_deviate_init (x);
+  mpfr_random_deviate_init (p);
+  mpfr_random_deviate_init (q);
+
+  /* A uniform deviate x is accepted with probability exp(-x), and each
+     rejection, which has probability exp(-1), adds 1 to the integer part
+     k, so that the density of k + x is proportional to exp(-(k+x)). */
+  for (;;)
+    {
+      mpfr_random_deviate_reset (x);
+      if (E (x, p, q, r))
+        break;
+      k++;
+    }
+  inex = mpfr_random_deviate_value (0, k, x, z, r, rnd);
+
+  mpfr_random_deviate_clear (x);
+  mpfr_random_deviate_clear (p);
+  mpfr_random_deviate_clear (q);
+  return inex;
+}
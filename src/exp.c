@@ -93,8 +93,8 @@ mpfr_exp (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
         /* x < log(2^(emin - 2)), thus exp(x) < 2^(emin - 2) */
         mpfr_clears (e, bound, (mpfr_ptr) 0);
         MPFR_SAVE_EXPO_FREE (expo);
-        return mpfr_underflow (y, rnd_mode == MPFR_RNDN ? MPFR_RNDZ : rnd_mode,
-                               1);
+        return mpfr_underflow (y, MPFR_IS_RNDN_OR_RNDF (rnd_mode) ?
+                               MPFR_RNDZ : rnd_mode, 1);
       }
 
     /* Other overflow/underflow cases must be detected
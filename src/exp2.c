@@ -123,8 +123,10 @@ mpfr_exp2 (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
           /* compute exp(x*ln(2))*/
           mpfr_const_log2 (t, MPFR_RNDU);       /* ln(2) */
           mpfr_mul (t, xfrac, t, MPFR_RNDU);    /* xfrac * ln(2) */
-          err = Nt - (MPFR_GET_EXP (t) + 2);   /* Estimate of the error */
-          mpfr_exp (t, t, MPFR_RNDN);           /* exp(xfrac * ln(2)) */
+          /* Estimate of the error, with one more bit for the faithful
+             exponential */
+          err = Nt - (MPFR_GET_EXP (t) + 3);
+          mpfr_exp (t, t, MPFR_RNDF);           /* exp(xfrac * ln(2)) */
 
           if (MPFR_LIKELY (MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
             break;
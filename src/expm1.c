@@ -132,7 +132,7 @@ mpfr_expm1 (mpfr_ptr y, mpfr_srcptr x , mpfr_rnd_t rnd_mode)
         MPFR_BLOCK_DECL (flags);
 
         /* exp(x) may overflow and underflow */
-        MPFR_BLOCK (flags, mpfr_exp (t, x, MPFR_RNDN));
+        MPFR_BLOCK (flags, mpfr_exp (t, x, MPFR_RNDF));
         if (MPFR_OVERFLOW (flags))
           {
             inexact = mpfr_overflow (y, rnd_mode, MPFR_SIGN_POS);
@@ -155,9 +155,10 @@ mpfr_expm1 (mpfr_ptr y, mpfr_srcptr x , mpfr_rnd_t rnd_mode)
         exp_te = MPFR_GET_EXP (t);         /* FIXME: exp(x) may overflow! */
         mpfr_sub_ui (t, t, 1, MPFR_RNDN);   /* exp(x)-1 */
 
-        /* error estimate */
+        /* error estimate, with 1 ulp(te) instead of 1/2 ulp(te) since
+           exp(x) is only faithful */
         /*err=Nt-(__gmpfr_ceil_log2(1+pow(2,MPFR_EXP(te)-MPFR_EXP(t))));*/
-        err = Nt - (MAX (exp_te - MPFR_GET_EXP (t), 0) + 1);
+        err = Nt - (MAX (exp_te - MPFR_GET_EXP (t), 0) + 2);
 
         if (MPFR_LIKELY (MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
           {
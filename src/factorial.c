@@ -23,18 +23,107 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
- /* The computation of n! is done by
+/* The computation of n! and of the other products of integers in
+   arithmetic progression a*(a+s)*...*(a+(k-1)*s) is done by binary
+   splitting: when the product fits in the working precision, it is
+   computed exactly by an integer product tree, otherwise the two halves
+   are computed recursively and their product is rounded. */
+
+/* Number of bits of x > 0 */
+static unsigned long
+ulong_bits (unsigned long x)
+{
+  unsigned long b = 0;
 
-    n!=prod^{n}_{i=1}i
- */
+  while (x != 0)
+    {
+      x >>= 1;
+      b ++;
+    }
+  return b;
+}
 
-/* FIXME: efficient problems with large arguments; see comments in gamma.c. */
+/* Number of bits of the largest factor a+(k-1)*s */
+#define LAST_BITS(a,k,s) ulong_bits ((a) + ((k) - 1) * (s))
 
-int
-mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
+/* Set z to a*(a+s)*...*(a+(k-1)*s) exactly, for k >= 1. */
+static void
+prod_z (mpz_ptr z, unsigned long a, unsigned long k, unsigned long s)
+{
+  if (k <= 16)
+    {
+      unsigned long x = a, i;
+
+      mpz_set_ui (z, 1);
+      for (i = 1; i < k; i++)
+        {
+          a += s;
+          if (x <= ULONG_MAX / a)
+            x *= a;
+          else
+            {
+              mpz_mul_ui (z, z, x);
+              x = a;
+            }
+        }
+      mpz_mul_ui (z, z, x);
+    }
+  else
+    {
+      mpz_t u;
+
+      mpz_init (u);
+      prod_z (z, a, k / 2, s);
+      prod_z (u, a + (k / 2) * s, k - k / 2, s);
+      mpz_mul (z, z, u);
+      mpz_clear (u);
+    }
+}
+
+/* Set t to a*(a+s)*...*(a+(k-1)*s), for k >= 1, where each rounding is
+   done in the direction rnd, which is MPFR_RNDZ or MPFR_RNDU. Set *inex
+   to a non-zero value if one of the roundings is inexact. Return the
+   number of roundings. */
+static unsigned long
+prod_fr (mpfr_ptr t, unsigned long a, unsigned long k, unsigned long s,
+         mpfr_rnd_t rnd, int *inex)
+{
+  unsigned long K, kmax;
+
+  /* the product has at most k * LAST_BITS bits, thus is exact if
+     k <= kmax */
+  kmax = (unsigned long) MPFR_PREC (t) / LAST_BITS (a, k, s);
+  if (k <= kmax || k == 1)
+    {
+      mpz_t z;
+
+      mpz_init (z);
+      prod_z (z, a, k, s);
+      *inex |= mpfr_set_z (t, z, rnd);
+      mpz_clear (z);
+      return k > kmax;
+    }
+  else
+    {
+      mpfr_t u;
+
+      mpfr_init2 (u, MPFR_PREC (t));
+      K = prod_fr (t, a, k / 2, s, rnd, inex);
+      K += prod_fr (u, a + (k / 2) * s, k - k / 2, s, rnd, inex);
+      *inex |= mpfr_mul (t, t, u, rnd);
+      mpfr_clear (u);
+      return K + 1;
+    }
+}
+
+/* Set y to a*(a+s)*...*(a+(k-1)*s) rounded in the direction rnd_mode,
+   for k >= 1, and return the ternary value. */
+static int
+prod_round (mpfr_ptr y, unsigned long a, unsigned long k, unsigned long s,
+            mpfr_rnd_t rnd_mode)
 {
   mpfr_t t;       /* Variable of Intermediary Calculation*/
-  unsigned long i;
+  unsigned long K;
   int round, inexact;
 
   mpfr_prec_t Ny;   /* Precision of output variable */
@@ -45,17 +134,30 @@ mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
 
-  /***** test x = 0  and x == 1******/
-  if (MPFR_UNLIKELY (x <= 1))
-    return mpfr_set_ui (y, 1, rnd_mode); /* 0! = 1 and 1! = 1 */
-
   MPFR_SAVE_EXPO_MARK (expo);
 
   /* Initialisation of the Precision */
   Ny = MPFR_PREC (y);
 
   /* compute the size of intermediary variable */
-  Nt = Ny + 2 * MPFR_INT_CEIL_LOG2 (x) + 7;
+  Nt = Ny + 2 * (MPFR_INT_CEIL_LOG2 (LAST_BITS (a, k, s))
+                 + MPFR_INT_CEIL_LOG2 (k)) + 7;
+
+  if (k <= (unsigned long) (2 * Nt) / LAST_BITS (a, k, s))
+    {
+      /* The exact product has at most 2Nt bits: compute it. */
+      mpz_t z;
+
+      mpz_init (z);
+      if (a == 1 && s == 1)
+        mpz_fac_ui (z, k);
+      else
+        prod_z (z, a, k, s);
+      inexact = mpfr_set_z (y, z, rnd_mode);
+      mpz_clear (z);
+      MPFR_SAVE_EXPO_FREE (expo);
+      return mpfr_check_range (y, inexact, rnd_mode);
+    }
 
   mpfr_init2 (t, Nt); /* initialise of intermediary variable */
 
@@ -63,18 +165,16 @@ mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
   MPFR_ZIV_INIT (loop, Nt);
   for (;;)
     {
-      /* compute factorial */
-      inexact = mpfr_set_ui (t, 1, rnd);
-      for (i = 2 ; i <= x ; i++)
-        {
-          round = mpfr_mul_ui (t, t, i, rnd);
-          /* assume the first inexact product gives the sign
-             of difference: is that always correct? */
-          if (inexact == 0)
-            inexact = round;
-        }
+      /* compute the product: all the roundings are done in the direction
+         rnd, thus t <= x (resp. t >= x), and the K roundings give a
+         relative error less than K*2^(1-Nt) <= 2^(1+ceil(log2(K))-Nt),
+         thus an absolute error less than 2^(EXP(t)+2+ceil(log2(K))-Nt) */
+      inexact = 0;
+      K = prod_fr (t, a, k, s, rnd, &inexact);
+      if (inexact != 0)
+        inexact = (rnd == MPFR_RNDZ) ? -1 : 1;
 
-      err = Nt - 1 - MPFR_INT_CEIL_LOG2 (Nt);
+      err = Nt - 2 - MPFR_INT_CEIL_LOG2 (K + 1);
 
       round = !inexact || mpfr_can_round (t, err, rnd, MPFR_RNDZ,
                                           Ny + (rnd_mode == MPFR_RNDN));
@@ -108,6 +208,40 @@ mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
   return mpfr_check_range (y, inexact, rnd_mode);
 }
 
+int
+mpfr_fac_ui (mpfr_ptr y, unsigned long int x, mpfr_rnd_t rnd_mode)
+{
+  /***** test x = 0  and x == 1******/
+  if (MPFR_UNLIKELY (x <= 1))
+    return mpfr_set_ui (y, 1, rnd_mode); /* 0! = 1 and 1! = 1 */
+
+  /* For x large compared to the precision, the generic code of mpfr_gamma
+     is faster. Then x! cannot be exact in the precision of y, thus
+     mpfr_gamma does not call mpfr_fac_ui back. */
+  if (x / MPFR_FAC_TREE_RATIO > (unsigned long) MPFR_PREC (y)
+      && __gmpfr_emax > (mpfr_exp_t) (sizeof (unsigned long) * CHAR_BIT))
+    {
+      mpfr_t z;
+      int inex;
+
+      mpfr_init2 (z, sizeof (unsigned long) * CHAR_BIT + 1);
+      mpfr_set_ui (z, x, MPFR_RNDN);
+      mpfr_add_ui (z, z, 1, MPFR_RNDN); /* exact */
+      inex = mpfr_gamma (y, z, rnd_mode);
+      mpfr_clear (z);
+      return inex;
+    }
 
+  return prod_round (y, 1, x, 1, rnd_mode);
+}
 
+/* Set y to 1*3*5*...*(2k-1) rounded in the direction rnd_mode, for
+   0 <= k <= ULONG_MAX/2. */
+int
+mpfr_odd_fac_ui (mpfr_ptr y, unsigned long k, mpfr_rnd_t rnd_mode)
+{
+  if (MPFR_UNLIKELY (k <= 1))
+    return mpfr_set_ui (y, 1, rnd_mode);
 
+  return prod_round (y, 1, k, 2, rnd_mode);
+}
@@ -55,5 +55,11 @@ mpfr_free_cache (void)
 #endif
   mpfr_clear_cache (__gmpfr_cache_const_euler);
   mpfr_clear_cache (__gmpfr_cache_const_catalan);
+  mpfr_clear_cache (__gmpfr_cache_const_two_over_pi);
+  mpfr_bernoulli_freecache ();
+  mpfr_zeta_freecache ();
+  mpfr_zeta_ui_freecache ();
   /* free_l2b (); */
+  /* last, since the above may have put blocks in the pool */
+  mpfr_pool_clear ();
 }
@@ -47,20 +47,6 @@ mpfr_gamma_2_minus_x_exact (mpfr_srcptr x)
     : MPFR_PREC(x) + 1;
 }
 
-/* return a sufficient precision such that 1-x is exact, assuming x < 1
-   and x is not an integer */
-static mpfr_prec_t
-mpfr_gamma_1_minus_x_exact (mpfr_srcptr x)
-{
-  if (MPFR_IS_POS(x))
-    return MPFR_PREC(x) - MPFR_GET_EXP(x);
-  else if (MPFR_GET_EXP(x) <= 0)
-    return MPFR_PREC(x) + 1 - MPFR_GET_EXP(x);
-  else /* necessarily MPFR_PREC(x) > MPFR_GET_EXP(x) since otherwise
-          x would be an integer */
-    return MPFR_PREC(x) + 1;
-}
-
 /* returns a lower bound of the number of significant bits of n!
    (not counting the low zero bits).
    We know n! >= (n/e)^n*sqrt(2*Pi*n) for n >= 1, and the number of zero bits
@@ -92,6 +78,59 @@ bits_fac (unsigned long n)
   return r;
 }
 
+/* Set gamma to gamma(k + 1/2) = (2k-1)!!*sqrt(Pi)/2^k if neg = 0, and
+   to gamma(1/2 - k) = (-2)^k*sqrt(Pi)/(2k-1)!! otherwise, where
+   (2k-1)!! = 1*3*...*(2k-1). The four roundings to nearest give a relative
+   error less than (1+u)^4/(1-u) - 1 < 2^(3-w) with u = 2^(-w), since the
+   error on Pi is halved by the square root. */
+static int
+mpfr_gamma_half (mpfr_ptr gamma, unsigned long k, int neg,
+                 mpfr_rnd_t rnd_mode)
+{
+  mpfr_t t, u;
+  mpfr_prec_t w;
+  int inex;
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_ZIV_DECL (loop);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+  w = MPFR_PREC (gamma) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (gamma)) + 10;
+  mpfr_init2 (t, w);
+  mpfr_init2 (u, w);
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      mpfr_odd_fac_ui (t, k, MPFR_RNDN);
+      mpfr_const_pi (u, MPFR_RNDN);
+      mpfr_sqrt (u, u, MPFR_RNDN);
+      if (neg)
+        mpfr_div (t, u, t, MPFR_RNDN);
+      else
+        mpfr_mul (t, t, u, MPFR_RNDN);
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, w - 3, MPFR_PREC (gamma),
+                                       rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (t, w);
+      mpfr_set_prec (u, w);
+    }
+  MPFR_ZIV_FREE (loop);
+  /* multiply by 2^(-k), resp. (-2)^k */
+  if (neg)
+    {
+      if (k & 1)
+        MPFR_CHANGE_SIGN (t);
+      mpfr_mul_2ui (t, t, k, MPFR_RNDN);
+    }
+  else
+    mpfr_div_2ui (t, t, k, MPFR_RNDN);
+  inex = mpfr_set (gamma, t, rnd_mode);
+  mpfr_clear (t);
+  mpfr_clear (u);
+  MPFR_SAVE_EXPO_FREE (expo);
+  return mpfr_check_range (gamma, inex, rnd_mode);
+}
+
 /* We use the reflection formula
   Gamma(1+t) Gamma(1-t) = - Pi t / sin(Pi (1 + t))
   in order to treat the case x <= 1,
@@ -226,9 +265,9 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
   /* if x is an integer that fits into an unsigned long, use mpfr_fac_ui
      if argument is not too large.
-     If precision is p, fac_ui costs O(u*p), whereas gamma costs O(p*M(p)),
-     so for u <= M(p), fac_ui should be faster.
-     We approximate here M(p) by p*log(p)^2, which is not a bad guess.
+     If precision is p, fac_ui uses a product tree, which costs about
+     O(u*log(u)/p) multiplications in precision p, whereas gamma costs
+     O(p*M(p)), thus fac_ui is faster for u <= MPFR_FAC_TREE_RATIO*p.
      Warning: since the generic code does not handle exact cases,
      we want all cases where gamma(x) is exact to be treated here.
   */
@@ -237,7 +276,9 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
       unsigned long int u;
       mpfr_prec_t p = MPFR_PREC(gamma);
       u = mpfr_get_ui (x, MPFR_RNDN);
-      if (u < 44787929UL && bits_fac (u - 1) <= p + (rnd_mode == MPFR_RNDN))
+      if ((u - 1) / MPFR_FAC_TREE_RATIO <= (unsigned long) p
+          || (u < 44787929UL
+              && bits_fac (u - 1) <= p + (rnd_mode == MPFR_RNDN)))
         /* bits_fac: lower bound on the number of bits of m,
            where gamma(x) = (u-1)! = m*2^e with m odd. */
         return mpfr_fac_ui (gamma, u - 1, rnd_mode);
@@ -247,6 +288,27 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
          to return a mpz_t or mpfr_t. */
     }
 
+  /* if x = k + 1/2 or x = 1/2 - k with k not too large, use
+     mpfr_odd_fac_ui */
+  if (!is_integer && MPFR_GET_EXP (x) <= (mpfr_exp_t) (sizeof (unsigned long)
+                                                       * CHAR_BIT - 1))
+    {
+      mpfr_t x2;
+
+      x2[0] = *x;
+      MPFR_EXP (x2) = MPFR_GET_EXP (x) + 1;
+      if (mpfr_integer_p (x2)) /* 2x is an integer */
+        {
+          unsigned long k;
+
+          /* |2x| = 2k+1 for x > 0, and 2k-1 for x < 0 */
+          MPFR_SET_POS (x2);
+          k = mpfr_get_ui (x2, MPFR_RNDZ) / 2 + MPFR_IS_NEG (x);
+          if (k / MPFR_FAC_TREE_RATIO <= (unsigned long) MPFR_PREC (gamma))
+            return mpfr_gamma_half (gamma, k, MPFR_IS_NEG (x), rnd_mode);
+        }
+    }
+
   MPFR_SAVE_EXPO_MARK (expo);
 
   /* check for overflow: according to (6.1.37) in Abramowitz & Stegun,
@@ -291,7 +353,7 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   */
   if (MPFR_IS_NEG(x))
     {
-      int underflow = 0, sgn, ck;
+      int underflow = 0, sgn;
       mpfr_prec_t w;
 
       mpfr_init2 (xp, 53);
@@ -306,23 +368,26 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 
       /* we need an upper bound on 1/|sin(Pi*(2-x))|,
          thus a lower bound on |sin(Pi*(2-x))|.
-         If 2-x is exact, then the error of Pi*(2-x) is (1+u)^2 with u = 2^(-p)
-         thus the error on sin(Pi*(2-x)) is less than 1/2ulp + 3Pi(2-x)u,
-         assuming u <= 1, thus <= u + 3Pi(2-x)u */
+         Since 2-x is rounded to nearest, the error of Pi*(2-x) is (1+u)^3
+         with u = 2^(-p), thus the error on sin(Pi*(2-x)) is less than
+         1/2ulp + 4Pi(2-x)u, assuming u <= 1/8, thus <= u + 4Pi(2-x)u.
+         The precision w makes 2-x exact when x has not much more bits than
+         gamma: otherwise this check may fail to detect an underflow, which
+         is then detected by the generic code below. */
 
       w = mpfr_gamma_2_minus_x_exact (x); /* 2-x is exact for prec >= w */
+      w = MIN (w, MPFR_PREC (gamma) + MAX (MPFR_GET_EXP (x), 0) + 64);
       w += 17; /* to get tmp2 small enough */
       mpfr_set_prec (tmp, w);
       mpfr_set_prec (tmp2, w);
-      MPFR_DBGRES (ck = mpfr_ui_sub (tmp, 2, x, MPFR_RNDN));
-      MPFR_ASSERTD (ck == 0); /* tmp = 2-x exactly */
+      mpfr_ui_sub (tmp, 2, x, MPFR_RNDN);
       mpfr_const_pi (tmp2, MPFR_RNDN);
       mpfr_mul (tmp2, tmp2, tmp, MPFR_RNDN); /* Pi*(2-x) */
       mpfr_sin (tmp, tmp2, MPFR_RNDN); /* sin(Pi*(2-x)) */
       sgn = mpfr_sgn (tmp);
       mpfr_abs (tmp, tmp, MPFR_RNDN);
-      mpfr_mul_ui (tmp2, tmp2, 3, MPFR_RNDU); /* 3Pi(2-x) */
-      mpfr_add_ui (tmp2, tmp2, 1, MPFR_RNDU); /* 3Pi(2-x)+1 */
+      mpfr_mul_ui (tmp2, tmp2, 4, MPFR_RNDU); /* 4Pi(2-x) */
+      mpfr_add_ui (tmp2, tmp2, 1, MPFR_RNDU); /* 4Pi(2-x)+1 */
       mpfr_div_2ui (tmp2, tmp2, mpfr_get_prec (tmp), MPFR_RNDU);
       /* if tmp2<|tmp|, we get a lower bound */
       if (mpfr_cmp (tmp2, tmp) < 0)
@@ -348,37 +413,38 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
         }
     }
 
+  /* The working precision only depends on the target precision: 2-x and
+     x-1 are rounded, which does not change much the error analysis below.
+     Let y = 2-x > 1 and xp = y*(1+t) its value rounded to nearest in
+     precision realprec + ex, with ex = EXP(y) + ceil(log2(EXP(y))) + 1,
+     thus |t| <= 2^(-realprec-ex). Then gamma(xp) = gamma(y)*exp(psi(z)*y*t)
+     for some z between y and xp, and since |psi(z)| <= EXP(y) for z near
+     y >= 1, |psi(z)*y*t| <= u/2 with u = 2^(-realprec), thus
+     gamma(xp) = gamma(y)*(1+u). */
   realprec = MPFR_PREC (gamma);
-  /* we want both 1-x and 2-x to be exact */
-  {
-    mpfr_prec_t w;
-    w = mpfr_gamma_1_minus_x_exact (x);
-    if (realprec < w)
-      realprec = w;
-    w = mpfr_gamma_2_minus_x_exact (x);
-    if (realprec < w)
-      realprec = w;
-  }
   realprec = realprec + MPFR_INT_CEIL_LOG2 (realprec) + 20;
   MPFR_ASSERTD(realprec >= 5);
 
-  MPFR_GROUP_INIT_4 (group, realprec + MPFR_INT_CEIL_LOG2 (realprec) + 20,
-                     xp, tmp, tmp2, GammaTrial);
+  MPFR_GROUP_INIT_3 (group, realprec + MPFR_INT_CEIL_LOG2 (realprec) + 20,
+                     tmp, tmp2, GammaTrial);
+  mpfr_init2 (xp, MPFR_PREC_MIN);
   mpz_init (fact);
   MPFR_ZIV_INIT (loop, realprec);
   for (;;)
     {
       mpfr_exp_t err_g;
-      int ck;
-      MPFR_GROUP_REPREC_4 (group, realprec, xp, tmp, tmp2, GammaTrial);
+      MPFR_GROUP_REPREC_3 (group, realprec, tmp, tmp2, GammaTrial);
 
       /* reflection formula: gamma(x) = Pi*(x-1)/sin(Pi*(2-x))/gamma(2-x) */
 
-      ck = mpfr_ui_sub (xp, 2, x, MPFR_RNDN); /* 2-x, exact */
-      MPFR_ASSERTD(ck == 0);  (void) ck; /* use ck to avoid a warning */
-      mpfr_gamma (tmp, xp, MPFR_RNDN);   /* gamma(2-x), error (1+u) */
+      mpfr_set_prec (xp, realprec + MPFR_INT_CEIL_LOG2 (realprec) + 20);
+      mpfr_ui_sub (xp, 2, x, MPFR_RNDN);
+      err_g = MPFR_GET_EXP (xp);
+      mpfr_set_prec (xp, realprec + err_g + MPFR_INT_CEIL_LOG2 (err_g) + 1);
+      mpfr_ui_sub (xp, 2, x, MPFR_RNDN);  /* 2-x, error (1+u/2^ex) */
+      mpfr_gamma (tmp, xp, MPFR_RNDN);   /* gamma(2-x), error (1+u)^2 */
       mpfr_const_pi (tmp2, MPFR_RNDN);   /* Pi, error (1+u) */
-      mpfr_mul (GammaTrial, tmp2, xp, MPFR_RNDN); /* Pi*(2-x), error (1+u)^2 */
+      mpfr_mul (GammaTrial, tmp2, xp, MPFR_RNDN); /* Pi*(2-x), error (1+u)^3 */
       err_g = MPFR_GET_EXP(GammaTrial);
       mpfr_sin (GammaTrial, GammaTrial, MPFR_RNDN); /* sin(Pi*(2-x)) */
       /* If tmp is +Inf, we compute exp(lngamma(x)). */
@@ -392,34 +458,28 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
         }
       err_g = err_g + 1 - MPFR_GET_EXP(GammaTrial);
       /* let g0 the true value of Pi*(2-x), g the computed value.
-         We have g = g0 + h with |h| <= |(1+u^2)-1|*g.
-         Thus sin(g) = sin(g0) + h' with |h'| <= |(1+u^2)-1|*g.
-         The relative error is thus bounded by |(1+u^2)-1|*g/sin(g)
-         <= |(1+u^2)-1|*2^err_g. <= 2.25*u*2^err_g for |u|<=1/4.
-         With the rounding error, this gives (0.5 + 2.25*2^err_g)*u. */
-      ck = mpfr_sub_ui (xp, x, 1, MPFR_RNDN); /* x-1, exact */
-      MPFR_ASSERTD(ck == 0);  (void) ck; /* use ck to avoid a warning */
-      mpfr_mul (xp, tmp2, xp, MPFR_RNDN); /* Pi*(x-1), error (1+u)^2 */
+         We have g = g0 + h with |h| <= |(1+u)^3-1|*g.
+         Thus sin(g) = sin(g0) + h' with |h'| <= |(1+u)^3-1|*g.
+         The relative error is thus bounded by |(1+u)^3-1|*g/sin(g)
+         <= |(1+u)^3-1|*2^err_g <= 3.5*u*2^err_g for |u|<=1/32.
+         With the rounding error, this gives (0.5 + 3.5*2^err_g)*u. */
+      mpfr_sub_ui (xp, x, 1, MPFR_RNDN); /* x-1, error (1+u) */
+      mpfr_mul (xp, tmp2, xp, MPFR_RNDN); /* Pi*(x-1), error (1+u)^3 */
       mpfr_mul (GammaTrial, GammaTrial, tmp, MPFR_RNDN);
-      /* [1 + (0.5 + 2.25*2^err_g)*u]*(1+u)^2 = 1 + (2.5 + 2.25*2^err_g)*u
-         + (0.5 + 2.25*2^err_g)*u*(2u+u^2) + u^2.
-         For err_g <= realprec-2, we have (0.5 + 2.25*2^err_g)*u <=
-         0.5*u + 2.25/4 <= 0.6875 and u^2 <= u/4, thus
-         (0.5 + 2.25*2^err_g)*u*(2u+u^2) + u^2 <= 0.6875*(2u+u/4) + u/4
-         <= 1.8*u, thus the rel. error is bounded by (4.5 + 2.25*2^err_g)*u. */
+      /* [1 + (0.5 + 3.5*2^err_g)*u]*(1+u)^3 is bounded by
+         1 + (7 + 4*2^err_g)*u for err_g <= realprec-3, in the same way as
+         below. */
       mpfr_div (GammaTrial, xp, GammaTrial, MPFR_RNDN);
-      /* the error is of the form (1+u)^3/[1 + (4.5 + 2.25*2^err_g)*u].
-         For realprec >= 5 and err_g <= realprec-2, [(4.5 + 2.25*2^err_g)*u]^2
+      /* the error is of the form (1+u)^4/[1 + (7 + 4*2^err_g)*u].
+         For realprec >= 5 and err_g <= realprec-3, [(7 + 4*2^err_g)*u]^2
          <= 0.71, and for |y|<=0.71, 1/(1-y) can be written 1+a*y with a<=4.
-         (1+u)^3 * (1+4*(4.5 + 2.25*2^err_g)*u)
-         = 1 + (21 + 9*2^err_g)*u + (57+27*2^err_g)*u^2 + (55+27*2^err_g)*u^3
-             + (18+9*2^err_g)*u^4
-         <= 1 + (21 + 9*2^err_g)*u + (57+27*2^err_g)*u^2 + (56+28*2^err_g)*u^3
-         <= 1 + (21 + 9*2^err_g)*u + (59+28*2^err_g)*u^2
-         <= 1 + (23 + 10*2^err_g)*u.
-         The final error is thus bounded by (23 + 10*2^err_g) ulps,
-         which is <= 2^6 for err_g<=2, and <= 2^(err_g+4) for err_g >= 2. */
-      err_g = (err_g <= 2) ? 6 : err_g + 4;
+         (1+u)^4 * (1+4*(7 + 4*2^err_g)*u)
+         <= 1 + (32 + 16*2^err_g)*u + (2 + 2^err_g)*u
+         <= 1 + (34 + 17*2^err_g)*u.
+         The final error is thus bounded by (34 + 17*2^err_g) ulps,
+         which is <= 2^7 for err_g<=2, and <= 2^(err_g+5) for err_g >= 2.
+         If err_g > realprec-3, then realprec - err_g < 0 below. */
+      err_g = (err_g <= 2) ? 7 : err_g + 5;
 
       if (MPFR_LIKELY (MPFR_CAN_ROUND (GammaTrial, realprec - err_g,
                                        MPFR_PREC(gamma), rnd_mode)))
@@ -435,6 +495,7 @@ mpfr_gamma (mpfr_ptr gamma, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   if (inex == 0)
     inex = mpfr_set (gamma, GammaTrial, rnd_mode);
   MPFR_GROUP_CLEAR (group);
+  mpfr_clear (xp);
   mpz_clear (fact);
 
   MPFR_SAVE_EXPO_FREE (expo);
@@ -55,6 +55,23 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 # define MPFR_SINCOS_THRESHOLD 30000 /* bits */
 #endif
 
+#ifndef MPFR_ATAN_THRESHOLD
+# define MPFR_ATAN_THRESHOLD 12000 /* bits */
+#endif
+
+/* With Pi and log(2) cached, the Newton iteration of mpfr_log is slower
+   than the AGM at all measured precisions (x86_64, repeated calls:
+   0.87s vs 0.58s at 1e6 bits, 2.4s vs 1.6s at 2e6, 5.8s vs 3.4s at 4e6,
+   15s vs 8.1s at 8e6, 37s vs 17s at 16e6), thus it is disabled by
+   default. */
+#ifndef MPFR_LOG_THRESHOLD
+# define MPFR_LOG_THRESHOLD MPFR_PREC_MAX /* bits */
+#endif
+
+#ifndef MPFR_REDUCE_THRESHOLD
+# define MPFR_REDUCE_THRESHOLD 1024 /* bits of exponent */
+#endif
+
 #ifndef MPFR_AI_THRESHOLD1
 # define MPFR_AI_THRESHOLD1 -13107 /* threshold for negative input of mpfr_ai */
 #endif
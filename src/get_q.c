@@ -0,0 +1,56 @@
+/* mpfr_get_q -- get a multiple-precision rational from
+                 a floating-point number
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* Set q to f exactly. The result is canonical: the numerator is odd
+   or the denominator is 1, and the denominator is a power of 2. */
+void
+mpfr_get_q (mpq_ptr q, mpfr_srcptr f)
+{
+  mpz_ptr num, den;
+  mpfr_exp_t exp;
+  unsigned long k;
+
+  num = mpq_numref (q);
+  den = mpq_denref (q);
+  mpz_set_ui (den, 1);
+
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (f)))
+    {
+      if (MPFR_UNLIKELY (MPFR_NOTZERO (f)))
+        MPFR_SET_ERANGEFLAG ();
+      mpz_set_ui (num, 0);
+      return;
+    }
+
+  exp = mpfr_get_z_2exp (num, f);
+  /* remove the trailing zeros of the significand */
+  k = mpz_scan1 (num, 0);
+  mpz_tdiv_q_2exp (num, num, k);
+  exp += k;
+  if (exp >= 0)
+    mpz_mul_2exp (num, num, exp);
+  else
+    mpz_mul_2exp (den, den, - (unsigned long) exp);
+}
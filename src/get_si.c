@@ -28,6 +28,7 @@ mpfr_get_si (mpfr_srcptr f, mpfr_rnd_t rnd)
   mpfr_prec_t prec;
   long s;
   mpfr_t x;
+  mp_limb_t xp[(sizeof (long) * CHAR_BIT - 1) / GMP_NUMB_BITS + 1];
 
   if (MPFR_UNLIKELY (!mpfr_fits_slong_p (f, rnd)))
     {
@@ -44,7 +45,7 @@ mpfr_get_si (mpfr_srcptr f, mpfr_rnd_t rnd)
     { }
 
   /* first round to prec bits */
-  mpfr_init2 (x, prec);
+  MPFR_TMP_INIT1 (xp, x, prec);
   mpfr_rint (x, f, rnd);
 
   /* warning: if x=0, taking its exponent is illegal */
@@ -63,7 +64,5 @@ mpfr_get_si (mpfr_srcptr f, mpfr_rnd_t rnd)
       s = MPFR_SIGN(f) > 0 ? a : a <= LONG_MAX ? - (long) a : LONG_MIN;
     }
 
-  mpfr_clear (x);
-
   return s;
 }
@@ -28,6 +28,7 @@ mpfr_get_ui (mpfr_srcptr f, mpfr_rnd_t rnd)
   mpfr_prec_t prec;
   unsigned long s;
   mpfr_t x;
+  mp_limb_t xp[(sizeof (unsigned long) * CHAR_BIT - 1) / GMP_NUMB_BITS + 1];
   mp_size_t n;
   mpfr_exp_t exp;
 
@@ -45,7 +46,7 @@ mpfr_get_ui (mpfr_srcptr f, mpfr_rnd_t rnd)
     { }
 
   /* first round to prec bits */
-  mpfr_init2 (x, prec);
+  MPFR_TMP_INIT1 (xp, x, prec);
   mpfr_rint (x, f, rnd);
 
   /* warning: if x=0, taking its exponent is illegal */
@@ -59,7 +60,5 @@ mpfr_get_ui (mpfr_srcptr f, mpfr_rnd_t rnd)
       s = MPFR_MANT(x)[n - 1] >> (GMP_NUMB_BITS - exp);
     }
 
-  mpfr_clear (x);
-
   return s;
 }
@@ -80,6 +80,182 @@ foo2 (mpfr_ptr x, mpz_srcptr y, mpfr_srcptr z, mpfr_rnd_t r,
   return mpfr_check_range (x, i, r);
 }
 
+/* Compare {up, un} and {vp, vn}, whose most significant limbs are nonzero,
+   as if their most significant bits were aligned: return the sign of
+   u*2^k - v, where k is such that u*2^k and v have the same bit size. */
+static int
+cmp_aligned (const mp_limb_t *up, mp_size_t un,
+             const mp_limb_t *vp, mp_size_t vn)
+{
+  mp_limb_t ul, vl;
+  mp_size_t k;
+  int cu, cv;
+
+  count_leading_zeros (cu, up[un - 1]);
+  count_leading_zeros (cv, vp[vn - 1]);
+  for (k = 1; k <= un || k <= vn; k++)
+    {
+      /* k-th limb from the top of the normalized values */
+      ul = k <= un ? up[un - k] << cu : 0;
+      if (cu != 0 && k < un)
+        ul |= up[un - k - 1] >> (GMP_NUMB_BITS - cu);
+      vl = k <= vn ? vp[vn - k] << cv : 0;
+      if (cv != 0 && k < vn)
+        vl |= vp[vn - k - 1] >> (GMP_NUMB_BITS - cv);
+      if (ul != vl)
+        return ul > vl ? 1 : -1;
+    }
+  return 0;
+}
+
+/* Set {rp, n + sh / GMP_NUMB_BITS + 1} to {sp, n} * 2^sh and return the
+   size of the result without its high zero limbs. */
+static mp_size_t
+lshift_limbs (mp_limb_t *rp, const mp_limb_t *sp, mp_size_t n,
+              mpfr_uexp_t sh)
+{
+  mp_size_t k = sh / GMP_NUMB_BITS;
+  int c = sh % GMP_NUMB_BITS;
+
+  MPN_ZERO (rp, k);
+  if (c != 0)
+    rp[n + k] = mpn_lshift (rp + k, sp, n, c);
+  else
+    {
+      MPN_COPY (rp + k, sp, n);
+      rp[n + k] = 0;
+    }
+  n += k + 1;
+  while (rp[n - 1] == 0)
+    n--;
+  return n;
+}
+
+/* Return non-zero if x + a/b can be computed exactly by add_zq at a cost
+   similar to the one of the Ziv loop, i.e., if the exponent of the least
+   significant bit of x is not too large in absolute value. */
+static int
+add_zq_p (mpfr_srcptr y, mpfr_srcptr x, mpz_srcptr a, mpz_srcptr b)
+{
+  mpfr_exp_t e;
+  mpfr_uexp_t n;
+
+  e = MPFR_GET_EXP (x) - (mpfr_exp_t) MPFR_LIMB_SIZE (x) * GMP_NUMB_BITS;
+  n = (mpfr_uexp_t) (MPFR_LIMB_SIZE (x) + ABS (SIZ (a))
+                     + (b == NULL ? 0 : ABS (SIZ (b)))) * GMP_NUMB_BITS
+    + MPFR_PREC (y);
+  return SAFE_ABS (mpfr_uexp_t, e) <= n;
+}
+
+/* Set y to RND(sx*x + sa*a/b), where x is a regular number, a and b are
+   nonzero integers (b = NULL meaning b = 1), and sx and sa are 1 or -1.
+   With x = m*2^e, where m is the significand of x seen as an integer, the
+   numerator sx*x*b*2^(-min(e,0)) + sa*a*2^(-min(e,0)) is computed exactly
+   on the limbs, then rounded with a single division. */
+static int
+add_zq (mpfr_ptr y, mpfr_srcptr x, int sx, mpz_srcptr a, mpz_srcptr b,
+        int sa, mpfr_rnd_t rnd_mode)
+{
+  mpz_t n;
+  mp_limb_t *up, *vp, *tp, *np;
+  mp_size_t xn, an, bn, un, vn, nn;
+  mpfr_exp_t e;
+  int su, sv, c, inex;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x));
+  MPFR_ASSERTD (mpz_sgn (a) != 0);
+
+  xn = MPFR_LIMB_SIZE (x);
+  an = ABS (SIZ (a));
+  bn = b == NULL ? 0 : ABS (SIZ (b));
+  e = MPFR_GET_EXP (x) - (mpfr_exp_t) xn * GMP_NUMB_BITS;
+  su = sx * MPFR_SIGN (x);
+  sv = sa * mpz_sgn (a) * (b == NULL ? 1 : mpz_sgn (b));
+
+  MPFR_TMP_MARK (marker);
+
+  /* u = m * |b| * 2^max(e,0) */
+  if (b == NULL)
+    tp = MPFR_MANT (x);
+  else
+    {
+      tp = MPFR_TMP_LIMBS_ALLOC (xn + bn);
+      if (xn >= bn)
+        mpn_mul (tp, MPFR_MANT (x), xn, PTR (b), bn);
+      else
+        mpn_mul (tp, PTR (b), bn, MPFR_MANT (x), xn);
+    }
+  un = xn + bn + (e > 0 ? e / GMP_NUMB_BITS : 0) + 1;
+  up = MPFR_TMP_LIMBS_ALLOC (un);
+  un = lshift_limbs (up, tp, xn + bn, e > 0 ? e : 0);
+
+  /* v = |a| * 2^max(-e,0) */
+  if (e < 0)
+    {
+      vn = an + (-e) / GMP_NUMB_BITS + 1;
+      vp = MPFR_TMP_LIMBS_ALLOC (vn);
+      vn = lshift_limbs (vp, PTR (a), an, -e);
+    }
+  else
+    {
+      vp = PTR (a);
+      vn = an;
+    }
+
+  /* n = su * u + sv * v */
+  nn = MAX (un, vn) + 1;
+  np = MPFR_TMP_LIMBS_ALLOC (nn);
+  if (su == sv)
+    {
+      if (un >= vn)
+        np[nn - 1] = mpn_add (np, up, un, vp, vn);
+      else
+        np[nn - 1] = mpn_add (np, vp, vn, up, un);
+    }
+  else
+    {
+      c = un != vn ? (un > vn ? 1 : -1) : mpn_cmp (up, vp, un);
+      if (c == 0)
+        {
+          /* exact zero: +0, except -0 for MPFR_RNDD */
+          MPFR_TMP_FREE (marker);
+          MPFR_SET_ZERO (y);
+          if (rnd_mode == MPFR_RNDD)
+            MPFR_SET_NEG (y);
+          else
+            MPFR_SET_POS (y);
+          MPFR_RET (0);
+        }
+      if (c > 0)
+        mpn_sub (np, up, un, vp, vn);
+      else
+        {
+          mpn_sub (np, vp, vn, up, un);
+          su = sv;
+        }
+      np[nn - 1] = 0;
+    }
+  while (np[nn - 1] == 0)
+    nn--;
+
+  ALLOC (n) = nn;
+  PTR (n) = np;
+  if (b == NULL)
+    {
+      SIZ (n) = su > 0 ? nn : -nn;
+      inex = mpfr_set_z_2exp (y, n, e < 0 ? e : 0, rnd_mode);
+    }
+  else
+    {
+      /* the sign of b is taken into account by mpfr_set_z_div_2exp */
+      SIZ (n) = su * mpz_sgn (b) > 0 ? nn : -nn;
+      inex = mpfr_set_z_div_2exp (y, n, b, e < 0 ? e : 0, rnd_mode);
+    }
+  MPFR_TMP_FREE (marker);
+  return inex;
+}
+
 int
 mpfr_mul_z (mpfr_ptr y, mpfr_srcptr x, mpz_srcptr z, mpfr_rnd_t r)
 {
@@ -98,6 +274,8 @@ mpfr_add_z (mpfr_ptr y, mpfr_srcptr x, mpz_srcptr z, mpfr_rnd_t r)
   /* Mpz 0 is unsigned */
   if (MPFR_UNLIKELY (mpz_sgn (z) == 0))
     return mpfr_set (y, x, r);
+  else if (MPFR_LIKELY (MPFR_IS_PURE_FP (x) && add_zq_p (y, x, z, NULL)))
+    return add_zq (y, x, 1, z, NULL, 1, r);
   else
     return foo (y, x, z, r, mpfr_add);
 }
@@ -108,6 +286,8 @@ mpfr_sub_z (mpfr_ptr y, mpfr_srcptr x, mpz_srcptr z, mpfr_rnd_t r)
   /* Mpz 0 is unsigned */
   if (MPFR_UNLIKELY (mpz_sgn (z) == 0))
     return mpfr_set (y, x, r);
+  else if (MPFR_LIKELY (MPFR_IS_PURE_FP (x) && add_zq_p (y, x, z, NULL)))
+    return add_zq (y, x, 1, z, NULL, -1, r);
   else
     return foo (y, x, z, r, mpfr_sub);
 }
@@ -118,39 +298,70 @@ mpfr_z_sub (mpfr_ptr y, mpz_srcptr x, mpfr_srcptr z, mpfr_rnd_t r)
   /* Mpz 0 is unsigned */
   if (MPFR_UNLIKELY (mpz_sgn (x) == 0))
     return mpfr_neg (y, z, r);
+  else if (MPFR_LIKELY (MPFR_IS_PURE_FP (z) && add_zq_p (y, z, x, NULL)))
+    return add_zq (y, z, -1, x, NULL, 1, r);
   else
     return foo2 (y, x, z, r, mpfr_sub);
 }
 
+/* Set y to RND(z/x). In the special cases (x singular or z = 0), only the
+   sign of z matters. */
+int
+mpfr_z_div (mpfr_ptr y, mpz_srcptr z, mpfr_srcptr x, mpfr_rnd_t r)
+{
+  mpz_t m;
+  mp_size_t xn;
+
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x) || mpz_sgn (z) == 0))
+    {
+      mpfr_t t;
+      int inex;
+
+      /* t has the same sign and class as z (mpz 0 is unsigned) */
+      mpfr_init2 (t, MPFR_PREC_MIN);
+      mpfr_set_si (t, mpz_sgn (z), MPFR_RNDN);
+      inex = mpfr_div (y, t, x, r);
+      MPFR_ASSERTD (inex == 0);
+      mpfr_clear (t);
+      return inex;
+    }
+
+  /* z/x = z/m * 2^(-e), where x = m*2^e with m the significand of x
+     seen as an integer: a single division */
+  xn = MPFR_LIMB_SIZE (x);
+  ALLOC (m) = xn;
+  SIZ (m) = MPFR_IS_NEG (x) ? -xn : xn;
+  PTR (m) = MPFR_MANT (x);
+  return mpfr_set_z_div_2exp (y, z, m, (mpfr_exp_t) xn * GMP_NUMB_BITS
+                              - MPFR_GET_EXP (x), r);
+}
+
+/* The comparison is done directly on the limbs: first on the bit sizes,
+   then on the aligned significands. */
 int
 mpfr_cmp_z (mpfr_srcptr x, mpz_srcptr z)
 {
-  mpfr_t t;
-  int res;
-  mpfr_prec_t p;
-  mpfr_flags_t flags;
+  mp_size_t zn;
+  mpfr_exp_t ex;
+  int s, c;
 
   if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x)))
     return mpfr_cmp_si (x, mpz_sgn (z));
 
-  if (mpz_size (z) <= 1)
-    p = GMP_NUMB_BITS;
-  else
-    MPFR_MPZ_SIZEINBASE2 (p, z);
-  mpfr_init2 (t, p);
-  flags = __gmpfr_flags;
-  if (mpfr_set_z (t, z, MPFR_RNDN))
-    {
-      /* overflow (t is an infinity) or underflow */
-      mpfr_div_2ui (t, t, 2, MPFR_RNDZ);  /* if underflow, set t to zero */
-      __gmpfr_flags = flags;  /* restore the flags */
-      /* The real value of t (= z), which falls outside the exponent range,
-         has been replaced by an equivalent value for the comparison: zero
-         or an infinity. */
-    }
-  res = mpfr_cmp (x, t);
-  mpfr_clear (t);
-  return res;
+  s = MPFR_SIGN (x);
+  if (mpz_sgn (z) != s)
+    return s;  /* z = 0 or z and x have different signs */
+
+  ex = MPFR_GET_EXP (x);
+  if (ex <= 0)
+    return -s;  /* |x| < 1 <= |z| */
+
+  zn = ABS (SIZ (z));
+  count_leading_zeros (c, PTR (z)[zn - 1]);
+  /* compare ex with the bit size of z */
+  if ((mpfr_uexp_t) ex != (mpfr_uexp_t) zn * GMP_NUMB_BITS - c)
+    return (mpfr_uexp_t) ex > (mpfr_uexp_t) zn * GMP_NUMB_BITS - c ? s : -s;
+  return s * cmp_aligned (MPFR_MANT (x), MPFR_LIMB_SIZE (x), PTR (z), zn);
 }
 
 /* Compute y = RND(x*n/d), where n and d are mpz integers.
@@ -245,6 +456,58 @@ mpfr_div_q (mpfr_ptr y, mpfr_srcptr x, mpq_srcptr z, mpfr_rnd_t rnd_mode)
   return mpfr_muldiv_z (y, x, mpq_denref (z), mpq_numref (z), rnd_mode);
 }
 
+/* Set y to RND(q/x) = RND(a/(b*m) * 2^(-e)), where q = a/b and x = m*2^e,
+   with a single division. */
+int
+mpfr_q_div (mpfr_ptr y, mpq_srcptr q, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  mpz_t d;
+  mp_limb_t *dp;
+  mp_size_t xn, bn, dn;
+  int inex;
+  MPFR_TMP_DECL (marker);
+
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x)
+                     || mpz_sgn (mpq_numref (q)) == 0
+                     || mpz_sgn (mpq_denref (q)) == 0))
+    {
+      mpfr_t t;
+
+      /* t has the same sign and class as q (NaN, infinity, 0 or
+         a regular number) */
+      mpfr_init2 (t, MPFR_PREC_MIN);
+      if (mpz_sgn (mpq_numref (q)) == 0 || mpz_sgn (mpq_denref (q)) == 0)
+        mpfr_set_q (t, q, MPFR_RNDN);
+      else
+        mpfr_set_si (t, mpz_sgn (mpq_numref (q)) * mpz_sgn (mpq_denref (q)),
+                     MPFR_RNDN);
+      inex = mpfr_div (y, t, x, rnd_mode);
+      MPFR_ASSERTD (inex == 0);
+      mpfr_clear (t);
+      return inex;
+    }
+
+  xn = MPFR_LIMB_SIZE (x);
+  bn = ABS (SIZ (mpq_denref (q)));
+  MPFR_TMP_MARK (marker);
+  dn = xn + bn;
+  dp = MPFR_TMP_LIMBS_ALLOC (dn);
+  if (xn >= bn)
+    mpn_mul (dp, MPFR_MANT (x), xn, PTR (mpq_denref (q)), bn);
+  else
+    mpn_mul (dp, PTR (mpq_denref (q)), bn, MPFR_MANT (x), xn);
+  if (dp[dn - 1] == 0)
+    dn--;
+  ALLOC (d) = dn;
+  SIZ (d) = MPFR_SIGN (x) * mpz_sgn (mpq_denref (q)) > 0 ? dn : -dn;
+  PTR (d) = dp;
+  inex = mpfr_set_z_div_2exp (y, mpq_numref (q), d,
+                              (mpfr_exp_t) xn * GMP_NUMB_BITS
+                              - MPFR_GET_EXP (x), rnd_mode);
+  MPFR_TMP_FREE (marker);
+  return inex;
+}
+
 int
 mpfr_add_q (mpfr_ptr y, mpfr_srcptr x, mpq_srcptr z, mpfr_rnd_t rnd_mode)
 {
@@ -285,6 +548,11 @@ mpfr_add_q (mpfr_ptr y, mpfr_srcptr x, mpq_srcptr z, mpfr_rnd_t rnd_mode)
         }
     }
 
+  if (MPFR_LIKELY (mpz_sgn (mpq_numref (z)) != 0
+                   && mpz_sgn (mpq_denref (z)) != 0
+                   && add_zq_p (y, x, mpq_numref (z), mpq_denref (z))))
+    return add_zq (y, x, 1, mpq_numref (z), mpq_denref (z), 1, rnd_mode);
+
   MPFR_SAVE_EXPO_MARK (expo);
 
   p = MPFR_PREC (y) + 10;
@@ -380,6 +648,11 @@ mpfr_sub_q (mpfr_ptr y, mpfr_srcptr x, mpq_srcptr z,mpfr_rnd_t rnd_mode)
         }
     }
 
+  if (MPFR_LIKELY (mpz_sgn (mpq_numref (z)) != 0
+                   && mpz_sgn (mpq_denref (z)) != 0
+                   && add_zq_p (y, x, mpq_numref (z), mpq_denref (z))))
+    return add_zq (y, x, 1, mpq_numref (z), mpq_denref (z), -1, rnd_mode);
+
   MPFR_SAVE_EXPO_MARK (expo);
 
   p = MPFR_PREC (y) + 10;
@@ -431,15 +704,19 @@ mpfr_sub_q (mpfr_ptr y, mpfr_srcptr x, mpq_srcptr z,mpfr_rnd_t rnd_mode)
   return mpfr_check_range (y, res, rnd_mode);
 }
 
+/* x < a/b <=> x*b < a (for b > 0), where x*b is computed exactly on the
+   limbs, only when the bit sizes do not allow to conclude. */
 int
 mpfr_cmp_q (mpfr_srcptr x, mpq_srcptr q)
 {
   mpfr_t t;
-  int res;
-  mpfr_prec_t p;
-  MPFR_SAVE_EXPO_DECL (expo);
+  mp_limb_t *tp;
+  mp_size_t xn, an, bn, tn;
+  mpfr_exp_t et, ea;
+  int res, s, ca, cb;
+  MPFR_TMP_DECL (marker);
 
-  if (MPFR_UNLIKELY (mpq_denref (q) == 0))
+  if (MPFR_UNLIKELY (mpz_sgn (mpq_denref (q)) == 0))
     {
       /* q is an infinity or NaN */
       mpfr_init2 (t, 2);
@@ -452,18 +729,40 @@ mpfr_cmp_q (mpfr_srcptr x, mpq_srcptr q)
   if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x)))
     return mpfr_cmp_si (x, mpq_sgn (q));
 
-  MPFR_SAVE_EXPO_MARK (expo);
-
-  /* x < a/b ? <=> x*b < a */
-  MPFR_MPZ_SIZEINBASE2 (p, mpq_denref (q));
-  mpfr_init2 (t, MPFR_PREC(x) + p);
-  res = mpfr_mul_z (t, x, mpq_denref (q), MPFR_RNDN);
-  MPFR_ASSERTD (res == 0);
-  res = mpfr_cmp_z (t, mpq_numref (q));
-  mpfr_clear (t);
-
-  MPFR_SAVE_EXPO_FREE (expo);
-  return res;
+  s = MPFR_SIGN (x);
+  if (mpz_sgn (mpq_numref (q)) * mpz_sgn (mpq_denref (q)) != s)
+    return s;  /* q = 0 or q and x have different signs */
+
+  /* |x*b| has ex + bits(b) - 1 or ex + bits(b) bits, to be compared
+     with bits(a) */
+  xn = MPFR_LIMB_SIZE (x);
+  an = ABS (SIZ (mpq_numref (q)));
+  bn = ABS (SIZ (mpq_denref (q)));
+  count_leading_zeros (ca, PTR (mpq_numref (q))[an - 1]);
+  count_leading_zeros (cb, PTR (mpq_denref (q))[bn - 1]);
+  ea = (mpfr_exp_t) an * GMP_NUMB_BITS - ca;
+  et = MPFR_GET_EXP (x) + ((mpfr_exp_t) bn * GMP_NUMB_BITS - cb);
+  if (et - 1 > ea)
+    return s;
+  if (et < ea)
+    return -s;
+
+  MPFR_TMP_MARK (marker);
+  tn = xn + bn;
+  tp = MPFR_TMP_LIMBS_ALLOC (tn);
+  if (xn >= bn)
+    mpn_mul (tp, MPFR_MANT (x), xn, PTR (mpq_denref (q)), bn);
+  else
+    mpn_mul (tp, PTR (mpq_denref (q)), bn, MPFR_MANT (x), xn);
+  if (tp[tn - 1] == 0)
+    tn--;
+  count_leading_zeros (cb, tp[tn - 1]);
+  /* |x*b| = t * 2^(ex - xn*GMP_NUMB_BITS) */
+  et = MPFR_GET_EXP (x) + ((mpfr_exp_t) (tn - xn) * GMP_NUMB_BITS - cb);
+  res = et != ea ? (et > ea ? 1 : -1)
+    : cmp_aligned (tp, tn, PTR (mpq_numref (q)), an);
+  MPFR_TMP_FREE (marker);
+  return s * res;
 }
 
 int
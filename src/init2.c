@@ -52,13 +52,12 @@ mpfr_init2 (mpfr_ptr x, mpfr_prec_t p)
   MPFR_ASSERTN(p >= MPFR_PREC_MIN && p <= MPFR_PREC_MAX);
 
   xsize = MPFR_PREC2LIMBS (p);
-  tmp   = (mpfr_limb_ptr) (*__gmp_allocate_func)(MPFR_MALLOC_SIZE(xsize));
+  tmp   = mpfr_pool_allocate_mant (xsize);
 
   MPFR_PREC(x) = p;                /* Set prec */
   MPFR_EXP (x) = MPFR_EXP_INVALID; /* make sure that the exp field has a
                                       valid value in the C point of view */
   MPFR_SET_POS(x);                 /* Set a sign */
-  MPFR_SET_MANT_PTR(x, tmp);       /* Set Mantissa ptr */
-  MPFR_SET_ALLOC_SIZE(x, xsize);   /* Fix alloc size of Mantissa */
+  MPFR_MANT(x) = tmp;              /* Set Mantissa ptr and alloc size */
   MPFR_SET_NAN(x);                 /* initializes to NaN */
 }
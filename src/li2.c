@@ -33,11 +33,10 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 static int
 li2_series (mpfr_t sum, mpfr_srcptr z, mpfr_rnd_t rnd_mode)
 {
-  int i, Bm, Bmax;
+  int i;
   mpfr_t s, u, v, w;
   mpfr_prec_t sump, p;
   mpfr_exp_t se, err;
-  mpz_t *B;
   MPFR_ZIV_DECL (loop);
 
   /* The series converges for |z| < 2 pi, but in mpfr_li2 the argument is
@@ -53,9 +52,6 @@ li2_series (mpfr_t sum, mpfr_srcptr z, mpfr_rnd_t rnd_mode)
   mpfr_init2 (v, p);
   mpfr_init2 (w, p);
 
-  B = mpfr_bernoulli_internal ((mpz_t *) 0, 0);
-  Bm = Bmax = 1;
-
   MPFR_ZIV_INIT (loop, p);
   for (;;)
     {
@@ -67,9 +63,6 @@ li2_series (mpfr_t sum, mpfr_srcptr z, mpfr_rnd_t rnd_mode)
 
       for (i = 1;; i++)
         {
-          if (i >= Bmax)
-            B = mpfr_bernoulli_internal (B, Bmax++); /* B_2i*(2i+1)!, exact */
-
           mpfr_mul (v, u, v, MPFR_RNDU);
           mpfr_div_ui (v, v, 2 * i, MPFR_RNDU);
           mpfr_div_ui (v, v, 2 * i, MPFR_RNDU);
@@ -77,7 +70,8 @@ li2_series (mpfr_t sum, mpfr_srcptr z, mpfr_rnd_t rnd_mode)
           mpfr_div_ui (v, v, 2 * i + 1, MPFR_RNDU);
           /* here, v_2i = v_{2i-2} / (2i * (2i+1))^2 */
 
-          mpfr_mul_z (w, v, B[i], MPFR_RNDN);
+          /* B_2i*(2i+1)!, exact */
+          mpfr_mul_z (w, v, mpfr_bernoulli_cache (i), MPFR_RNDN);
           /* here, w_2i = v_2i * B_2i * (2i+1)! with
              error(w_2i) < 2^(5 * i + 8) ulp(w_2i) (see algorithms.tex) */
 
@@ -107,10 +101,6 @@ li2_series (mpfr_t sum, mpfr_srcptr z, mpfr_rnd_t rnd_mode)
   MPFR_ZIV_FREE (loop);
   mpfr_set (sum, s, rnd_mode);
 
-  Bm = Bmax;
-  while (Bm--)
-    mpz_clear (B[Bm]);
-  (*__gmp_free_func) (B, Bmax * sizeof (mpz_t));
   mpfr_clears (s, u, v, w, (mpfr_ptr) 0);
 
   /* Let K be the returned value.
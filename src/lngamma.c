@@ -141,6 +141,122 @@ unit_bit (mpfr_srcptr x)
 
 #endif
 
+/* Set z to the exact product of the integers m + l*d for l0 <= l < l1,
+   with l0 < l1. */
+static void
+mpfr_gamma_rising_z (mpz_ptr z, mpz_srcptr m, mpz_srcptr d,
+                     unsigned long l0, unsigned long l1)
+{
+  if (l1 - l0 <= 8)
+    {
+      mpz_t v;
+
+      mpz_init (v);
+      mpz_set (z, m);
+      mpz_addmul_ui (z, d, l0);
+      while (++l0 < l1)
+        {
+          mpz_set (v, m);
+          mpz_addmul_ui (v, d, l0);
+          mpz_mul (z, z, v);
+        }
+      mpz_clear (v);
+    }
+  else
+    {
+      mpz_t v;
+      unsigned long l = l0 + (l1 - l0) / 2;
+
+      mpz_init (v);
+      mpfr_gamma_rising_z (z, m, d, l0, l);
+      mpfr_gamma_rising_z (v, m, d, l, l1);
+      mpz_mul (z, z, v);
+      mpz_clear (v);
+    }
+}
+
+/* Set t to an approximation of the product of the integers m + l*d for
+   l0 <= l < l1, with l0 < l1, by binary splitting: the sub-products that
+   fit in the precision of t are computed exactly, and rounded to nearest
+   only once, and the products of two halves are rounded to nearest.
+   Thus there are at most 2(l1-l0)-1 roundings. */
+static void
+mpfr_gamma_rising_fr (mpfr_ptr t, mpz_srcptr m, mpz_srcptr d,
+                      unsigned long l0, unsigned long l1)
+{
+  size_t b;
+
+  /* each factor has at most b bits */
+  b = MAX (mpz_sizeinbase (m, 2), mpz_sizeinbase (d, 2)
+           + sizeof (unsigned long) * CHAR_BIT) + 1;
+  if (l1 - l0 == 1 || (l1 - l0) * b <= (size_t) MPFR_PREC (t))
+    {
+      mpz_t z;
+
+      mpz_init (z);
+      mpfr_gamma_rising_z (z, m, d, l0, l1);
+      mpfr_set_z (t, z, MPFR_RNDN);
+      mpz_clear (z);
+    }
+  else
+    {
+      mpfr_t v;
+      unsigned long l = l0 + (l1 - l0) / 2;
+
+      mpfr_init2 (v, MPFR_PREC (t));
+      mpfr_gamma_rising_fr (t, m, d, l0, l);
+      mpfr_gamma_rising_fr (v, m, d, l, l1);
+      mpfr_mul (t, t, v, MPFR_RNDN);
+      mpfr_clear (v);
+    }
+}
+
+/* Set t to z0*(z0+1)*...*(z0+k-1) for k >= 1, with an error of at most
+   2k-1 roundings to nearest, i.e., (1+u)^(2k-1) with |u| <= 2^(-PREC(t)).
+   Since z0 = m*2^e exactly, with e <= 0, this is 2^(k*e) times the product
+   of the integers m + l*2^(-e) for 0 <= l < k, and the argument
+   reconstruction costs far less than k multiplications in the working
+   precision when z0 has few bits. Otherwise we multiply the factors one
+   by one, each z0+l being rounded once. */
+static void
+mpfr_gamma_rising (mpfr_ptr t, mpfr_srcptr z0, unsigned long k)
+{
+  mpz_t m, d;
+  mpfr_exp_t e;
+
+  if (4 * (MPFR_PREC (z0) + MAX (MPFR_GET_EXP (z0), 0)
+           + (mpfr_prec_t) (sizeof (unsigned long) * CHAR_BIT))
+      > MPFR_PREC (t))
+    {
+      mpfr_t u;
+      unsigned long l;
+
+      mpfr_init2 (u, MPFR_PREC (t));
+      mpfr_set (t, z0, MPFR_RNDN); /* t = z0*(1+u) */
+      for (l = 1; l < k; l++)
+        {
+          mpfr_add_ui (u, z0, l, MPFR_RNDN); /* u = (z0+l)*(1+u) */
+          mpfr_mul (t, t, u, MPFR_RNDN);     /* (1+u)^(2l+1) */
+        }
+      mpfr_clear (u);
+      return;
+    }
+
+  mpz_init (m);
+  mpz_init_set_ui (d, 1);
+  e = mpfr_get_z_2exp (m, z0);
+  if (e > 0)
+    {
+      mpz_mul_2exp (m, m, e);
+      e = 0;
+    }
+  mpz_mul_2exp (d, d, -e);
+  mpfr_gamma_rising_fr (t, m, d, 0, k);
+  mpfr_mul_2si (t, t, (long) e * (long) k, MPFR_RNDN); /* exact */
+  mpz_clear (m);
+  mpz_clear (d);
+}
+
 /* lngamma(x) = log(gamma(x)).
    We use formula [6.1.40] from Abramowitz&Stegun:
    lngamma(z) = (z-1/2)*log(z) - z + 1/2*log(2*Pi)
@@ -162,12 +278,9 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
   mpfr_prec_t precy, w; /* working precision */
   mpfr_t s, t, u, v, z;
   unsigned long m, k, maxm;
-  mpz_t *INITIALIZED(B);  /* variable B declared as initialized */
   int compared;
   int inexact = 0;  /* 0 means: result y not set yet */
   mpfr_exp_t err_s, err_t;
-  unsigned long Bm = 0; /* number of allocated B[] */
-  unsigned long oldBm;
   double d;
   MPFR_SAVE_EXPO_DECL (expo);
   MPFR_ZIV_DECL (loop);
@@ -431,13 +544,6 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
 
       mpfr_mul (u, u, u, MPFR_RNDN); /* 1/z^2 * (1+u)^3 */
 
-      if (Bm == 0)
-        {
-          B = mpfr_bernoulli_internal ((mpz_t *) 0, 0);
-          B = mpfr_bernoulli_internal (B, 1);
-          Bm = 2;
-        }
-
       /* m <= maxm ensures that 2*m*(2*m+1) <= ULONG_MAX */
       maxm = 1UL << (GMP_NUMB_BITS / 2 - 1);
 
@@ -463,19 +569,16 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
             }
           /* (1+u)^(10m-8) */
           /* invariant: t=1/(2m)/(2m-1)/z^(2m-1)/(2m+1)! */
-          if (Bm <= m)
-            {
-              B = mpfr_bernoulli_internal (B, m); /* B[2m]*(2m+1)!, exact */
-              Bm ++;
-            }
-          mpfr_mul_z (v, t, B[m], MPFR_RNDN); /* (1+u)^(10m-7) */
+          /* B[2m]*(2m+1)! rounded to nearest: (1+u) */
+          mpfr_mul (v, t, mpfr_bernoulli_cache_fr (m, w), MPFR_RNDN);
+          /* (1+u)^(10m-6) */
           MPFR_ASSERTD(MPFR_GET_EXP(v) <= - (2 * m + 3));
           mpfr_add (s, s, v, MPFR_RNDN);
         }
       /* m <= 1/2*Pi*e*z ensures that |v[m]| < 1/2^(2m+3) */
       MPFR_ASSERTD ((double) m <= 4.26 * mpfr_get_d (z, MPFR_RNDZ));
 
-      /* We have sum([(1+u)^(10m-7)-1]*1/2^(2m+3), m=2..infinity)
+      /* We have sum([(1+u)^(10m-6)-1]*1/2^(2m+3), m=2..infinity)
          <= 1.46*u for u <= 2^(-3).
          We have 0 < lngamma(z) - [(z - 1/2) ln(z) - z + 1/2 ln(2 Pi)] < 0.021
          for z >= 4, thus since the initial s >= 0.85, the different values of
@@ -494,13 +597,7 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
       mpfr_mul_2ui (v, v, 1, MPFR_RNDN); /* v = 2*Pi * (1+u) */
       if (k)
         {
-          unsigned long l;
-          mpfr_set (t, z0, MPFR_RNDN); /* t = z0*(1+u) */
-          for (l = 1; l < k; l++)
-            {
-              mpfr_add_ui (u, z0, l, MPFR_RNDN); /* u = (z0+l)*(1+u) */
-              mpfr_mul (t, t, u, MPFR_RNDN);     /* (1+u)^(2l+1) */
-            }
+          mpfr_gamma_rising (t, z0, k);
           /* now t: (1+u)^(2k-1) */
           /* instead of computing log(sqrt(2*Pi)/t), we compute
              1/2*log(2*Pi/t^2), which trades a square root for a square */
@@ -570,11 +667,6 @@ GAMMA_FUNC (mpfr_ptr y, mpfr_srcptr z0, mpfr_rnd_t rnd)
 #ifdef IS_GAMMA
  end0:
 #endif
-  oldBm = Bm;
-  while (Bm--)
-    mpz_clear (B[Bm]);
-  (*__gmp_free_func) (B, oldBm * sizeof (mpz_t));
-
  end:
   if (inexact == 0)
     inexact = mpfr_set (y, s, rnd);
@@ -38,6 +38,73 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
      so the relative error 4/s^2 is < 4/2^p i.e. 4 ulps.
 */
 
+/* Put in r the value of log(a) rounded in the direction rnd_mode, using
+   one Newton iteration y1 = y0 + a*exp(-y0) - 1, where y0 is log(a)
+   computed at about half the working precision (recursively), so that
+   the cost is dominated by mpfr_exp at the working precision.
+   Assumes a is a positive regular number different from 1, and that the
+   exponent range has been extended.
+
+   Let w be the working precision and y0 = log(a) + d, computed with
+   rounding to nearest on w0 bits, where w0 is chosen so that
+   |d| <= 2^(eb-w0-1) <= 2^(-w/2-3), eb >= EXP(log(a)). Since
+   a*exp(-y0) = exp(-d), the exact Newton step gives log(a) + d^2/2 + ...,
+   thus an error at most d^2 <= 2^(-w-6). The approximation z of exp(-d)
+   gets two roundings of relative error 2^(-w), thus an absolute error at
+   most 1.01*(2^(1-w) + 2^(-2w)), z - 1 is exact, and the final addition
+   adds ulp(y1)/2. Altogether, the absolute error is bounded by
+   2^(-w-6) + 1.02*2^(1-w) + 2^(EXP(y1)-w-1) < 2^(max(EXP(y1),2)+1-w). */
+int
+mpfr_log_newton (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t y0, z, y1;
+  mpfr_prec_t w, w0, eb;
+  mpfr_exp_t ea = MPFR_GET_EXP (a), e1;
+  int inexact;
+  MPFR_ZIV_DECL (loop);
+
+  /* |log(a)| < (|EXP(a)| + 1) * log(2) */
+  eb = MPFR_INT_CEIL_LOG2 ((ea < 0 ? - ea : ea) + 1);
+  w = MPFR_PREC (r) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (r)) + 10;
+  mpfr_init2 (y0, MPFR_PREC_MIN);
+  mpfr_init2 (z, w);
+  mpfr_init2 (y1, w);
+
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      w0 = w / 2 + eb + 4;
+      mpfr_set_prec (y0, w0);
+      mpfr_log (y0, a, MPFR_RNDN);
+      mpfr_neg (y0, y0, MPFR_RNDN);
+      mpfr_exp (z, y0, MPFR_RNDN);
+      mpfr_mul (z, z, a, MPFR_RNDN);
+      mpfr_sub_ui (z, z, 1, MPFR_RNDN); /* exact */
+      mpfr_sub (y1, z, y0, MPFR_RNDN);
+      if (MPFR_LIKELY (!MPFR_IS_ZERO (y1)))
+        {
+          e1 = MPFR_GET_EXP (y1);
+          if (MPFR_LIKELY (MPFR_CAN_ROUND (y1, w - 1 - (e1 < 2 ? 2 - e1 : 0),
+                                           MPFR_PREC (r), rnd_mode)))
+            break;
+          /* if log(a) is small, we need more absolute accuracy */
+          if (e1 < 0)
+            w -= e1;
+        }
+      else
+        w += 2 * w0; /* a is very close to 1 */
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (z, w);
+      mpfr_set_prec (y1, w);
+    }
+  MPFR_ZIV_FREE (loop);
+  inexact = mpfr_set (r, y1, rnd_mode);
+  mpfr_clear (y0);
+  mpfr_clear (z);
+  mpfr_clear (y1);
+  return inexact;
+}
+
 int
 mpfr_log (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
 {
@@ -111,6 +178,23 @@ mpfr_log (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
       p += GMP_NUMB_BITS - (p%GMP_NUMB_BITS); */
 
   MPFR_SAVE_EXPO_MARK (expo);
+
+  /* Above MPFR_LOG_THRESHOLD, use Newton's iteration on mpfr_exp, which
+     does not need Pi and log(2). The choice depends only on the precision
+     (not on the constants that are cached), so that the algorithm used for
+     given inputs is always the same. Since the AGM is faster as soon as
+     Pi and log(2) are cached, the default threshold disables this path
+     (see mparam.h). We also avoid the case where 1/a might not be
+     representable. */
+  if (q >= MPFR_LOG_THRESHOLD
+      && MPFR_GET_EXP (a) > MPFR_EMIN_MIN / 2
+      && MPFR_GET_EXP (a) < MPFR_EMAX_MAX / 2)
+    {
+      inexact = mpfr_log_newton (r, a, rnd_mode);
+      MPFR_SAVE_EXPO_FREE (expo);
+      return mpfr_check_range (r, inexact, rnd_mode);
+    }
+
   MPFR_GROUP_INIT_2 (group, p, tmp1, tmp2);
 
   MPFR_ZIV_INIT (loop, p);
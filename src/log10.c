@@ -114,11 +114,14 @@ mpfr_log10 (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
       {
         /* compute log10 */
         mpfr_set_ui (t, 10, MPFR_RNDN);   /* 10 */
-        mpfr_log (t, t, MPFR_RNDD);       /* log(10) */
-        mpfr_log (tt, a, MPFR_RNDN);      /* log(a) */
+        mpfr_log (t, t, MPFR_RNDF);       /* log(10) */
+        mpfr_log (tt, a, MPFR_RNDF);      /* log(a) */
         mpfr_div (t, tt, t, MPFR_RNDN);   /* log(a)/log(10) */
 
-        /* estimation of the error */
+        /* estimation of the error: both logarithms are faithful, thus
+           with a relative error of at most 2^(1-Nt), and the division
+           adds 2^(-Nt), so that the total relative error is less than
+           6*2^(-Nt), i.e., less than 12 ulp(t) */
         err = Nt - 4;
         if (MPFR_LIKELY (MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
           break;
@@ -132,12 +132,13 @@ mpfr_log1p (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
             inexact = mpfr_log (y, t, rnd_mode);
             goto end;
           }
-        mpfr_log (t, t, MPFR_RNDN);        /* log(1+x) */
+        mpfr_log (t, t, MPFR_RNDF);        /* log(1+x) */
 
-        /* the error is bounded by (1/2+2^(1-EXP(t))*ulp(t) (cf algorithms.tex)
-           if EXP(t)>=2, then error <= ulp(t)
+        /* the error is bounded by (1+2^(1-EXP(t))*ulp(t) (cf algorithms.tex,
+           with 1 ulp instead of 1/2 ulp for the faithful logarithm)
+           if EXP(t)>=1, then error <= 2*ulp(t)
            if EXP(t)<=1, then error <= 2^(2-EXP(t))*ulp(t) */
-        err = Nt - MAX (0, 2 - MPFR_GET_EXP (t));
+        err = Nt - MAX (1, 2 - MPFR_GET_EXP (t));
 
         if (MPFR_LIKELY (MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
           break;
@@ -116,11 +116,14 @@ mpfr_log2 (mpfr_ptr r, mpfr_srcptr a, mpfr_rnd_t rnd_mode)
       {
         /* compute log2 */
         mpfr_const_log2(t,MPFR_RNDD); /* log(2) */
-        mpfr_log(tt,a,MPFR_RNDN);     /* log(a) */
+        mpfr_log(tt,a,MPFR_RNDF);     /* log(a) */
         mpfr_div(t,tt,t,MPFR_RNDN); /* log(a)/log(2) */
 
-        /* estimation of the error */
-        err = Nt-3;
+        /* estimation of the error: log(2) rounded downward and the faithful
+           log(a) have a relative error of at most 2^(1-Nt), and the
+           division adds 2^(-Nt), so that the total relative error is less
+           than 6*2^(-Nt), i.e., less than 12 ulp(t) */
+        err = Nt - 4;
         if (MPFR_LIKELY (MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
           break;
 
@@ -353,14 +353,27 @@ mpfr_default_free (void *blk_ptr, size_t blk_size)
   free (blk_ptr);
 }
 
+/* In the MPFR_ALLOCATOR_POOL mode or when a workspace is bound, the blocks
+   come from the pool or the workspace of the current thread (the mode and
+   the workspace cannot change between TMP_MARK and TMP_FREE). */
 void *
 mpfr_tmp_allocate (struct tmp_marker **tmp_marker, size_t size)
 {
   struct tmp_marker *head;
 
-  head = (struct tmp_marker *)
-    mpfr_default_allocate (sizeof (struct tmp_marker));
-  head->ptr = mpfr_default_allocate (size);
+  if (mpfr_pool_enabled ())
+    {
+      size = mpfr_pool_round_size (size);
+      head = (struct tmp_marker *)
+        mpfr_pool_allocate (sizeof (struct tmp_marker));
+      head->ptr = mpfr_pool_allocate (size);
+    }
+  else
+    {
+      head = (struct tmp_marker *)
+        mpfr_default_allocate (sizeof (struct tmp_marker));
+      head->ptr = mpfr_default_allocate (size);
+    }
   head->size = size;
   head->next = *tmp_marker;
   *tmp_marker = head;
@@ -371,13 +384,22 @@ void
 mpfr_tmp_free (struct tmp_marker *tmp_marker)
 {
   struct tmp_marker *t;
+  int pool = mpfr_pool_enabled ();
 
   while (tmp_marker != NULL)
     {
       t = tmp_marker;
-      mpfr_default_free (t->ptr, t->size);
       tmp_marker = t->next;
-      mpfr_default_free (t, sizeof (struct tmp_marker));
+      if (pool)
+        {
+          mpfr_pool_free (t->ptr, t->size);
+          mpfr_pool_free (t, sizeof (struct tmp_marker));
+        }
+      else
+        {
+          mpfr_default_free (t->ptr, t->size);
+          mpfr_default_free (t, sizeof (struct tmp_marker));
+        }
     }
 }
 
@@ -263,6 +263,13 @@ struct __gmpfr_cache_s {
 typedef struct __gmpfr_cache_s mpfr_cache_t[1];
 typedef struct __gmpfr_cache_s *mpfr_cache_ptr;
 
+/* Maximal number of limbs kept by each of the caches of tables (Bernoulli
+   numbers, coefficients for zeta), freed by mpfr_free_cache. Larger
+   tables are recomputed at each call. */
+#ifndef MPFR_CACHE_TABLE_LIMBS
+# define MPFR_CACHE_TABLE_LIMBS (1UL << 22) /* 32 MB with 64-bit limbs */
+#endif
+
 #if defined (__cplusplus)
 extern "C" {
 #endif
@@ -274,6 +281,7 @@ __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_prec_t  __gmpfr_default_fp_bit_prec
 __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_rnd_t   __gmpfr_default_rounding_mode;
 __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_euler;
 __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_catalan;
+__MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_two_over_pi;
 
 #ifndef MPFR_USE_LOGGING
 __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_cache_t __gmpfr_cache_const_pi;
@@ -884,8 +892,8 @@ typedef intmax_t mpfr_eexp_t;
  ******************************************************/
 
 /* MPFR_RND_MAX gives the number of supported rounding modes by all functions.
- * Once faithful rounding is implemented, MPFR_RNDA should be changed
- * to MPFR_RNDF. But this will also require more changes in the tests.
+ * It does not include MPFR_RNDF, for which the ternary value is unspecified
+ * and that is tested separately (see tgeneric.c).
  */
 #define MPFR_RND_MAX ((mpfr_rnd_t)((MPFR_RNDA)+1))
 
@@ -906,25 +914,39 @@ typedef intmax_t mpfr_eexp_t;
 #define MPFR_IS_LIKE_RNDD(rnd, sign) \
   ((rnd==MPFR_RNDD) || (rnd==MPFR_RNDZ && sign>0) || (rnd==MPFR_RNDA && sign<0))
 
+/* Faithful rounding (MPFR_RNDF): the low-level rounding code treats it as
+   rounding to nearest, which gives a faithful result both for an exact
+   value and for an approximation with an error of at most 1/4 ulp in the
+   target precision, which is what MPFR_CAN_ROUND and mpfr_can_round check
+   with MPFR_RNDF. Thus a function built on a Ziv loop returns a faithful
+   result after the first iteration with a small enough error, without any
+   rounding test. */
+#define MPFR_IS_RNDN_OR_RNDF(rnd) ((rnd) == MPFR_RNDN || (rnd) == MPFR_RNDF)
+
 /* Invert a rounding mode, RNDZ and RNDA are unchanged */
 #define MPFR_INVERT_RND(rnd) ((rnd == MPFR_RNDU) ? MPFR_RNDD : \
                              ((rnd == MPFR_RNDD) ? MPFR_RNDU : rnd))
 
-/* Transform RNDU and RNDD to RNDZ according to test */
+/* Transform RNDU and RNDD to RNDZ according to test, and RNDF to RNDZ.
+   These macros are only used on exact values, which are faithfully
+   rounded by a truncation. */
 #define MPFR_UPDATE_RND_MODE(rnd, test)                            \
   do {                                                             \
-    if (MPFR_UNLIKELY(MPFR_IS_RNDUTEST_OR_RNDDNOTTEST(rnd, test))) \
+    if (MPFR_UNLIKELY(MPFR_IS_RNDUTEST_OR_RNDDNOTTEST(rnd, test))  \
+        || rnd == MPFR_RNDF)                                       \
       rnd = MPFR_RNDZ;                                              \
   } while (0)
 
-/* Transform RNDU and RNDD to RNDZ or RNDA according to sign,
-   leave the other modes unchanged */
+/* Transform RNDU and RNDD to RNDZ or RNDA according to sign, RNDF to
+   RNDZ, leave the other modes unchanged */
 #define MPFR_UPDATE2_RND_MODE(rnd, sign)        \
   do {                                          \
   if (rnd == MPFR_RNDU)                          \
     rnd = (sign > 0) ? MPFR_RNDA : MPFR_RNDZ;     \
   else if (rnd == MPFR_RNDD)                     \
     rnd = (sign < 0) ? MPFR_RNDA : MPFR_RNDZ;     \
+  else if (rnd == MPFR_RNDF)                     \
+    rnd = MPFR_RNDZ;                             \
   } while (0)
 
 
@@ -964,8 +986,14 @@ typedef intmax_t mpfr_eexp_t;
 
 /* Heap Memory gestion */
 typedef union { mp_size_t s; mp_limb_t l; } mpfr_size_limb_t;
+/* The high bits of the allocated size (below the sign bit) tell how the
+   significand has been allocated (see pool.c). */
+#define MPFR_ALLOC_TAG_SHIFT (sizeof (mp_size_t) * CHAR_BIT - 3)
+#define MPFR_ALLOC_SIZE_MASK (((mp_size_t) 1 << MPFR_ALLOC_TAG_SHIFT) - 1)
+#define MPFR_ALLOC_WORKSPACE ((mp_size_t) 1 << MPFR_ALLOC_TAG_SHIFT)
+#define MPFR_ALLOC_OWNED ((mp_size_t) 2 << MPFR_ALLOC_TAG_SHIFT)
 #define MPFR_GET_ALLOC_SIZE(x) \
- ( ((mp_size_t*) MPFR_MANT(x))[-1] + 0)
+ ( ((mp_size_t*) MPFR_MANT(x))[-1] & MPFR_ALLOC_SIZE_MASK)
 #define MPFR_SET_ALLOC_SIZE(x, n) \
  ( ((mp_size_t*) MPFR_MANT(x))[-1] = n)
 #define MPFR_MALLOC_SIZE(s) \
@@ -1312,7 +1340,7 @@ typedef struct {
             _rb = _sp[0] & _mask;                                           \
             _sb = _sp[0] & (_mask - 1);                                     \
             if (MPFR_UNLIKELY (_sb == 0) &&                                 \
-                ((rnd) == MPFR_RNDN || _rb == 0))                           \
+                (MPFR_IS_RNDN_OR_RNDF (rnd) || _rb == 0))                   \
               { /* TODO: Improve it */                                      \
                 mp_limb_t *_tmp;                                            \
                 mp_size_t _n;                                               \
@@ -1329,7 +1357,7 @@ typedef struct {
             _rb = _sp[-1] & MPFR_LIMB_HIGHBIT;                              \
             _sb = _sp[-1] & (MPFR_LIMB_HIGHBIT-1);                          \
             if (MPFR_UNLIKELY (_sb == 0) &&                                 \
-                ((rnd) == MPFR_RNDN || _rb == 0))                           \
+                (MPFR_IS_RNDN_OR_RNDF (rnd) || _rb == 0))                   \
               {                                                             \
                 mp_limb_t *_tmp;                                            \
                 mp_size_t _n;                                               \
@@ -1340,7 +1368,7 @@ typedef struct {
             _ulp = MPFR_LIMB_ONE;                                           \
           }                                                                 \
         /* Rounding */                                                      \
-        if (MPFR_LIKELY (rnd == MPFR_RNDN))                                 \
+        if (MPFR_LIKELY (MPFR_IS_RNDN_OR_RNDF (rnd)))                       \
           {                                                                 \
             if (_rb == 0)                                                   \
               {                                                             \
@@ -1426,8 +1454,11 @@ typedef struct {
    and determine the ternary value, with rounding mode 'rnd', and with
    error at most 'error' */
 #define MPFR_CAN_ROUND(b,err,prec,rnd)                                       \
- (!MPFR_IS_SINGULAR (b) && mpfr_round_p (MPFR_MANT (b), MPFR_LIMB_SIZE (b),  \
-                                         (err), (prec) + ((rnd)==MPFR_RNDN)))
+ (!MPFR_IS_SINGULAR (b) &&                                                   \
+  ((rnd) == MPFR_RNDF ?                                                      \
+   (mpfr_exp_t) (err) >= (mpfr_exp_t) (prec) + 2 :                           \
+   mpfr_round_p (MPFR_MANT (b), MPFR_LIMB_SIZE (b),                          \
+                 (err), (prec) + ((rnd)==MPFR_RNDN))))
 
 /* Copy the sign and the significand, and handle the exponent in exp. */
 #define MPFR_SETRAW(inexact,dest,src,exp,rnd)                           \
@@ -1753,7 +1784,7 @@ struct mpfr_group_t {
                 (unsigned long) (g).alloc));                     \
  if (MPFR_UNLIKELY ((g).alloc != 0)) {                           \
    MPFR_ASSERTD ((g).mant != (g).tab);                           \
-   (*__gmp_free_func) ((g).mant, (g).alloc);                     \
+   mpfr_pool_free ((g).mant, (g).alloc);                         \
  }} while (0)
 
 #define MPFR_GROUP_INIT_TEMPLATE(g, prec, num, handler) do {            \
@@ -1766,7 +1797,7 @@ struct mpfr_group_t {
  if (MPFR_UNLIKELY (_size * (num) > MPFR_GROUP_STATIC_SIZE))            \
    {                                                                    \
      (g).alloc = (num) * _size * sizeof (mp_limb_t);                    \
-     (g).mant = (mp_limb_t *) (*__gmp_allocate_func) ((g).alloc);       \
+     (g).mant = (mp_limb_t *) mpfr_pool_allocate ((g).alloc);           \
    }                                                                    \
  else                                                                   \
    {                                                                    \
@@ -1816,10 +1847,10 @@ struct mpfr_group_t {
  _size = MPFR_PREC2LIMBS (_prec);                                       \
  (g).alloc = (num) * _size * sizeof (mp_limb_t);                        \
  if (MPFR_LIKELY (_oalloc == 0))                                        \
-   (g).mant = (mp_limb_t *) (*__gmp_allocate_func) ((g).alloc);         \
+   (g).mant = (mp_limb_t *) mpfr_pool_allocate ((g).alloc);             \
  else                                                                   \
    (g).mant = (mp_limb_t *)                                             \
-     (*__gmp_reallocate_func) ((g).mant, _oalloc, (g).alloc);           \
+     mpfr_pool_reallocate ((g).mant, _oalloc, (g).alloc);               \
  MPFR_LOG_MSG (("GROUP_REPREC: newptr = 0x%lX, newsize = %lu\n",        \
                 (unsigned long) (g).mant, (unsigned long) (g).alloc));  \
  handler;                                                               \
@@ -1850,6 +1881,29 @@ struct mpfr_group_t {
    MPFR_GROUP_TINIT(g, 4, a);MPFR_GROUP_TINIT(g, 5, b))
 
 
+/******************************************************
+ *****************  Random deviates  ******************
+ ******************************************************/
+
+/* A uniform random deviate in (0,1) whose bits are generated on demand
+   (see random_deviate.c), used by the exact samplers mpfr_nrandom and
+   mpfr_erandom. Only the first e bits of the fraction have been drawn:
+   the first MPFR_RANDOM_DEVIATE_W ones are in h, the next ones in f. */
+
+#define MPFR_RANDOM_DEVIATE_W 32
+
+typedef struct {
+  unsigned long e;  /* number of bits of the fraction drawn so far */
+  unsigned long h;  /* the first MPFR_RANDOM_DEVIATE_W bits */
+  mpz_t f;          /* the next e - MPFR_RANDOM_DEVIATE_W bits */
+} __mpfr_random_deviate_struct;
+typedef __mpfr_random_deviate_struct mpfr_random_deviate_t[1];
+typedef __mpfr_random_deviate_struct *mpfr_random_deviate_ptr;
+
+/* Forget the drawn bits: x becomes a new independent deviate. */
+#define mpfr_random_deviate_reset(x) ((void) ((x)->e = 0))
+
+
 /******************************************************
  ***************  Internal Functions  *****************
  ******************************************************/
@@ -1886,6 +1940,8 @@ __MPFR_DECLSPEC mpfr_exp_t mpfr_ceil_mul _MPFR_PROTO ((mpfr_exp_t, int, int));
 
 __MPFR_DECLSPEC int mpfr_exp_2 _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_exp_3 _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_bitburst_exp _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr));
+__MPFR_DECLSPEC int mpfr_bitburst_atan _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr));
 __MPFR_DECLSPEC int mpfr_powerof2_raw _MPFR_PROTO ((mpfr_srcptr));
 
 __MPFR_DECLSPEC int mpfr_pow_general _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
@@ -1934,6 +1990,8 @@ __MPFR_DECLSPEC int mpfr_const_pi_internal _MPFR_PROTO ((mpfr_ptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_const_log2_internal _MPFR_PROTO((mpfr_ptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_const_euler_internal _MPFR_PROTO((mpfr_ptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_const_catalan_internal _MPFR_PROTO((mpfr_ptr, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_const_two_over_pi_internal _MPFR_PROTO((mpfr_ptr,
+                                                             mpfr_rnd_t));
 
 #if 0
 __MPFR_DECLSPEC void mpfr_init_cache _MPFR_PROTO ((mpfr_cache_t,
@@ -1963,12 +2021,65 @@ __MPFR_DECLSPEC MPFR_NORETURN void mpfr_abort_prec_max _MPFR_PROTO ((void));
 __MPFR_DECLSPEC void mpfr_rand_raw _MPFR_PROTO((mpfr_limb_ptr, gmp_randstate_t,
                                                 mpfr_prec_t));
 
-__MPFR_DECLSPEC mpz_t* mpfr_bernoulli_internal _MPFR_PROTO((mpz_t*,
-                                                            unsigned long));
+__MPFR_DECLSPEC int mpfr_set_z_div_2exp _MPFR_PROTO((mpfr_ptr, mpz_srcptr,
+                                                     mpz_srcptr, mpfr_exp_t,
+                                                     mpfr_rnd_t));
+
+__MPFR_DECLSPEC void *mpfr_pool_allocate _MPFR_PROTO ((size_t));
+__MPFR_DECLSPEC void *mpfr_pool_reallocate _MPFR_PROTO ((void *, size_t,
+                                                         size_t));
+__MPFR_DECLSPEC void mpfr_pool_free _MPFR_PROTO ((void *, size_t));
+__MPFR_DECLSPEC mpfr_limb_ptr mpfr_pool_allocate_mant _MPFR_PROTO
+  ((mp_size_t));
+__MPFR_DECLSPEC mpfr_limb_ptr mpfr_pool_reallocate_mant _MPFR_PROTO
+  ((mpfr_limb_ptr, mp_size_t));
+__MPFR_DECLSPEC void mpfr_pool_free_mant _MPFR_PROTO ((mpfr_limb_ptr));
+__MPFR_DECLSPEC void mpfr_pool_clear _MPFR_PROTO ((void));
+__MPFR_DECLSPEC size_t mpfr_pool_round_size _MPFR_PROTO ((size_t));
+__MPFR_DECLSPEC int mpfr_pool_enabled _MPFR_PROTO ((void));
+
+__MPFR_DECLSPEC void mpfr_random_deviate_init _MPFR_PROTO((
+                        mpfr_random_deviate_ptr));
+__MPFR_DECLSPEC void mpfr_random_deviate_clear _MPFR_PROTO((
+                        mpfr_random_deviate_ptr));
+__MPFR_DECLSPEC int mpfr_random_deviate_tstbit _MPFR_PROTO((
+                        mpfr_random_deviate_ptr, unsigned long,
+                        gmp_randstate_t));
+__MPFR_DECLSPEC int mpfr_random_deviate_less _MPFR_PROTO((
+                        mpfr_random_deviate_ptr, mpfr_random_deviate_ptr,
+                        gmp_randstate_t));
+__MPFR_DECLSPEC int mpfr_random_deviate_value _MPFR_PROTO((int,
+                        unsigned long, mpfr_random_deviate_ptr, mpfr_ptr,
+                        gmp_randstate_t, mpfr_rnd_t));
+
+__MPFR_DECLSPEC mpz_srcptr mpfr_bernoulli_cache _MPFR_PROTO((unsigned long));
+__MPFR_DECLSPEC mpfr_srcptr mpfr_bernoulli_cache_fr _MPFR_PROTO((unsigned long,
+                                                                mpfr_prec_t));
+__MPFR_DECLSPEC void mpfr_bernoulli_freecache _MPFR_PROTO((void));
+
+/* mpfr_gamma calls mpfr_fac_ui (resp. mpfr_odd_fac_ui) at the integers
+   (resp. half-integers) up to MPFR_FAC_TREE_RATIO times the target
+   precision, and mpfr_fac_ui calls mpfr_gamma above. */
+#define MPFR_FAC_TREE_RATIO 16
+__MPFR_DECLSPEC int mpfr_odd_fac_ui _MPFR_PROTO((mpfr_ptr, unsigned long,
+                                                 mpfr_rnd_t));
+__MPFR_DECLSPEC void mpfr_zeta_freecache _MPFR_PROTO((void));
+__MPFR_DECLSPEC void mpfr_zeta_ui_freecache _MPFR_PROTO((void));
 
 __MPFR_DECLSPEC int mpfr_sincos_fast _MPFR_PROTO((mpfr_t, mpfr_t,
                                                   mpfr_srcptr, mpfr_rnd_t));
 
+__MPFR_DECLSPEC int mpfr_log_newton _MPFR_PROTO((mpfr_ptr, mpfr_srcptr,
+                                                mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_atan_bitburst _MPFR_PROTO((mpfr_ptr, mpfr_srcptr,
+                                                   mpfr_rnd_t));
+
+__MPFR_DECLSPEC int mpfr_reduce_pi2 _MPFR_PROTO((mpfr_ptr, mpfr_srcptr));
+__MPFR_DECLSPEC int mpfr_sincos2_aux _MPFR_PROTO((mpfr_ptr, mpfr_srcptr,
+                                                   unsigned long));
+__MPFR_DECLSPEC int mpfr_sin_reduced _MPFR_PROTO((mpfr_ptr, mpfr_srcptr));
+__MPFR_DECLSPEC int mpfr_cos_reduced _MPFR_PROTO((mpfr_ptr, mpfr_srcptr));
+
 __MPFR_DECLSPEC double mpfr_scale2 _MPFR_PROTO((double, int));
 
 __MPFR_DECLSPEC void mpfr_div_ui2 _MPFR_PROTO((mpfr_ptr, mpfr_srcptr,
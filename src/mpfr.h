@@ -98,6 +98,10 @@ typedef unsigned int    mpfr_flags_t;
                         MPFR_FLAGS_ERANGE    | \
                         MPFR_FLAGS_DIVBY0)
 
+/* Allocator modes (see mpfr_set_allocator_mode) */
+#define MPFR_ALLOCATOR_DEFAULT 0
+#define MPFR_ALLOCATOR_POOL 1
+
 /* Definition of rounding modes (DON'T USE MPFR_RNDNA!).
    Warning! Changing the contents of this enum should be seen as an
    interface change since the old and the new types are not compatible
@@ -107,8 +111,8 @@ typedef unsigned int    mpfr_flags_t;
    MPFR_RNDU must appear just before MPFR_RNDD (see
    MPFR_IS_RNDUTEST_OR_RNDDNOTTEST in mpfr-impl.h).
 
-   MPFR_RNDF has been added, though not implemented yet, in order to avoid
-   to break the ABI once faithful rounding gets implemented.
+   MPFR_RNDF (faithful rounding) comes last since it is not supported by
+   all the functions and is not included in MPFR_RND_MAX (mpfr-impl.h).
 
    If you change the order of the rounding modes, please update the routines
    in texceptions.c which assume 0=RNDN, 1=RNDZ, 2=RNDU, 3=RNDD, 4=RNDA.
@@ -119,7 +123,7 @@ typedef enum {
   MPFR_RNDU,    /* round toward +Inf */
   MPFR_RNDD,    /* round toward -Inf */
   MPFR_RNDA,    /* round away from zero */
-  MPFR_RNDF,    /* faithful rounding (not implemented yet) */
+  MPFR_RNDF,    /* faithful rounding */
   MPFR_RNDNA=-1 /* round to nearest, with ties away from zero (mpfr_round) */
 } mpfr_rnd_t;
 
@@ -494,6 +498,7 @@ __MPFR_DECLSPEC char*mpfr_get_str _MPFR_PROTO ((char*, mpfr_exp_t*, int, size_t,
                                                 mpfr_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_get_z _MPFR_PROTO ((mpz_ptr z, mpfr_srcptr f,
                                              mpfr_rnd_t));
+__MPFR_DECLSPEC void mpfr_get_q _MPFR_PROTO ((mpq_ptr q, mpfr_srcptr f));
 
 __MPFR_DECLSPEC void mpfr_free_str _MPFR_PROTO ((char *));
 
@@ -501,7 +506,16 @@ __MPFR_DECLSPEC int mpfr_urandom _MPFR_PROTO ((mpfr_ptr, gmp_randstate_t,
                                                mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_grandom _MPFR_PROTO ((mpfr_ptr, mpfr_ptr, gmp_randstate_t,
                                                mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_nrandom _MPFR_PROTO ((mpfr_ptr, gmp_randstate_t,
+                                               mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_erandom _MPFR_PROTO ((mpfr_ptr, gmp_randstate_t,
+                                               mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_urandomb _MPFR_PROTO ((mpfr_ptr, gmp_randstate_t));
+__MPFR_DECLSPEC int mpfr_urandomb_vec _MPFR_PROTO ((mpfr_ptr *, unsigned long,
+                                                    gmp_randstate_t));
+__MPFR_DECLSPEC int mpfr_urandom_vec _MPFR_PROTO ((mpfr_ptr *, unsigned long,
+                                                   gmp_randstate_t,
+                                                   mpfr_rnd_t));
 
 __MPFR_DECLSPEC void mpfr_nextabove _MPFR_PROTO ((mpfr_ptr));
 __MPFR_DECLSPEC void mpfr_nextbelow _MPFR_PROTO ((mpfr_ptr));
@@ -713,10 +727,28 @@ __MPFR_DECLSPEC int mpfr_atan _MPFR_PROTO ((mpfr_ptr,mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_sin _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_sin_cos _MPFR_PROTO ((mpfr_ptr, mpfr_ptr,
                                                mpfr_srcptr, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_sin_cos_seq _MPFR_PROTO ((mpfr_ptr *, mpfr_ptr *,
+                                                   mpfr_srcptr, mpfr_srcptr,
+                                                   unsigned long, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_cos _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_tan _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_atan2 _MPFR_PROTO ((mpfr_ptr,mpfr_srcptr,mpfr_srcptr,
                                              mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_sinu _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                            unsigned long, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_cosu _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                            unsigned long, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_tanu _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                            unsigned long, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_sinpi _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                             mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_cospi _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                             mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_tanpi _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                             mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_atan2u _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
+                                              mpfr_srcptr, unsigned long,
+                                              mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_sec _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_csc _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_cot _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,mpfr_rnd_t));
@@ -733,6 +765,8 @@ __MPFR_DECLSPEC int mpfr_lgamma _MPFR_PROTO((mpfr_ptr,int*,mpfr_srcptr,mpfr_rnd_
 __MPFR_DECLSPEC int mpfr_digamma _MPFR_PROTO((mpfr_ptr,mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_zeta _MPFR_PROTO ((mpfr_ptr,mpfr_srcptr,mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_zeta_ui _MPFR_PROTO ((mpfr_ptr,unsigned long,mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_zeta_ui_vec _MPFR_PROTO ((mpfr_ptr *, unsigned long,
+                                                   unsigned long, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_fac_ui _MPFR_PROTO ((mpfr_ptr, unsigned long int,
                                               mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_j0 _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr, mpfr_rnd_t));
@@ -763,12 +797,16 @@ __MPFR_DECLSPEC int mpfr_sub_z _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                              mpz_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_z_sub _MPFR_PROTO ((mpfr_ptr, mpz_srcptr,
                                              mpfr_srcptr, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_z_div _MPFR_PROTO ((mpfr_ptr, mpz_srcptr,
+                                             mpfr_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_cmp_z _MPFR_PROTO ((mpfr_srcptr, mpz_srcptr));
 
 __MPFR_DECLSPEC int mpfr_mul_q _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                              mpq_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_div_q _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                              mpq_srcptr, mpfr_rnd_t));
+__MPFR_DECLSPEC int mpfr_q_div _MPFR_PROTO ((mpfr_ptr, mpq_srcptr,
+                                             mpfr_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_add_q _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
                                              mpq_srcptr, mpfr_rnd_t));
 __MPFR_DECLSPEC int mpfr_sub_q _MPFR_PROTO ((mpfr_ptr, mpfr_srcptr,
@@ -786,6 +824,11 @@ __MPFR_DECLSPEC int mpfr_sum _MPFR_PROTO ((mpfr_ptr, mpfr_ptr *__gmp_const,
 
 __MPFR_DECLSPEC void mpfr_free_cache _MPFR_PROTO ((void));
 
+__MPFR_DECLSPEC int mpfr_set_allocator_mode _MPFR_PROTO ((int));
+__MPFR_DECLSPEC int mpfr_get_allocator_mode _MPFR_PROTO ((void));
+__MPFR_DECLSPEC int mpfr_set_workspace _MPFR_PROTO ((void *, size_t));
+__MPFR_DECLSPEC size_t mpfr_get_workspace_peak _MPFR_PROTO ((void));
+
 __MPFR_DECLSPEC int  mpfr_subnormalize _MPFR_PROTO ((mpfr_ptr, int,
                                                      mpfr_rnd_t));
 
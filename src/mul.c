@@ -216,8 +216,8 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   mpfr_exp_t ax, ax2;
   mp_limb_t *tmp;
   mp_limb_t b1;
-  mpfr_prec_t bq, cq;
-  mp_size_t bn, cn, tn, k, threshold;
+  mpfr_prec_t bq, cq, tq;
+  mp_size_t bn, cn, tn, k, threshold, bz, cz;
   MPFR_TMP_DECL (marker);
 
   MPFR_LOG_FUNC
@@ -293,6 +293,7 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   cq = MPFR_PREC (c);
 
   MPFR_ASSERTN ((mpfr_uprec_t) bq + cq <= MPFR_PREC_MAX);
+  tq = bq + cq; /* precision of the product in tmp */
 
   bn = MPFR_PREC2LIMBS (bq); /* number of limbs of b */
   cn = MPFR_PREC2LIMBS (cq); /* number of limbs of c */
@@ -303,7 +304,6 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   /* Check for no size_t overflow*/
   MPFR_ASSERTD ((size_t) k <= ((size_t) -1) / BYTES_PER_MP_LIMB);
   MPFR_TMP_MARK (marker);
-  tmp = MPFR_TMP_LIMBS_ALLOC (k);
 
   /* multiplies two mantissa in temporary allocated space */
   if (MPFR_UNLIKELY (bn < cn))
@@ -316,8 +316,11 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
       cn = zn;
     }
   MPFR_ASSERTD (bn >= cn);
+  /* mpfr_sqr calls mpfr_mul with b = c */
+  threshold = b != c ? MPFR_MUL_THRESHOLD : MPFR_SQR_THRESHOLD;
   if (MPFR_LIKELY (bn <= 2))
     {
+      tmp = MPFR_TMP_LIMBS_ALLOC (k);
       if (bn == 1)
         {
           /* 1 limb * 1 limb */
@@ -355,16 +358,50 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
       if (MPFR_UNLIKELY (b1 == 0))
         mpn_lshift (tmp, tmp, tn, 1); /* tn <= k, so no stack corruption */
     }
+  else if (bn > MPFR_LIMB_SIZE (a) + 1 && MPFR_LIMB_SIZE (a) < threshold)
+    {
+      /* The destination has fewer limbs than b (and maybe c):
+         multiply only the n most significant limbs of b and c, where
+         n = MPFR_LIMB_SIZE (a) + 1. Since the significands are in
+         [1/2, 1), the neglected parts of b and c are less than 2^(-nW)
+         each, thus the truncated product, which is a lower bound of the
+         exact product, differs from it by less than 2^(1-nW), i.e. it
+         has at least nW-2+b1 correct bits after the normalization.
+         For larger destinations, Mulders' mulhigh is used instead. */
+      mp_size_t n = MPFR_LIMB_SIZE (a) + 1, cn2 = MIN (cn, n);
+      mp_limb_t *tp = MPFR_TMP_LIMBS_ALLOC (n + cn2);
+
+      MPFR_LOG_MSG (("Use mpn_mul on truncated inputs\n", 0));
+      b1 = mpn_mul (tp, MPFR_MANT (b) + bn - n, n,
+                    MPFR_MANT (c) + cn - cn2, cn2);
+      b1 >>= GMP_NUMB_BITS - 1; /* msb from the product */
+      if (MPFR_UNLIKELY (b1 == 0))
+        mpn_lshift (tp, tp, n + cn2, 1);
+      /* with MPFR_RNDF, rounding to nearest is faithful since
+         PREC(a) <= nW - GMP_NUMB_BITS */
+      if (MPFR_UNLIKELY (rnd_mode != MPFR_RNDF &&
+                         !mpfr_round_p (tp, n + cn2,
+                                        n * GMP_NUMB_BITS - 2 + b1,
+                                        MPFR_PREC(a)
+                                        + (rnd_mode == MPFR_RNDN))))
+        {
+          tmp = MPFR_TMP_LIMBS_ALLOC (k);
+          goto full_multiply;
+        }
+      tmp = tp;
+      tq = (n + cn2) * GMP_NUMB_BITS;
+    }
   else
     /* Mulders' mulhigh. This code can also be used via mpfr_sqr,
        hence the tests b != c. */
-    if (MPFR_UNLIKELY (bn > (threshold = b != c ?
-                             MPFR_MUL_THRESHOLD : MPFR_SQR_THRESHOLD)))
+    if (MPFR_UNLIKELY (bn > threshold))
       {
         mp_limb_t *bp, *cp;
         mp_size_t n;
         mpfr_prec_t p;
 
+        tmp = MPFR_TMP_LIMBS_ALLOC (k);
+
         /* First check if we can reduce the precision of b or c:
            exact values are a nightmare for the short product trick */
         bp = MPFR_MANT (b);
@@ -498,8 +535,10 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
         MPFR_ASSERTD (MPFR_LIMB_MSB (tmp[tn-1]) != 0);
 
         /* if the most significant bit b1 is zero, we have only p-1 correct
-           bits */
-        if (MPFR_UNLIKELY (!mpfr_round_p (tmp, tn, p + b1 - 1, MPFR_PREC(a)
+           bits; with MPFR_RNDF, rounding to nearest is faithful since
+           PREC(a) <= p - 4, thus the error is at most 1/4 ulp */
+        if (MPFR_UNLIKELY (rnd_mode != MPFR_RNDF &&
+                           !mpfr_round_p (tmp, tn, p + b1 - 1, MPFR_PREC(a)
                                           + (rnd_mode == MPFR_RNDN))))
           {
             tmp -= k - tn; /* tmp may have changed, FIX IT!!!!! */
@@ -508,9 +547,22 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
       }
     else
       {
+        tmp = MPFR_TMP_LIMBS_ALLOC (k);
       full_multiply:
         MPFR_LOG_MSG (("Use mpn_mul\n", 0));
-        b1 = mpn_mul (tmp, MPFR_MANT (b), bn, MPFR_MANT (c), cn);
+        /* Skip the zero low limbs of b and c (e.g. small integers or dyadic
+           numbers stored in a large precision): the corresponding low limbs
+           of the product are zero. This loop ends since the most
+           significant limbs are non-zero. */
+        for (bz = 0; MPFR_MANT (b)[bz] == 0; bz++);
+        for (cz = 0; MPFR_MANT (c)[cz] == 0; cz++);
+        MPN_ZERO (tmp, bz + cz);
+        if (bn - bz >= cn - cz)
+          b1 = mpn_mul (tmp + bz + cz, MPFR_MANT (b) + bz, bn - bz,
+                        MPFR_MANT (c) + cz, cn - cz);
+        else
+          b1 = mpn_mul (tmp + bz + cz, MPFR_MANT (c) + cz, cn - cz,
+                        MPFR_MANT (b) + bz, bn - bz);
 
         /* now tmp[0]..tmp[k-1] contains the product of both mantissa,
            with tmp[k-1]>=2^(GMP_NUMB_BITS-2) */
@@ -525,7 +577,7 @@ mpfr_mul (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
       }
 
   ax2 = ax + (mpfr_exp_t) (b1 - 1);
-  MPFR_RNDRAW (inexact, a, tmp, bq+cq, rnd_mode, sign, ax2++);
+  MPFR_RNDRAW (inexact, a, tmp, tq, rnd_mode, sign, ax2++);
   MPFR_TMP_FREE (marker);
   MPFR_EXP  (a) = ax2; /* Can't use MPFR_SET_EXP: Expo may be out of range */
   MPFR_SET_SIGN (a, sign);
@@ -0,0 +1,166 @@
+/* mpfr_nrandom (rop, state, rnd_mode) -- Generate a normal deviate with mean 0
+   and variance 1 and round it to the precision of rop according to the given
+   rounding mode.
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* We use Karney's algorithm (C. F. F. Karney, Sampling exactly from the
+   normal distribution, ACM Trans. Math. Software 42(1), 2016, article 3,
+   http://arxiv.org/abs/1303.6257), which only needs random bits and
+   comparisons of uniform deviates, and returns the correct rounding of an
+   exact normal deviate: no logarithm, no square root and no Ziv loop. */
+
+/* Return true with probability exp(-1/2), by von Neumann's method: with
+   p1, p2, ... uniform deviates, the length of the longest decreasing
+   sequence 1/2 > p1 > p2 > ... is even with probability exp(-1/2). */
+static int
+H (mpfr_random_deviate_ptr p, mpfr_random_deviate_ptr q, gmp_randstate_t r)
+{
+  mpfr_random_deviate_reset (p);
+  if (mpfr_random_deviate_tstbit (p, 1, r))
+    return 1;  /* p > 1/2 */
+  for (;;)
+    {
+      mpfr_random_deviate_reset (q);
+      if (!mpfr_random_deviate_less (q, p, r))
+        return 0;
+      mpfr_random_deviate_reset (p);
+      if (!mpfr_random_deviate_less (p, q, r))
+        return 1;
+    }
+}
+
+/* Return k >= 0 with probability exp(-k/2) * (1 - exp(-1/2)). */
+static unsigned long
+G (mpfr_random_deviate_ptr p, mpfr_random_deviate_ptr q, gmp_randstate_t r)
+{
+  unsigned long k = 0;
+
+  while (H (p, q, r))
+    k++;
+  return k;
+}
+
+/* Return true with probability exp(-n/2). */
+static int
+P (unsigned long n, mpfr_random_deviate_ptr p, mpfr_random_deviate_ptr q,
+   gmp_randstate_t r)
+{
+  for (; n > 0; n--)
+    if (!H (p, q, r))
+      return 0;
+  return 1;
+}
+
+/* Return a uniform integer in [0, m), with 0 < m <= 2^32. */
+static unsigned long
+uniform_ui (unsigned long m, gmp_randstate_t r)
+{
+  mp_limb_t t;
+  int nb;
+
+  if (m == 1)
+    return 0;
+  nb = MPFR_INT_CEIL_LOG2 (m);
+  do
+    mpfr_rand_raw (&t, r, nb);
+  while (t >= m);
+  return t;
+}
+
+/* Return true with probability exp(-x(2k+x)/(2k+2)), using a generalized
+   von Neumann's method: the terms of the sequence x > z1 > z2 > ... are
+   uniform deviates, each one being accepted with probability
+   (k+z)/(k+1), so that the first n terms are decreasing and accepted with
+   probability g(x)^n/n!, where g(x) = x(2k+x)/(2k+2) is the integral of
+   (k+z)/(k+1) from 0 to x. The length of the sequence is then even with
+   probability exp(-g(x)). The deviates p, q and u are scratch space. */
+static int
+B (unsigned long k, mpfr_random_deviate_ptr x, mpfr_random_deviate_ptr p,
+   mpfr_random_deviate_ptr q, mpfr_random_deviate_ptr u, gmp_randstate_t r)
+{
+  mpfr_random_deviate_ptr y = x, z;
+  int even = 1;
+
+  for (;; even = !even)
+    {
+      z = y == p ? q : p;
+      mpfr_random_deviate_reset (z);
+      if (!mpfr_random_deviate_less (z, y, r))
+        break;
+      /* accept z with probability k/(k+1) + z/(k+1) */
+      if (uniform_ui (k + 1, r) == k)
+        {
+          mpfr_random_deviate_reset (u);
+          if (!mpfr_random_deviate_less (u, z, r))
+            break;
+        }
+      y = z;
+    }
+  return even;
+}
+
+int
+mpfr_nrandom (mpfr_ptr z, gmp_randstate_t r, mpfr_rnd_t rnd)
+{
+  mpfr_random_deviate_t x, p, q, u;
+  unsigned long k, j;
+  mp_limb_t s;
+  int inex;
+
+  mpfr_random_deviate_init (x);
+  mpfr_random_deviate_init (p);
+  mpfr_random_deviate_init (q);
+  mpfr_random_deviate_init (u);
+
+  for (;;)
+    {
+      /* k is drawn with probability proportional to exp(-k/2) and
+         accepted with probability exp(-k(k-1)/2), i.e., with probability
+         proportional to exp(-k^2/2) */
+      k = G (p, q, r);
+      /* k(k-1) cannot overflow in practice: the probability of
+         k >= 2^16 is about exp(-2^31) */
+      MPFR_ASSERTN (k < 65536);
+      if (!P (k * (k - 1), p, q, r))
+        continue;
+      /* then x is accepted with probability exp(-x(2k+x)/2), i.e., with
+         probability exp(-x(2k+x)/(2k+2)) for k+1 independent trials, so
+         that the density of k + x is proportional to exp(-(k+x)^2/2) */
+      mpfr_random_deviate_reset (x);
+      for (j = 0; j <= k && B (k, x, p, q, u, r); j++)
+        ;
+      if (j > k)
+        break;
+    }
+
+  mpfr_rand_raw (&s, r, 1);  /* the sign */
+  inex = mpfr_random_deviate_value (s & 1, k, x, z, r, rnd);
+
+  mpfr_random_deviate_clear (x);
+  mpfr_random_deviate_clear (p);
+  mpfr_random_deviate_clear (q);
+  mpfr_random_deviate_clear (u);
+  return inex;
+}
@@ -0,0 +1,552 @@
+/* mpfr_set_allocator_mode, mpfr_set_workspace, mpfr_pool_allocate,
+   mpfr_pool_free -- per-thread pool of memory blocks and workspace
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+/* In the MPFR_ALLOCATOR_POOL mode, the blocks given back by mpfr_clear,
+   mpfr_set_prec, MPFR_GROUP_CLEAR and the temporary allocations are kept
+   in free lists, one list per block size, and reused by the next requests
+   of the same size. These lists are thread-local (like the caches of the
+   constants), thus neither the allocations nor the frees take any lock.
+
+   A block is never resized: it is always given back to the GMP memory
+   functions with the size it was allocated with. Thus the blocks can go
+   from a mode to the other one, and from a thread to another one.
+
+   Only the significands can be freed by another thread than the one that
+   has allocated them. So that a thread that allocates numbers freed by
+   other threads (producer/consumer pattern) gets its blocks back, the
+   significands allocated in the pool mode are preceded by a pointer to
+   their owner, i.e. the record of the pool of the allocating thread, and
+   their allocated size is tagged with MPFR_ALLOC_OWNED. Another thread
+   pushes such a block to the "remote" list of the owner with a
+   compare-and-swap, without any lock, and the owner takes the whole list
+   with an atomic exchange (thus there is no ABA problem) when a free list
+   is empty. The records are taken from a static array when a thread uses
+   the pool mode for the first time, and given back by mpfr_pool_clear
+   (mpfr_free_cache must be called before a thread terminates), then they
+   can be taken by another thread: a block freed to a record that is not
+   used any longer is given back by the freeing thread, and the blocks
+   that remain in the remote list when a record is taken again are just
+   taken by its new owner. If there is no free record, or the compiler does
+   not provide the atomic builtins, the significands are not owned, and a
+   block freed by another thread goes to the lists of the latter.
+
+   The sizes that are cached are the multiples of the limb size up to
+   MPFR_POOL_SMALL limbs (the significands of mpfr_init2 and the groups),
+   and the powers of 2 from 2^MPFR_POOL_LARGE_MIN to 2^MPFR_POOL_LARGE_MAX
+   bytes (the large temporary allocations are rounded up to such a power
+   of 2). The number of blocks in each list is bounded, so that the memory
+   kept by a thread is bounded too.
+
+   When a workspace is bound by mpfr_set_workspace, it takes precedence over
+   both modes: the blocks are carved from the buffer provided by the caller
+   like in a stack, each one preceded by a header giving the offset of the
+   header of the previous block and the size of the block (with the bit 0
+   set once the block is freed). A freed block is reclaimed as soon as all
+   the blocks above it are freed too, which is the usual pattern (Ziv loops,
+   groups, temporary allocations). If the buffer is exhausted, MPFR aborts
+   instead of falling back to the GMP memory functions.
+
+   The significands of the mpfr_t numbers are allocated and freed by
+   mpfr_pool_allocate_mant and mpfr_pool_free_mant, which tag their
+   allocated size with MPFR_ALLOC_WORKSPACE when they are carved from a
+   workspace. Such a number can be cleared only by the thread that has
+   bound the workspace, while it is bound: this is checked with the tag,
+   since freeing the block with the GMP memory functions would be fatal.
+   The other blocks cannot go from a thread to another one. */
+
+#ifndef MPFR_POOL_SMALL
+# define MPFR_POOL_SMALL 128
+#endif
+#ifndef MPFR_POOL_SMALL_COUNT
+# define MPFR_POOL_SMALL_COUNT 32
+#endif
+#define MPFR_POOL_LARGE_MIN 11
+#define MPFR_POOL_LARGE_MAX 20
+#define MPFR_POOL_LARGE_COUNT 4
+#define MPFR_POOL_LISTS \
+  (MPFR_POOL_SMALL + 1 + MPFR_POOL_LARGE_MAX - MPFR_POOL_LARGE_MIN + 1)
+
+static MPFR_THREAD_ATTR int pool_mode = MPFR_ALLOCATOR_DEFAULT;
+static MPFR_THREAD_ATTR void *pool_head[MPFR_POOL_LISTS];
+static MPFR_THREAD_ATTR unsigned int pool_count[MPFR_POOL_LISTS];
+
+#if defined(MPFR_USE_THREAD_SAFE) && (__MPFR_GNUC(4,1) || __MPFR_ICC(11,0,0))
+# define MPFR_POOL_REMOTE
+#endif
+
+#ifndef MPFR_POOL_OWNERS
+# define MPFR_POOL_OWNERS 256
+#endif
+
+struct pool_owner
+{
+  void *volatile remote;  /* blocks freed by the other threads */
+  volatile int used;      /* non-zero while the record has an owner */
+};
+
+/* header of an owned significand, followed by the allocated size */
+typedef union
+{
+  struct pool_owner *o;
+  mp_limb_t l;
+} pool_owner_ptr;
+
+#define OWNED_SIZE(n) (sizeof (pool_owner_ptr) + MPFR_MALLOC_SIZE (n))
+
+#ifdef MPFR_POOL_REMOTE
+static struct pool_owner pool_owners[MPFR_POOL_OWNERS];
+static MPFR_THREAD_ATTR struct pool_owner *pool_self = NULL;
+static MPFR_THREAD_ATTR int pool_no_owner = 0;
+#endif
+
+typedef union
+{
+  struct
+  {
+    size_t prev;
+    size_t size;
+  } s;
+  mp_limb_t l;
+  double d;
+  void *p;
+} ws_header;
+
+#define WS_HEAD sizeof (ws_header)
+#define WS_NONE ((size_t) -1)
+#define WS_HDR(h) ((ws_header *) (ws_base + (h)))
+
+static MPFR_THREAD_ATTR char *ws_base = NULL;
+static MPFR_THREAD_ATTR size_t ws_size;  /* usable size of the buffer */
+static MPFR_THREAD_ATTR size_t ws_top;   /* offset of the first free byte */
+static MPFR_THREAD_ATTR size_t ws_last;  /* header of the last block */
+static MPFR_THREAD_ATTR size_t ws_peak;
+
+#define WS_CONTAINS(p) \
+  (ws_base != NULL && (char *) (p) >= ws_base                    \
+   && (char *) (p) < ws_base + ws_size)
+
+static void
+ws_exhausted (size_t size)
+{
+  fprintf (stderr, "MPFR: workspace exhausted (size=%lu, available=%lu)\n",
+           (unsigned long) size, (unsigned long) (ws_size - ws_top));
+  abort ();
+}
+
+/* Round size up to a multiple of WS_HEAD, so that all the blocks and
+   headers are suitably aligned. */
+static size_t
+ws_round (size_t size)
+{
+  return (size + (WS_HEAD - 1)) / WS_HEAD * WS_HEAD;
+}
+
+static void *
+ws_allocate (size_t size)
+{
+  size_t h = ws_top, r = ws_round (size);
+
+  if (ws_size - ws_top < WS_HEAD || ws_size - ws_top - WS_HEAD < r)
+    ws_exhausted (size);
+  WS_HDR (h)->s.prev = ws_last;
+  WS_HDR (h)->s.size = r;
+  ws_last = h;
+  ws_top = h + WS_HEAD + r;
+  if (ws_top > ws_peak)
+    ws_peak = ws_top;
+  return ws_base + h + WS_HEAD;
+}
+
+static void
+ws_free (void *p)
+{
+  ((ws_header *) p - 1)->s.size |= 1;
+  while (ws_last != WS_NONE && (WS_HDR (ws_last)->s.size & 1))
+    {
+      ws_top = ws_last;
+      ws_last = WS_HDR (ws_last)->s.prev;
+    }
+}
+
+/* The last block is resized in place. */
+static void *
+ws_reallocate (void *p, size_t old_size, size_t new_size)
+{
+  size_t h = (char *) p - ws_base - WS_HEAD, r;
+  void *q;
+
+  if (h == ws_last)
+    {
+      r = ws_round (new_size);
+      if (ws_size - h - WS_HEAD < r)
+        ws_exhausted (new_size);
+      WS_HDR (h)->s.size = r;
+      ws_top = h + WS_HEAD + r;
+      if (ws_top > ws_peak)
+        ws_peak = ws_top;
+      return p;
+    }
+  q = ws_allocate (new_size);
+  memcpy (q, p, MIN (old_size, new_size));
+  ws_free (p);
+  return q;
+}
+
+#ifdef MPFR_POOL_REMOTE
+
+/* Return the record of the current thread, taking a free one if need be,
+   or NULL if all of them are used. */
+static struct pool_owner *
+pool_owner (void)
+{
+  int i;
+
+  if (pool_self == NULL && pool_no_owner == 0)
+    {
+      for (i = 0; i < MPFR_POOL_OWNERS; i++)
+        if (pool_owners[i].used == 0
+            && __sync_bool_compare_and_swap (&pool_owners[i].used, 0, 1))
+          return pool_self = &pool_owners[i];
+      pool_no_owner = 1;  /* until the next mpfr_pool_clear */
+    }
+  return pool_self;
+}
+
+/* Push the owned block p (starting with its header) to the remote list of
+   its owner o. */
+static void
+pool_remote_push (struct pool_owner *o, void *p)
+{
+  void *h;
+
+  do
+    {
+      h = o->remote;
+      *(void **) p = h;
+    }
+  while (! __sync_bool_compare_and_swap (&o->remote, h, p));
+}
+
+/* Take all the blocks of the remote list of o, and free them in the
+   current thread. */
+static void
+pool_remote_drain (struct pool_owner *o)
+{
+  void *p, *q;
+
+  for (p = __sync_lock_test_and_set (&o->remote, (void *) NULL);
+       p != NULL; p = q)
+    {
+      q = *(void **) p;
+      mpfr_pool_free (p, OWNED_SIZE (((mpfr_size_limb_t *)
+                                      ((pool_owner_ptr *) p + 1))->s
+                                     & MPFR_ALLOC_SIZE_MASK));
+    }
+}
+
+#else
+# define pool_owner() ((struct pool_owner *) NULL)
+#endif
+
+/* Return the index of the free list for blocks of the given size,
+   or -1 if such blocks are not cached. */
+static int
+pool_index (size_t size)
+{
+  size_t n;
+  int k;
+
+  if (size % sizeof (mp_limb_t) != 0 || size < sizeof (void *))
+    return -1;
+  n = size / sizeof (mp_limb_t);
+  if (n <= MPFR_POOL_SMALL)
+    return n;
+  if ((size & (size - 1)) != 0)
+    return -1;
+  for (k = MPFR_POOL_LARGE_MIN; k <= MPFR_POOL_LARGE_MAX; k++)
+    if (size == (size_t) 1 << k)
+      return MPFR_POOL_SMALL + 1 + k - MPFR_POOL_LARGE_MIN;
+  return -1;
+}
+
+/* Return the size to request for a temporary block of at least size bytes
+   (a power of 2 that can be cached in the pool mode). */
+size_t
+mpfr_pool_round_size (size_t size)
+{
+  size_t s;
+
+  if (pool_mode == MPFR_ALLOCATOR_DEFAULT || ws_base != NULL
+      || size > (size_t) 1 << MPFR_POOL_LARGE_MAX)
+    return size;
+  for (s = (size_t) 1 << MPFR_POOL_LARGE_MIN; s < size; s <<= 1)
+    ;
+  return s;
+}
+
+void *
+mpfr_pool_allocate (size_t size)
+{
+  int i;
+  void *p;
+
+  if (ws_base != NULL)
+    return ws_allocate (size);
+  if (pool_mode != MPFR_ALLOCATOR_DEFAULT && (i = pool_index (size)) >= 0)
+    {
+#ifdef MPFR_POOL_REMOTE
+      if (pool_head[i] == NULL && pool_self != NULL
+          && pool_self->remote != NULL)
+        pool_remote_drain (pool_self);
+#endif
+      if (pool_head[i] != NULL)
+        {
+          p = pool_head[i];
+          pool_head[i] = *(void **) p;
+          pool_count[i]--;
+          return p;
+        }
+    }
+  return (*__gmp_allocate_func) (size);
+}
+
+void
+mpfr_pool_free (void *p, size_t size)
+{
+  int i;
+
+  if (WS_CONTAINS (p))
+    ws_free (p);
+  else if (pool_mode != MPFR_ALLOCATOR_DEFAULT
+           && (i = pool_index (size)) >= 0
+           && pool_count[i] < (i <= MPFR_POOL_SMALL ? MPFR_POOL_SMALL_COUNT
+                               : MPFR_POOL_LARGE_COUNT))
+    {
+      *(void **) p = pool_head[i];
+      pool_head[i] = p;
+      pool_count[i]++;
+    }
+  else
+    (*__gmp_free_func) (p, size);
+}
+
+void *
+mpfr_pool_reallocate (void *p, size_t old_size, size_t new_size)
+{
+  void *q;
+
+  if (WS_CONTAINS (p))
+    return ws_reallocate (p, old_size, new_size);
+  if (ws_base == NULL
+      && (pool_mode == MPFR_ALLOCATOR_DEFAULT
+          || (pool_index (old_size) < 0 && pool_index (new_size) < 0)))
+    return (*__gmp_reallocate_func) (p, old_size, new_size);
+
+  q = mpfr_pool_allocate (new_size);
+  memcpy (q, p, MIN (old_size, new_size));
+  mpfr_pool_free (p, old_size);
+  return q;
+}
+
+/* Return non-zero if the significands allocated now are owned. */
+#define POOL_OWNED_P() \
+  (pool_mode != MPFR_ALLOCATOR_DEFAULT && ws_base == NULL      \
+   && pool_owner () != NULL)
+
+/* Return a significand of n limbs, preceded by its allocated size. */
+mpfr_limb_ptr
+mpfr_pool_allocate_mant (mp_size_t n)
+{
+  mpfr_size_limb_t *p;
+
+  if (POOL_OWNED_P ())
+    {
+      pool_owner_ptr *b;
+
+      b = (pool_owner_ptr *) mpfr_pool_allocate (OWNED_SIZE (n));
+      b->o = pool_owner ();
+      p = (mpfr_size_limb_t *) (b + 1);
+      p->s = n | MPFR_ALLOC_OWNED;
+      return (mpfr_limb_ptr) (p + 1);
+    }
+  p = (mpfr_size_limb_t *) mpfr_pool_allocate (MPFR_MALLOC_SIZE (n));
+  p->s = WS_CONTAINS (p) ? n | MPFR_ALLOC_WORKSPACE : n;
+  return (mpfr_limb_ptr) (p + 1);
+}
+
+/* Resize the significand m to n limbs, keeping its contents. */
+mpfr_limb_ptr
+mpfr_pool_reallocate_mant (mpfr_limb_ptr m, mp_size_t n)
+{
+  mpfr_size_limb_t *p = (mpfr_size_limb_t *) m - 1;
+  mp_size_t old = p->s & MPFR_ALLOC_SIZE_MASK;
+  mpfr_limb_ptr q;
+
+  MPFR_ASSERTN (!(p->s & MPFR_ALLOC_WORKSPACE) || WS_CONTAINS (p));
+  if ((p->s & MPFR_ALLOC_OWNED) || POOL_OWNED_P ())
+    {
+      q = mpfr_pool_allocate_mant (n);
+      MPN_COPY (q, m, MIN (old, n));
+      mpfr_pool_free_mant (m);
+      return q;
+    }
+  p = (mpfr_size_limb_t *) mpfr_pool_reallocate
+    (p, MPFR_MALLOC_SIZE (old), MPFR_MALLOC_SIZE (n));
+  p->s = WS_CONTAINS (p) ? n | MPFR_ALLOC_WORKSPACE : n;
+  return (mpfr_limb_ptr) (p + 1);
+}
+
+void
+mpfr_pool_free_mant (mpfr_limb_ptr m)
+{
+  mpfr_size_limb_t *p = (mpfr_size_limb_t *) m - 1;
+
+  if (p->s & MPFR_ALLOC_WORKSPACE)
+    {
+      /* not the workspace of the current thread, or no longer bound */
+      MPFR_ASSERTN (WS_CONTAINS (p));
+      ws_free (p);
+    }
+#ifdef MPFR_POOL_REMOTE
+  else if (p->s & MPFR_ALLOC_OWNED)
+    {
+      pool_owner_ptr *b = (pool_owner_ptr *) p - 1;
+      struct pool_owner *o = b->o;
+
+      if (o == pool_self)
+        mpfr_pool_free (b, OWNED_SIZE (p->s & MPFR_ALLOC_SIZE_MASK));
+      else
+        {
+          pool_remote_push (o, b);
+          /* If the record has been released meanwhile, nobody may take
+             the block: the push and the release are full barriers, thus
+             either the releasing thread or this one sees the other. */
+          if (o->used == 0)
+            pool_remote_drain (o);
+        }
+    }
+#endif
+  else
+    mpfr_pool_free (p, MPFR_MALLOC_SIZE (p->s));
+}
+
+/* Give back all the blocks kept by the current thread. */
+void
+mpfr_pool_clear (void)
+{
+  int i, k;
+  size_t size;
+  void *p;
+
+#ifdef MPFR_POOL_REMOTE
+  if (pool_self != NULL)
+    {
+      struct pool_owner *o = pool_self;
+
+      /* Release the record, then take the blocks freed by the other
+         threads (see mpfr_pool_free_mant). */
+      pool_self = NULL;
+      __sync_bool_compare_and_swap (&o->used, 1, 0);
+      pool_remote_drain (o);
+    }
+  pool_no_owner = 0;
+#endif
+  for (i = 0; i < MPFR_POOL_LISTS; i++)
+    {
+      if (i <= MPFR_POOL_SMALL)
+        size = i * sizeof (mp_limb_t);
+      else
+        {
+          k = i - (MPFR_POOL_SMALL + 1) + MPFR_POOL_LARGE_MIN;
+          size = (size_t) 1 << k;
+        }
+      while (pool_head[i] != NULL)
+        {
+          p = pool_head[i];
+          pool_head[i] = *(void **) p;
+          (*__gmp_free_func) (p, size);
+        }
+      pool_count[i] = 0;
+    }
+}
+
+int
+mpfr_set_allocator_mode (int mode)
+{
+  int old = pool_mode;
+
+  pool_mode = mode == MPFR_ALLOCATOR_DEFAULT ? MPFR_ALLOCATOR_DEFAULT
+    : MPFR_ALLOCATOR_POOL;
+  if (pool_mode == MPFR_ALLOCATOR_DEFAULT)
+    mpfr_pool_clear ();
+  return old;
+}
+
+int
+mpfr_get_allocator_mode (void)
+{
+  return pool_mode;
+}
+
+/* Return non-zero if the blocks are allocated with mpfr_pool_allocate
+   instead of the GMP memory functions. */
+int
+mpfr_pool_enabled (void)
+{
+  return pool_mode != MPFR_ALLOCATOR_DEFAULT || ws_base != NULL;
+}
+
+/* Bind the buffer buf of size bytes as the workspace of the current thread
+   (or unbind the current workspace if buf is NULL). Return 0 on success,
+   and a non-zero value if a block of the current workspace is still in
+   use, in which case nothing is changed. */
+int
+mpfr_set_workspace (void *buf, size_t size)
+{
+  size_t a;
+
+  if (ws_base != NULL && ws_last != WS_NONE)
+    return 1;
+  if (buf == NULL)
+    {
+      ws_base = NULL;
+      return 0;
+    }
+  /* Align the beginning of the buffer. */
+  a = (WS_HEAD - (size_t) buf % WS_HEAD) % WS_HEAD;
+  ws_base = (char *) buf + MIN (a, size);
+  ws_size = (size - MIN (a, size)) / WS_HEAD * WS_HEAD;
+  ws_top = ws_peak = 0;
+  ws_last = WS_NONE;
+  return 0;
+}
+
+/* Return the maximum number of bytes of the current workspace that have
+   been used since it has been bound. */
+size_t
+mpfr_get_workspace_peak (void)
+{
+  return ws_base == NULL ? 0 : ws_peak;
+}
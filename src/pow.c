@@ -232,7 +232,9 @@ mpfr_pow_general (mpfr_ptr z, mpfr_srcptr x, mpfr_srcptr y,
             err = MPFR_GET_EXP (k);
           err++;
         }
-      MPFR_BLOCK (flags1, mpfr_exp (t, t, MPFR_RNDN));  /* exp(y*ln|x|)*/
+      /* one more bit since the exponential below is only faithful */
+      err++;
+      MPFR_BLOCK (flags1, mpfr_exp (t, t, MPFR_RNDF));  /* exp(y*ln|x|)*/
       /* We need to test */
       if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (t) || MPFR_UNDERFLOW (flags1)))
         {
@@ -245,9 +247,9 @@ mpfr_pow_general (mpfr_ptr z, mpfr_srcptr x, mpfr_srcptr y,
           /* Real underflow? */
           if (MPFR_IS_ZERO (t))
             {
-              /* Underflow. We computed rndn(exp(t)), where t >= y*ln|x|.
-                 Therefore rndn(|x|^y) = 0, and we have a real underflow on
-                 |x|^y. */
+              /* Underflow. With MPFR_RNDF, mpfr_exp returns 0 only when
+                 exp(t) < 2^(emin-2), where t >= y*ln|x|. Therefore
+                 rndn(|x|^y) = 0, and we have a real underflow on |x|^y. */
               inexact = mpfr_underflow (z, rnd_mode == MPFR_RNDN ? MPFR_RNDZ
                                         : rnd_mode, MPFR_SIGN_POS);
               if (expo != NULL)
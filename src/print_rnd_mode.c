@@ -40,6 +40,8 @@ mpfr_print_rnd_mode (mpfr_rnd_t rnd_mode)
       return "MPFR_RNDZ";
     case MPFR_RNDA:
       return "MPFR_RNDA";
+    case MPFR_RNDF:
+      return "MPFR_RNDF";
     default:
       return (const char*) 0;
     }
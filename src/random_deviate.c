@@ -0,0 +1,187 @@
+/* mpfr_random_deviate_* -- uniform random deviates whose bits are drawn
+   on demand, for the exact random samplers
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include "mpfr-impl.h"
+
+#define W MPFR_RANDOM_DEVIATE_W
+
+/* A deviate x represents the real number 0.b1b2b3... in (0,1), where the
+   bits b1, b2, ... are independent and uniformly distributed. Since two
+   deviates are almost surely different and x is almost surely not a
+   dyadic number, only finitely many bits are needed to compare two
+   deviates or to round n + x correctly: they are drawn from the random
+   state when needed, by chunks of W bits. */
+
+void
+mpfr_random_deviate_init (mpfr_random_deviate_ptr x)
+{
+  mpz_init (x->f);
+  x->e = 0;
+}
+
+void
+mpfr_random_deviate_clear (mpfr_random_deviate_ptr x)
+{
+  mpz_clear (x->f);
+}
+
+/* Return W random bits. */
+static unsigned long
+random_chunk (gmp_randstate_t r)
+{
+  mp_limb_t t;
+
+  mpfr_rand_raw (&t, r, W);
+  return (unsigned long) t;
+}
+
+/* Make sure that the first k bits of the fraction of x have been drawn. */
+static void
+random_deviate_generate (mpfr_random_deviate_ptr x, unsigned long k,
+                         gmp_randstate_t r)
+{
+  unsigned long n;
+
+  if (k <= x->e)
+    return;
+  if (x->e == 0)
+    {
+      x->h = random_chunk (r);
+      x->e = W;
+      mpz_set_ui (x->f, 0);
+      if (k <= W)
+        return;
+    }
+  /* draw the next n bits, with n a multiple of W */
+  n = (k - x->e + (W - 1)) / W * W;
+  if (n == W)
+    {
+      mpz_mul_2exp (x->f, x->f, W);
+      mpz_add_ui (x->f, x->f, random_chunk (r));
+    }
+  else
+    {
+      mpz_t t;
+
+      mpz_init (t);
+      mpz_urandomb (t, r, n);
+      mpz_mul_2exp (x->f, x->f, n);
+      mpz_add (x->f, x->f, t);
+      mpz_clear (t);
+    }
+  x->e += n;
+}
+
+/* Return bit k >= 1 of the fraction of x, i.e., the bit of weight 2^(-k). */
+int
+mpfr_random_deviate_tstbit (mpfr_random_deviate_ptr x, unsigned long k,
+                            gmp_randstate_t r)
+{
+  MPFR_ASSERTD (k >= 1);
+  random_deviate_generate (x, k, r);
+  if (k <= W)
+    return (x->h >> (W - k)) & 1;
+  return mpz_tstbit (x->f, x->e - k);
+}
+
+/* Return non-zero iff x < y, where x and y are distinct objects. */
+int
+mpfr_random_deviate_less (mpfr_random_deviate_ptr x,
+                          mpfr_random_deviate_ptr y, gmp_randstate_t r)
+{
+  unsigned long k;
+  int a, b;
+
+  MPFR_ASSERTD (x != y);
+  random_deviate_generate (x, W, r);
+  random_deviate_generate (y, W, r);
+  if (x->h != y->h)
+    return x->h < y->h;
+  for (k = W + 1; ; k++)
+    {
+      a = mpfr_random_deviate_tstbit (x, k, r);
+      b = mpfr_random_deviate_tstbit (y, k, r);
+      if (a != b)
+        return a < b;
+    }
+}
+
+/* Set z to (-1)^neg * (n + x) rounded in the direction rnd, and return
+   the ternary value, which is never zero (except possibly for MPFR_RNDF).
+
+   Let k be such that the bits of n + x of weight at least 2^(-k) contain
+   the significant bits of the result and the rounding bit. The rounding
+   boundaries are then multiples of 2^(-k), thus n + x rounds like any
+   number of the open interval (t, t + 2^(-k)) that contains it, where t
+   is formed by the bits of n + x up to 2^(-k): we round t + 2^(-k-1). */
+int
+mpfr_random_deviate_value (int neg, unsigned long n,
+                           mpfr_random_deviate_ptr x, mpfr_ptr z,
+                           gmp_randstate_t r, mpfr_rnd_t rnd)
+{
+  mpfr_prec_t p = MPFR_PREC (z);
+  unsigned long k, l, m;
+  int nb, inex;
+  mpz_t t;
+
+  if (n == 0)
+    {
+      /* the leading bit of the result is the first 1 bit of x */
+      for (l = 1; !mpfr_random_deviate_tstbit (x, l, r); l++)
+        ;
+      k = l + p;
+    }
+  else
+    {
+      for (nb = 0, m = n; m != 0; m >>= 1)
+        nb++;
+      k = p + 1 > nb ? p + 1 - nb : 0;
+    }
+
+  mpz_init_set_ui (t, n);
+  if (k > 0)
+    {
+      random_deviate_generate (x, k, r);
+      l = MIN (k, W);
+      mpz_mul_2exp (t, t, l);
+      mpz_add_ui (t, t, x->h >> (W - l));
+      if (k > W)
+        {
+          mpz_t u;
+
+          mpz_init (u);
+          mpz_fdiv_q_2exp (u, x->f, x->e - k);
+          mpz_mul_2exp (t, t, k - W);
+          mpz_add (t, t, u);
+          mpz_clear (u);
+        }
+    }
+  mpz_mul_2exp (t, t, 1);
+  mpz_add_ui (t, t, 1);
+  if (neg)
+    mpz_neg (t, t);
+  inex = mpfr_set_z_2exp (z, t, - (mpfr_exp_t) (k + 1), rnd);
+  mpz_clear (t);
+  MPFR_ASSERTD (inex != 0 || rnd == MPFR_RNDF);
+  return inex;
+}
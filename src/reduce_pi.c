@@ -0,0 +1,218 @@
+/* mpfr_reduce_pi2 -- argument reduction modulo Pi/2
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* Reducing x modulo Pi/2 with mpfr_remquo needs Pi to EXP(x) + p bits and
+   a division of that size, for a target precision p. For huge x we use the
+   Payne-Hanek reduction instead: we multiply x by the bits of 2/Pi whose
+   weight matters modulo 4. The bits of 2/Pi are computed once and kept in
+   a cache, so that the cost of the reduction only depends on PREC(x) and p. */
+
+/* Declare the cache */
+MPFR_DECL_INIT_CACHE(__gmpfr_cache_const_two_over_pi,
+                     mpfr_const_two_over_pi_internal);
+
+/* Set x to 2/Pi rounded according to rnd_mode.
+   Don't need to save/restore exponent range: the callers do it. */
+int
+mpfr_const_two_over_pi_internal (mpfr_ptr x, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t t;
+  mpfr_prec_t px, w;
+  int inex;
+  MPFR_ZIV_DECL (loop);
+
+  px = MPFR_PREC (x);
+  w = px + MPFR_INT_CEIL_LOG2 (px) + 10;
+
+  mpfr_init2 (t, w);
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      mpfr_const_pi (t, MPFR_RNDN);     /* relative error <= 2^(-w) */
+      mpfr_ui_div (t, 2, t, MPFR_RNDN); /* 1/2 < t < 1, error < 2 ulps */
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, w - 1, px, rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (t, w);
+    }
+  MPFR_ZIV_FREE (loop);
+  inex = mpfr_set (x, t, rnd_mode);
+  mpfr_clear (t);
+  return inex;
+}
+
+/* Return the cached value of 2/Pi, to at least p bits and rounded to
+   nearest. Contrary to mpfr_cache, the cached value is not rounded to a
+   destination, since the callers only read a window of its bits. */
+static mpfr_srcptr
+two_over_pi (mpfr_prec_t p)
+{
+  mpfr_cache_ptr cache = __gmpfr_cache_const_two_over_pi;
+  mpfr_prec_t pold = MPFR_PREC (cache->x);
+
+  if (MPFR_UNLIKELY (p > pold))
+    {
+      /* Grow geometrically, so that a sequence of increasing exponents
+         does not recompute 2/Pi at each call. */
+      if (pold / 2 <= MPFR_PREC_MAX - p)
+        p += pold / 2;
+      if (MPFR_UNLIKELY (pold == 0))
+        mpfr_init2 (cache->x, p);
+      else
+        mpfr_set_prec (cache->x, p);
+      cache->inexact = mpfr_const_two_over_pi_internal (cache->x, MPFR_RNDN);
+    }
+  return cache->x;
+}
+
+/* Assuming x is a regular number, compute z and sh such that
+   0 <= z < 2^(sh+2) and |x*2/Pi - z/2^sh - 4k| < 2^(-w) for some integer k.
+   Return sh. */
+static mpfr_prec_t
+reduce_aux (mpz_ptr z, mpfr_srcptr x, mpfr_prec_t w)
+{
+  mpz_t W;
+  mpfr_srcptr T;
+  mpfr_exp_t e, expx;
+  mpfr_prec_t L, K;
+  mp_size_t n, s, ns;
+  mp_limb_t *wp;
+  int c;
+
+  expx = MPFR_GET_EXP (x);
+  MPFR_ASSERTN (expx + w + 1 <= MPFR_PREC_MAX);
+  e = mpfr_get_z_2exp (z, x); /* x = z*2^e with |z| < 2^(expx-e) */
+
+  /* Write T = 2/Pi as T_hi + T_mid + T_lo, where T_hi only has bits of
+     weight >= 2^(2-e), so that z*2^e*T_hi is a multiple of 4, and
+     0 <= T_lo < 2^(-L). Then x*T = z*2^e*T_mid + z*2^e*T_lo mod 4, where
+     |z*2^e*T_lo| < 2^(expx-L). The cached value of T is rounded to nearest
+     on at least L bits, which adds an error < 2^(expx-L-1). Thus with
+     L = expx + w + 1, the total error is less than 2^(-w). */
+  L = expx + w + 1;
+  T = two_over_pi (L);
+
+  /* T_mid consists of the K bits of weight 2^(1-e) down to 2^(-L); if e <= 2
+     this is the whole of T, since T < 1. */
+  K = (e <= 2) ? L : L + 2 - e;
+
+  /* Extract floor(T*2^L) mod 2^K from the significand of T. Its bit of
+     weight 2^(-L) has index n*GMP_NUMB_BITS - L. */
+  n = MPFR_LIMB_SIZE (T);
+  s = (n * GMP_NUMB_BITS - L) / GMP_NUMB_BITS;
+  c = (n * GMP_NUMB_BITS - L) % GMP_NUMB_BITS;
+  ns = (c + K - 1) / GMP_NUMB_BITS + 1;
+  if (ns > n - s)
+    ns = n - s;
+  mpz_init (W);
+  wp = MPZ_REALLOC (W, ns);
+  if (c != 0)
+    mpn_rshift (wp, MPFR_MANT (T) + s, ns, c);
+  else
+    MPN_COPY (wp, MPFR_MANT (T) + s, ns);
+  MPN_NORMALIZE (wp, ns);
+  SIZ (W) = ns;
+  mpz_fdiv_r_2exp (W, W, K);
+
+  /* x*T = z*W*2^(e-L) mod 4 */
+  mpz_mul (z, z, W);
+  mpz_clear (W);
+  mpz_fdiv_r_2exp (z, z, L - e + 2);
+  return L - e;
+}
+
+/* Put in r the value z*Pi/2^sh, rounded to nearest. */
+static void
+mul_pi_2exp (mpfr_ptr r, mpz_srcptr z, mpfr_prec_t sh, mpfr_prec_t w)
+{
+  mpfr_t u, pi;
+
+  mpfr_init2 (u, w);
+  mpfr_init2 (pi, w);
+  mpfr_set_z (u, z, MPFR_RNDN);
+  mpfr_const_pi (pi, MPFR_RNDN);
+  mpfr_mul (u, u, pi, MPFR_RNDN);
+  mpfr_div_2ui (u, u, sh, MPFR_RNDN);
+  mpfr_set (r, u, MPFR_RNDN);
+  mpfr_clear (u);
+  mpfr_clear (pi);
+}
+
+/* Reduce x modulo Pi/2: put in r an approximation of x - q*Pi/2 - 2k*Pi,
+   where k is an integer and q is the return value in [0, 3], such that
+   |r| <= Pi/4 up to the error. The error on r is at most 2^(1-PREC(r)).
+   Assumes x is a regular number, and that the exponent range has been
+   extended. */
+int
+mpfr_reduce_pi2 (mpfr_ptr r, mpfr_srcptr x)
+{
+  mpz_t z, h;
+  mpfr_prec_t w, sh;
+  int q;
+
+  if (MPFR_GET_EXP (x) < MPFR_REDUCE_THRESHOLD)
+    {
+      mpfr_t pi;
+      long ql;
+
+      w = MPFR_PREC (r);
+      mpfr_init2 (pi, (MPFR_GET_EXP (x) > 0) ? w + MPFR_GET_EXP (x) : w);
+      mpfr_const_pi (pi, MPFR_RNDN);
+      mpfr_div_2ui (pi, pi, 1, MPFR_RNDN); /* Pi/2 */
+      mpfr_remquo (r, &ql, x, pi, MPFR_RNDN);
+      mpfr_clear (pi);
+      /* x = q * (Pi/2 + eps1) + r + eps2,
+         where |eps1| <= 1/2*ulp(Pi/2) = 2^(-w-MAX(0,EXP(x))),
+         and eps2 <= 1/2*ulp(r) <= 1/2*ulp(Pi/2) = 2^(-w)
+         Since |q| <= x/(Pi/2) <= |x|, we have
+         q*|eps1| <= 2^(-w), thus
+         |x - q * Pi/2 - r| <= 2^(1-w) */
+      return (int) (ql & 3);
+    }
+
+  /* The errors are: 2^(-w)*Pi/2 from reduce_aux, 2^(-w-1)*Pi/2 from the
+     conversion of z, 2^(-w-1) from Pi, 2^(-w-1) for the product, and
+     2^(-PREC(r)-1) for the final rounding since |r| <= 1. With w = PREC(r)+2,
+     this is less than 2^(1-PREC(r)). */
+  w = MPFR_PREC (r) + 2;
+  mpz_init (z);
+  sh = reduce_aux (z, x, w);
+
+  /* q is the nearest integer to z/2^sh, modulo 4 */
+  q = 2 * mpz_tstbit (z, sh + 1) + mpz_tstbit (z, sh);
+  mpz_fdiv_r_2exp (z, z, sh);
+  if (mpz_tstbit (z, sh - 1))
+    {
+      q = (q + 1) & 3;
+      mpz_init (h);
+      mpz_setbit (h, sh);
+      mpz_sub (z, z, h);
+      mpz_clear (h);
+    }
+
+  mul_pi_2exp (r, z, sh + 1, w);
+  mpz_clear (z);
+  return q;
+}
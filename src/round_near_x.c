@@ -162,6 +162,9 @@ mpfr_round_near_x (mpfr_ptr y, mpfr_srcptr v, mpfr_uexp_t err, int dir,
   MPFR_ASSERTD (!MPFR_IS_SINGULAR (v));
   MPFR_ASSERTD (dir == 0 || dir == 1);
 
+  if (rnd == MPFR_RNDF)
+    rnd = MPFR_RNDN;
+
   /* First check if we can round. The test is more restrictive than
      necessary. Note that if err is not representable in an mpfr_exp_t,
      then err > MPFR_PREC (v) and the conversion to mpfr_exp_t will not
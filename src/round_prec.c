@@ -68,12 +68,8 @@ mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd_mode)
       ow = MPFR_GET_ALLOC_SIZE(x);
       if (nw > ow)
        {
-         /* Realloc significand */
-         mpfr_limb_ptr tmpx = (mpfr_limb_ptr) (*__gmp_reallocate_func)
-           (MPFR_GET_REAL_PTR(x), MPFR_MALLOC_SIZE(ow), MPFR_MALLOC_SIZE(nw));
-         MPFR_SET_MANT_PTR(x, tmpx); /* mant ptr must be set
-                                        before alloc size */
-         MPFR_SET_ALLOC_SIZE(x, nw); /* new number of allocated limbs */
+         /* Realloc significand (this also sets the new alloc size) */
+         MPFR_MANT(x) = mpfr_pool_reallocate_mant (MPFR_MANT(x), nw);
        }
     }
 
@@ -121,7 +117,9 @@ mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd_mode)
 
 /* assuming b is an approximation to x in direction rnd1 with error at
    most 2^(MPFR_EXP(b)-err), returns 1 if one is able to round exactly
-   x to precision prec with direction rnd2, and 0 otherwise.
+   x to precision prec with direction rnd2, and 0 otherwise. For
+   rnd2 = MPFR_RNDF, returns 1 if rounding b to nearest in precision prec
+   gives a faithful rounding of x.
 
    Side effects: none.
 */
@@ -150,6 +148,10 @@ mpfr_can_round_raw (const mp_limb_t *bp, mp_size_t bn, int neg, mpfr_exp_t err0,
 
   if (MPFR_UNLIKELY(err0 < 0 || (mpfr_uexp_t) err0 <= prec))
     return 0;  /* can't round */
+  else if (rnd2 == MPFR_RNDF)
+    /* an error of at most 1/4 ulp ensures that rounding to nearest gives
+       a faithful result */
+    return (mpfr_uexp_t) err0 - 2 >= prec;
   else if (MPFR_UNLIKELY (prec > (mpfr_prec_t) bn * GMP_NUMB_BITS))
     { /* then ulp(b) < precision < error */
       return rnd2 == MPFR_RNDN && (mpfr_uexp_t) err0 - 2 >= prec;
@@ -190,10 +192,13 @@ mpfr_can_round_raw (const mp_limb_t *bp, mp_size_t bn, int neg, mpfr_exp_t err0,
 
   MPFR_ASSERTD (k > 0);
 
-  /* Transform RNDD and RNDU to Zero / Away */
+  /* Transform RNDD and RNDU to Zero / Away, and RNDF to RNDN since the
+     error can then be in both directions */
   MPFR_ASSERTD((neg == 0) || (neg ==1));
   if (MPFR_IS_RNDUTEST_OR_RNDDNOTTEST(rnd1, neg))
     rnd1 = MPFR_RNDZ;
+  else if (rnd1 == MPFR_RNDF)
+    rnd1 = MPFR_RNDN;
 
   switch (rnd1)
     {
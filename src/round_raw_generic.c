@@ -76,6 +76,9 @@ mpfr_round_raw_generic(
     MPFR_ASSERTD(inexp != ((int*) 0));
   MPFR_ASSERTD(neg == 0 || neg == 1);
 
+  if (rnd_mode == MPFR_RNDF)
+    rnd_mode = MPFR_RNDN;
+
   if (flag && !use_inexp &&
       (xprec <= yprec || MPFR_IS_LIKE_RNDZ (rnd_mode, neg)))
     return 0;
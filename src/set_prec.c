@@ -26,7 +26,6 @@ void
 mpfr_set_prec (mpfr_ptr x, mpfr_prec_t p)
 {
   mp_size_t xsize, xoldsize;
-  mpfr_limb_ptr tmp;
 
   /* first, check if p is correct */
   MPFR_ASSERTN (p >= MPFR_PREC_MIN && p <= MPFR_PREC_MAX);
@@ -37,12 +36,7 @@ mpfr_set_prec (mpfr_ptr x, mpfr_prec_t p)
   /* Realloc only if the new size is greater than the old */
   xoldsize = MPFR_GET_ALLOC_SIZE (x);
   if (xsize > xoldsize)
-    {
-      tmp = (mpfr_limb_ptr) (*__gmp_reallocate_func)
-        (MPFR_GET_REAL_PTR(x), MPFR_MALLOC_SIZE(xoldsize), MPFR_MALLOC_SIZE(xsize));
-      MPFR_SET_MANT_PTR(x, tmp);
-      MPFR_SET_ALLOC_SIZE(x, xsize);
-    }
+    MPFR_MANT(x) = mpfr_pool_reallocate_mant (MPFR_MANT(x), xsize);
   MPFR_PREC (x) = p;
   MPFR_SET_NAN (x); /* initializes to NaN */
 }
@@ -23,54 +23,12 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
-/*
- * Set f to z, choosing the smallest precision for f
- * so that z = f*(2^BPML)*zs*2^(RetVal)
- */
-static int
-set_z (mpfr_ptr f, mpz_srcptr z, mp_size_t *zs)
-{
-  mp_limb_t *p;
-  mp_size_t s;
-  int c;
-  mpfr_prec_t pf;
-
-  MPFR_ASSERTD (mpz_sgn (z) != 0);
-
-  /* Remove useless ending 0 */
-  for (p = PTR (z), s = *zs = ABS (SIZ (z)) ; *p == 0; p++, s--)
-    MPFR_ASSERTD (s >= 0);
-
-  /* Get working precision */
-  count_leading_zeros (c, p[s-1]);
-  pf = s * GMP_NUMB_BITS - c;
-  if (pf < MPFR_PREC_MIN)
-    pf = MPFR_PREC_MIN;
-  mpfr_init2 (f, pf);
-
-  /* Copy Mantissa */
-  if (MPFR_LIKELY (c))
-    mpn_lshift (MPFR_MANT (f), p, s, c);
-  else
-    MPN_COPY (MPFR_MANT (f), p, s);
-
-  MPFR_SET_SIGN (f, mpz_sgn (z));
-  MPFR_SET_EXP (f, 0);
-
-  return -c;
-}
-
-/* set f to the rational q */
+/* set f to the rational q, with a single division of the limbs of the
+   numerator (shifted or truncated) by those of the denominator */
 int
 mpfr_set_q (mpfr_ptr f, mpq_srcptr q, mpfr_rnd_t rnd)
 {
   mpz_srcptr num, den;
-  mpfr_t n, d;
-  int inexact;
-  int cn, cd;
-  long shift;
-  mp_size_t sn, sd;
-  MPFR_SAVE_EXPO_DECL (expo);
 
   num = mpq_numref (q);
   den = mpq_denref (q);
@@ -96,38 +54,87 @@ mpfr_set_q (mpfr_ptr f, mpq_srcptr q, mpfr_rnd_t rnd)
       MPFR_RET (0);
     }
 
-  MPFR_SAVE_EXPO_MARK (expo);
-
-  cn = set_z (n, num, &sn);
-  cd = set_z (d, den, &sd);
+  return mpfr_set_z_div_2exp (f, num, den, 0, rnd);
+}
 
-  sn -= sd;
-  if (MPFR_UNLIKELY (sn > MPFR_EMAX_MAX / GMP_NUMB_BITS))
+/* Set y to RND(n/d*2^e), where n and d are nonzero integers, with a single
+   division of the (shifted or truncated) limbs of |n| by those of |d|.
+   The quotient has at least PREC(y)+2 bits; when the division is inexact,
+   its least significant bit is set to 1 (sticky bit), which does not change
+   the rounding. The flags are set by mpfr_set_z_2exp. */
+int
+mpfr_set_z_div_2exp (mpfr_ptr y, mpz_srcptr n, mpz_srcptr d, mpfr_exp_t e,
+                     mpfr_rnd_t rnd)
+{
+  mpz_t q;
+  mp_limb_t *np, *qp, *rp;
+  mp_size_t nn, dn, tn, qn, k, i;
+  mpfr_exp_t s;
+  int cn, cd, sh, sticky, inex;
+  MPFR_TMP_DECL (marker);
+
+  MPFR_ASSERTD (mpz_sgn (n) != 0 && mpz_sgn (d) != 0);
+
+  nn = ABS (SIZ (n));
+  dn = ABS (SIZ (d));
+  count_leading_zeros (cn, PTR (n)[nn - 1]);
+  count_leading_zeros (cd, PTR (d)[dn - 1]);
+  /* s = PREC(y) + 2 - (bits(n) - bits(d)), so that floor(|n|*2^s/|d|)
+     has at least PREC(y) + 2 bits */
+  s = (mpfr_exp_t) MPFR_PREC (y) + 2
+    - ((mpfr_exp_t) (nn - dn) * GMP_NUMB_BITS - cn + cd);
+
+  MPFR_TMP_MARK (marker);
+  sticky = 0;
+  if (s >= 0)
     {
-      inexact = mpfr_overflow (f, rnd, MPFR_SIGN (f));
-      goto end;
+      k = s / GMP_NUMB_BITS;
+      sh = s % GMP_NUMB_BITS;
+      tn = nn + k + 1;
+      np = MPFR_TMP_LIMBS_ALLOC (tn);
+      MPN_ZERO (np, k);
+      if (sh != 0)
+        np[tn - 1] = mpn_lshift (np + k, PTR (n), nn, sh);
+      else
+        {
+          MPN_COPY (np + k, PTR (n), nn);
+          np[tn - 1] = 0;
+        }
     }
-  if (MPFR_UNLIKELY (sn < MPFR_EMIN_MIN / GMP_NUMB_BITS -1))
+  else
     {
-      if (rnd == MPFR_RNDN)
-        rnd = MPFR_RNDZ;
-      inexact = mpfr_underflow (f, rnd, MPFR_SIGN (f));
-      goto end;
+      /* the low -s bits of |n| are truncated, with -s < bits(n) */
+      k = (-s) / GMP_NUMB_BITS;
+      sh = (-s) % GMP_NUMB_BITS;
+      for (i = 0; i < k && sticky == 0; i++)
+        sticky = PTR (n)[i] != 0;
+      if (sh != 0 && (PTR (n)[k] & MPFR_LIMB_MASK (sh)) != 0)
+        sticky = 1;
+      tn = nn - k;
+      np = MPFR_TMP_LIMBS_ALLOC (tn);
+      if (sh != 0)
+        mpn_rshift (np, PTR (n) + k, tn, sh);
+      else
+        MPN_COPY (np, PTR (n) + k, tn);
     }
-
-  inexact = mpfr_div (f, n, d, rnd);
-  shift = GMP_NUMB_BITS*sn+cn-cd;
-  MPFR_ASSERTD (shift == GMP_NUMB_BITS*sn+cn-cd);
-  cd = mpfr_mul_2si (f, f, shift, rnd);
-  MPFR_SAVE_EXPO_FREE (expo);
-  if (MPFR_UNLIKELY (cd != 0))
-    inexact = cd;
-  else
-    inexact = mpfr_check_range (f, inexact, rnd);
- end:
-  mpfr_clear (d);
-  mpfr_clear (n);
-  return inexact;
+  while (np[tn - 1] == 0)
+    tn--;
+  MPFR_ASSERTD (tn >= dn);
+
+  qn = tn - dn + 1;
+  qp = MPFR_TMP_LIMBS_ALLOC (qn + dn);
+  rp = qp + qn;
+  mpn_tdiv_qr (qp, rp, 0, np, tn, PTR (d), dn);
+  for (i = 0; i < dn && sticky == 0; i++)
+    sticky = rp[i] != 0;
+  qp[0] |= sticky;
+  while (qp[qn - 1] == 0)
+    qn--;
+
+  ALLOC (q) = qn;
+  SIZ (q) = mpz_sgn (n) * mpz_sgn (d) > 0 ? qn : -qn;
+  PTR (q) = qp;
+  inex = mpfr_set_z_2exp (y, q, e - s, rnd);
+  MPFR_TMP_FREE (marker);
+  return inex;
 }
-
-
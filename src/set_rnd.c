@@ -28,7 +28,7 @@ mpfr_rnd_t MPFR_THREAD_ATTR __gmpfr_default_rounding_mode = MPFR_RNDN;
 void
 mpfr_set_default_rounding_mode (mpfr_rnd_t rnd_mode)
 {
-  if (rnd_mode >= MPFR_RNDN && rnd_mode < MPFR_RND_MAX)
+  if (rnd_mode >= MPFR_RNDN && rnd_mode <= MPFR_RNDF)
     __gmpfr_default_rounding_mode = rnd_mode;
 }
 
@@ -33,16 +33,71 @@ mpfr_sin_fast (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   return (inex == 2) ? -1 : inex;
 }
 
+/* Put in s an approximation of sin(x), assuming 0 < |x| < 1, which holds
+   in particular when x has been reduced to [-Pi/4, Pi/4] by mpfr_reduce_pi2.
+   Contrary to sin(x) = sqrt(1 - cos(x)^2), there is no cancellation for
+   small x: we use the series of sin(y)/y for y = x/3^K, and then K times
+   the formula sin(3y) = sin(y) * (3 - 4 sin(y)^2).
+   Return e such that |s - sin(x)| <= 2^e ulp(s). */
+int
+mpfr_sin_reduced (mpfr_ptr s, mpfr_srcptr x)
+{
+  mpfr_prec_t m;
+  mpfr_t y, t;
+  mpz_t z;
+  unsigned long K, k;
+  int e;
+
+  MPFR_ASSERTD (MPFR_IS_PURE_FP (x) && MPFR_NOTZERO (x));
+  MPFR_ASSERTD (MPFR_GET_EXP (x) <= 0);
+
+  m = MPFR_PREC (s);
+  /* each tripling saves about log2(9) bits in the series */
+  K = __gmpfr_isqrt (m / 6) + 1;
+
+  mpfr_init2 (y, m);
+  mpfr_init2 (t, m);
+  mpz_init (z);
+  mpz_ui_pow_ui (z, 3, K);
+  mpfr_div_z (y, x, z, MPFR_RNDN);  /* relative error <= 2^(-m) */
+  mpz_clear (z);
+  mpfr_sqr (t, y, MPFR_RNDN);       /* t <= 1/9 */
+  e = mpfr_sincos2_aux (s, t, 2);   /* s ~ sin(y)/y with s >= 1/2 */
+  mpfr_mul (s, s, y, MPFR_RNDN);
+  /* The relative error on s is at most (2^e + 3)*2^(-m) <= 2^(e+2-m),
+     where the error on t contributes less than 2^(-m-2) since the
+     derivative of sin(y)/y wrt y^2 is less than 1/6 in absolute value. */
+
+  for (k = 0; k < K; k++)
+    {
+      /* If s = sin(y)*(1+eps), the relative error on s*(3-4s^2) with respect
+         to sin(3y) is eps*(3-12sin(y)^2)/(3-4sin(y)^2) + O(eps^2), where
+         sin(y)^2 <= sin(1/3)^2 < 1/2, thus at most 3*eps + O(eps^2). The
+         three roundings below add at most 4*2^(-m): the relative error is
+         multiplied by at most 4 at each step. */
+      mpfr_sqr (t, s, MPFR_RNDN);
+      mpfr_mul_2ui (t, t, 2, MPFR_RNDN);
+      mpfr_ui_sub (t, 3, t, MPFR_RNDN); /* 1 <= t <= 3 */
+      mpfr_mul (s, s, t, MPFR_RNDN);
+    }
+  mpfr_clear (y);
+  mpfr_clear (t);
+
+  /* the relative error is at most 2^(e+2+2K-m), and |sin(x)| < 2^EXP(s) */
+  return e + 2 + 2 * K;
+}
+
 int
 mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
   mpfr_t c, xr;
   mpfr_srcptr xx;
-  mpfr_exp_t expx, err;
-  mpfr_prec_t precy, m;
-  int inexact, sign, reduce;
+  mpfr_exp_t expx, err, expc, cancel = 0;
+  mpfr_prec_t precy, m, K0;
+  int inexact, reduce, q;
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_GROUP_DECL (group);
 
   MPFR_LOG_FUNC
     (("x[%Pu]=%.*Rg rnd=%d", mpfr_get_prec (x), mpfr_log_prec, x, rnd_mode),
@@ -69,104 +124,86 @@ mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   MPFR_FAST_COMPUTE_IF_SMALL_INPUT (y, x, -2 * MPFR_GET_EXP (x), 2, 0,
                                     rnd_mode, {});
 
-  MPFR_SAVE_EXPO_MARK (expo);
-
   /* Compute initial precision */
   precy = MPFR_PREC (y);
 
+  MPFR_SAVE_EXPO_MARK (expo);
+
   if (precy >= MPFR_SINCOS_THRESHOLD)
-    return mpfr_sin_fast (y, x, rnd_mode);
+    {
+      /* the argument reduction needs the extended exponent range */
+      inexact = mpfr_sin_fast (y, x, rnd_mode);
+      MPFR_SAVE_EXPO_FREE (expo);
+      return mpfr_check_range (y, inexact, rnd_mode);
+    }
 
-  m = precy + MPFR_INT_CEIL_LOG2 (precy) + 13;
+  K0 = __gmpfr_isqrt (precy / 3);
+  m = precy + 2 * MPFR_INT_CEIL_LOG2 (precy) + 2 * K0 + 4;
   expx = MPFR_GET_EXP (x);
 
-  mpfr_init (c);
-  mpfr_init (xr);
+  /* if |x| >= 1, reduce x into [-Pi/4, Pi/4] */
+  reduce = expx > 0;
 
+  MPFR_GROUP_INIT_2 (group, m, c, xr);
   MPFR_ZIV_INIT (loop, m);
   for (;;)
     {
-      /* first perform argument reduction modulo 2*Pi (if needed),
-         also helps to determine the sign of sin(x) */
-      if (expx >= 2) /* If Pi < x < 4, we need to reduce too, to determine
-                        the sign of sin(x). For 2 <= |x| < Pi, we could avoid
-                        the reduction. */
+      /* Let xx = x - q*Pi/2 - 2k*Pi. Then |xr - xx| <= 2^(1-m), thus
+         |sin(xr + q*Pi/2) - sin(x)| <= 2^(1-m). */
+      if (reduce)
         {
-          reduce = 1;
-          /* As expx + m - 1 will silently be converted into mpfr_prec_t
-             in the mpfr_set_prec call, the assert below may be useful to
-             avoid undefined behavior. */
-          MPFR_ASSERTN (expx + m - 1 <= MPFR_PREC_MAX);
-          mpfr_set_prec (c, expx + m - 1);
-          mpfr_set_prec (xr, m);
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
-          /* The analysis is similar to that of cos.c:
-             |xr - x - 2kPi| <= 2^(2-m). Thus we can decide the sign
-             of sin(x) if xr is at distance at least 2^(2-m) of both
-             0 and +/-Pi. */
-          mpfr_div_2ui (c, c, 1, MPFR_RNDN);
-          /* Since c approximates Pi with an error <= 2^(2-expx-m) <= 2^(-m),
-             it suffices to check that c - |xr| >= 2^(2-m). */
-          if (MPFR_SIGN (xr) > 0)
-            mpfr_sub (c, c, xr, MPFR_RNDZ);
-          else
-            mpfr_add (c, c, xr, MPFR_RNDZ);
-          if (MPFR_IS_ZERO(xr)
-              || MPFR_GET_EXP(xr) < (mpfr_exp_t) 3 - (mpfr_exp_t) m
-              || MPFR_IS_ZERO(c)
-              || MPFR_GET_EXP(c) < (mpfr_exp_t) 3 - (mpfr_exp_t) m)
+          q = mpfr_reduce_pi2 (xr, x);
+          if (MPFR_IS_ZERO (xr))
             goto ziv_next;
-
-          /* |xr - x - 2kPi| <= 2^(2-m), thus |sin(xr) - sin(x)| <= 2^(2-m) */
           xx = xr;
         }
-      else /* the input argument is already reduced */
+      else
         {
-          reduce = 0;
+          q = 0;
           xx = x;
         }
 
-      sign = MPFR_SIGN(xx);
-      /* now that the argument is reduced, precision m is enough */
-      mpfr_set_prec (c, m);
-      mpfr_cos (c, xx, MPFR_RNDZ);    /* can't be exact */
-      mpfr_nexttoinf (c);           /* now c = cos(x) rounded away */
-      mpfr_mul (c, c, c, MPFR_RNDU); /* away */
-      mpfr_ui_sub (c, 1, c, MPFR_RNDZ);
-      mpfr_sqrt (c, c, MPFR_RNDZ);
-      if (MPFR_IS_NEG_SIGN(sign))
-        MPFR_CHANGE_SIGN(c);
-
-      /* Warning: c may be 0! */
-      if (MPFR_UNLIKELY (MPFR_IS_ZERO (c)))
+      /* sin(xx + q*Pi/2) is sin(xx), cos(xx), -sin(xx), -cos(xx)
+         for q = 0, 1, 2, 3 respectively */
+      if (q & 1)
+        err = mpfr_cos_reduced (c, xx);
+      else
+        err = mpfr_sin_reduced (c, xx);
+      if (q & 2)
+        MPFR_CHANGE_SIGN (c);
+
+      /* The error on c is at most 2^err ulp(c), plus 2^(1-m) in case of
+         argument reduction, which is 2^(1-expc) ulp(c). */
+      expc = MPFR_GET_EXP (c);
+      if (reduce)
+        err = MAX (err, 1 - expc) + 1;
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (c, m - err, precy, rnd_mode)))
+        break;
+
+      if (MPFR_UNLIKELY (expc == 1))
+        /* c = 1 or -1, and sin(x) cannot be 1 or -1 for x a non-zero
+           floating-point number, so we can round if the error is less than
+           2^(-precy) for directed rounding, or 2^(-precy-1) for rounding to
+           nearest (see mpfr_cos). */
         {
-          /* Huge cancellation: increase prec a lot! */
-          m = MAX (m, MPFR_PREC (x));
-          m = 2 * m;
+          if (m - err - 1 >= precy + (rnd_mode == MPFR_RNDN))
+            {
+              mpfr_set_si (c, MPFR_INT_SIGN (c), MPFR_RNDN);
+              mpfr_nexttozero (c);
+              break;
+            }
         }
-      else
+
+      /* x is near a multiple of Pi: cancellation in the reduction */
+      if (expc < cancel)
         {
-          /* the absolute error on c is at most 2^(3-m-EXP(c)),
-             plus 2^(2-m) if there was an argument reduction.
-             Since EXP(c) <= 1, 3-m-EXP(c) >= 2-m, thus the error
-             is at most 2^(3-m-EXP(c)) in case of argument reduction. */
-          err = 2 * MPFR_GET_EXP (c) + (mpfr_exp_t) m - 3 - (reduce != 0);
-          if (MPFR_CAN_ROUND (c, err, precy, rnd_mode))
-            break;
-
-          /* check for huge cancellation (Near 0) */
-          if (err < (mpfr_exp_t) MPFR_PREC (y))
-            m += MPFR_PREC (y) - err;
-          /* Check if near 1 */
-          if (MPFR_GET_EXP (c) == 1)
-            m += m;
+          m += cancel - expc;
+          cancel = expc;
         }
 
     ziv_next:
-      /* Else generic increase */
       MPFR_ZIV_NEXT (loop, m);
+      MPFR_GROUP_REPREC_2 (group, m, c, xr);
     }
   MPFR_ZIV_FREE (loop);
 
@@ -174,8 +211,7 @@ mpfr_sin (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   /* inexact cannot be 0, since this would mean that c was representable
      within the target precision, but in that case mpfr_can_round will fail */
 
-  mpfr_clear (c);
-  mpfr_clear (xr);
+  MPFR_GROUP_CLEAR (group);
 
   MPFR_SAVE_EXPO_FREE (expo);
   return mpfr_check_range (y, inexact, rnd_mode);
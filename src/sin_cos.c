@@ -28,14 +28,15 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 int
 mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
 {
-  mpfr_prec_t prec, m;
-  int neg, reduce;
-  mpfr_t c, xr;
+  mpfr_prec_t prec, m, K0;
+  int reduce, q;
+  mpfr_t s, c, xr;
   mpfr_srcptr xx;
-  mpfr_exp_t err, expx;
+  mpfr_exp_t err, errs, errc, exps, expc, expx, cancel = 0;
   int inexy, inexz;
   MPFR_ZIV_DECL (loop);
   MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_GROUP_DECL (group);
 
   MPFR_ASSERTN (y != z);
 
@@ -68,14 +69,8 @@ mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
   MPFR_SAVE_EXPO_MARK (expo);
 
   prec = MAX (MPFR_PREC (y), MPFR_PREC (z));
-  m = prec + MPFR_INT_CEIL_LOG2 (prec) + 13;
   expx = MPFR_GET_EXP (x);
 
-  /* When x is close to 0, say 2^(-k), then there is a cancellation of about
-     2k bits in 1-cos(x)^2. FIXME: in that case, it would be more efficient
-     to compute sin(x) directly. VL: This is partly done by using
-     MPFR_FAST_COMPUTE_IF_SMALL_INPUT from the mpfr_sin and mpfr_cos
-     functions. Moreover, any overflow on m is avoided. */
   if (expx < 0)
     {
       /* Warning: in case y = x, and the first call to
@@ -122,103 +117,109 @@ mpfr_sin_cos (mpfr_ptr y, mpfr_ptr z, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
                   goto end; });
             }
         }
-      m += 2 * (-expx);
     }
 
   if (prec >= MPFR_SINCOS_THRESHOLD)
     {
-      MPFR_SAVE_EXPO_FREE (expo);
-      return mpfr_sincos_fast (y, z, x, rnd_mode);
+      /* the argument reduction needs the extended exponent range */
+      int inex = mpfr_sincos_fast (y, z, x, rnd_mode);
+      inexy = inex & 3;
+      inexz = (inex >> 2) & 3;
+      /* 0: exact, 1: rounded up, 2: rounded down */
+      inexy = (inexy == 2) ? -1 : inexy;
+      inexz = (inexz == 2) ? -1 : inexz;
+      goto end;
     }
 
-  mpfr_init (c);
-  mpfr_init (xr);
+  /* Since sin(x) and cos(x) are computed separately from the reduced
+     argument, there is no cancellation in 1 - cos(x)^2 for x near 0. */
+  K0 = __gmpfr_isqrt (prec / 3);
+  m = prec + 2 * MPFR_INT_CEIL_LOG2 (prec) + 2 * K0 + 4;
 
+  /* if |x| >= 1, reduce x into [-Pi/4, Pi/4] */
+  reduce = expx > 0;
+
+  MPFR_GROUP_INIT_3 (group, m, s, c, xr);
   MPFR_ZIV_INIT (loop, m);
   for (;;)
     {
       /* the following is copied from sin.c */
-      if (expx >= 2) /* reduce the argument */
+      if (reduce)
         {
-          reduce = 1;
-          mpfr_set_prec (c, expx + m - 1);
-          mpfr_set_prec (xr, m);
-          mpfr_const_pi (c, MPFR_RNDN);
-          mpfr_mul_2ui (c, c, 1, MPFR_RNDN);
-          mpfr_remainder (xr, x, c, MPFR_RNDN);
-          mpfr_div_2ui (c, c, 1, MPFR_RNDN);
-          if (MPFR_SIGN (xr) > 0)
-            mpfr_sub (c, c, xr, MPFR_RNDZ);
-          else
-            mpfr_add (c, c, xr, MPFR_RNDZ);
-          if (MPFR_IS_ZERO(xr)
-              || MPFR_EXP(xr) < (mpfr_exp_t) 3 - (mpfr_exp_t) m
-              || MPFR_EXP(c) < (mpfr_exp_t) 3 - (mpfr_exp_t) m)
+          q = mpfr_reduce_pi2 (xr, x);
+          if (MPFR_IS_ZERO (xr))
             goto next_step;
           xx = xr;
         }
       else /* the input argument is already reduced */
         {
-          reduce = 0;
+          q = 0;
           xx = x;
         }
 
-      neg = MPFR_IS_NEG (xx); /* gives sign of sin(x) */
-      mpfr_set_prec (c, m);
-      mpfr_cos (c, xx, MPFR_RNDZ);
-      /* If no argument reduction was performed, the error is at most ulp(c),
-         otherwise it is at most ulp(c) + 2^(2-m). Since |c| < 1, we have
-         ulp(c) <= 2^(-m), thus the error is bounded by 2^(3-m) in that later
-         case. */
-      if (reduce == 0)
-        err = m;
-      else
-        err = MPFR_GET_EXP (c) + (mpfr_exp_t) (m - 3);
-      if (!mpfr_can_round (c, err, MPFR_RNDN, MPFR_RNDZ,
-                           MPFR_PREC (z) + (rnd_mode == MPFR_RNDN)))
-        goto next_step;
-
-      /* we can't set z now, because in case z = x, and the mpfr_can_round()
-         call below fails, we will have clobbered the input */
-      mpfr_set_prec (xr, MPFR_PREC(c));
-      mpfr_swap (xr, c); /* save the approximation of the cosine in xr */
-      mpfr_sqr (c, xr, MPFR_RNDU); /* the absolute error is bounded by
-                                      2^(5-m) if reduce=1, and by 2^(2-m)
-                                      otherwise */
-      mpfr_ui_sub (c, 1, c, MPFR_RNDN); /* error bounded by 2^(6-m) if reduce
-                                           is 1, and 2^(3-m) otherwise */
-      mpfr_sqrt (c, c, MPFR_RNDN); /* the absolute error is bounded by
-                                      2^(6-m-Exp(c)) if reduce=1, and
-                                      2^(3-m-Exp(c)) otherwise */
-      err = 3 + 3 * reduce - MPFR_GET_EXP (c);
-      if (neg)
-        MPFR_CHANGE_SIGN (c);
-
-      /* the absolute error on c is at most 2^(err-m), which we must put
-         in the form 2^(EXP(c)-err). */
-      err = MPFR_GET_EXP (c) + (mpfr_exp_t) m - err;
-      if (mpfr_can_round (c, err, MPFR_RNDN, MPFR_RNDZ,
-                          MPFR_PREC (y) + (rnd_mode == MPFR_RNDN)))
-        break;
-      /* check for huge cancellation */
-      if (err < (mpfr_exp_t) MPFR_PREC (y))
-        m += MPFR_PREC (y) - err;
-      /* Check if near 1 */
-      if (MPFR_GET_EXP (c) == 1
-          && MPFR_MANT (c)[MPFR_LIMB_SIZE (c)-1] == MPFR_LIMB_HIGHBIT)
-        m += m;
+      errs = mpfr_sin_reduced (s, xx);
+      errc = mpfr_cos_reduced (c, xx);
+      if (q & 1) /* sin(x+Pi/2) = cos(x), cos(x+Pi/2) = -sin(x) */
+        {
+          mpfr_swap (s, c);
+          err = errs;
+          errs = errc;
+          errc = err;
+          MPFR_CHANGE_SIGN (c);
+        }
+      if (q & 2) /* sin(x+Pi) = -sin(x), cos(x+Pi) = -cos(x) */
+        {
+          MPFR_CHANGE_SIGN (s);
+          MPFR_CHANGE_SIGN (c);
+        }
+
+      /* The reduction adds an error of at most 2^(1-m), see sin.c. */
+      exps = MPFR_GET_EXP (s);
+      expc = MPFR_GET_EXP (c);
+      if (reduce)
+        {
+          errs = MAX (errs, 1 - exps) + 1;
+          errc = MAX (errc, 1 - expc) + 1;
+        }
+
+      /* Neither sin(x) nor cos(x) can be 1 or -1 for x a non-zero
+         floating-point number, see mpfr_sin and mpfr_cos. */
+      if (!MPFR_CAN_ROUND (s, m - errs, MPFR_PREC (y), rnd_mode))
+        {
+          if (exps != 1
+              || m - errs - 1 < MPFR_PREC (y) + (rnd_mode == MPFR_RNDN))
+            goto cancel;
+          mpfr_set_si (s, MPFR_INT_SIGN (s), MPFR_RNDN);
+          mpfr_nexttozero (s);
+        }
+      if (!MPFR_CAN_ROUND (c, m - errc, MPFR_PREC (z), rnd_mode))
+        {
+          if (expc != 1
+              || m - errc - 1 < MPFR_PREC (z) + (rnd_mode == MPFR_RNDN))
+            goto cancel;
+          mpfr_set_si (c, MPFR_INT_SIGN (c), MPFR_RNDN);
+          mpfr_nexttozero (c);
+        }
+      break;
+
+    cancel:
+      /* x is near a multiple of Pi/2: cancellation in the reduction */
+      if (MIN (exps, expc) < cancel)
+        {
+          m += cancel - MIN (exps, expc);
+          cancel = MIN (exps, expc);
+        }
 
     next_step:
       MPFR_ZIV_NEXT (loop, m);
-      mpfr_set_prec (c, m);
+      MPFR_GROUP_REPREC_3 (group, m, s, c, xr);
     }
   MPFR_ZIV_FREE (loop);
 
-  inexy = mpfr_set (y, c, rnd_mode);
-  inexz = mpfr_set (z, xr, rnd_mode);
+  inexy = mpfr_set (y, s, rnd_mode);
+  inexz = mpfr_set (z, c, rnd_mode);
 
-  mpfr_clear (c);
-  mpfr_clear (xr);
+  MPFR_GROUP_CLEAR (group);
 
  end:
   MPFR_SAVE_EXPO_FREE (expo);
@@ -603,21 +604,11 @@ mpfr_sincos_fast (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd)
         }
       else /* argument reduction is needed */
         {
-          long q;
-          mpfr_t pi;
-          int neg = 0;
+          int q, neg = 0;
 
           mpfr_init2 (x_red, w);
-          mpfr_init2 (pi, (MPFR_EXP(x) > 0) ? w + MPFR_EXP(x) : w);
-          mpfr_const_pi (pi, MPFR_RNDN);
-          mpfr_div_2exp (pi, pi, 1, MPFR_RNDN); /* Pi/2 */
-          mpfr_remquo (x_red, &q, x, pi, MPFR_RNDN);
-          /* x = q * (Pi/2 + eps1) + x_red + eps2,
-             where |eps1| <= 1/2*ulp(Pi/2) = 2^(-w-MAX(0,EXP(x))),
-             and eps2 <= 1/2*ulp(x_red) <= 1/2*ulp(Pi/2) = 2^(-w)
-             Since |q| <= x/(Pi/2) <= |x|, we have
-             q*|eps1| <= 2^(-w), thus
-             |x - q * Pi/2 - x_red| <= 2^(1-w) */
+          /* |x - q * Pi/2 - x_red| <= 2^(1-w) mod 2Pi */
+          q = mpfr_reduce_pi2 (x_red, x);
           /* now -Pi/4 <= x_red <= Pi/4: if x_red < 0, consider -x_red */
           if (MPFR_IS_NEG(x_red))
             {
@@ -639,7 +630,6 @@ mpfr_sincos_fast (mpfr_t s, mpfr_t c, mpfr_srcptr x, mpfr_rnd_t rnd)
               mpfr_swap (ts, tc);
             }
           mpfr_clear (x_red);
-          mpfr_clear (pi);
         }
       /* adjust errors with respect to absolute values */
       errs = err - MPFR_EXP(ts);
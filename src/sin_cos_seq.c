@@ -0,0 +1,280 @@
+/* mpfr_sin_cos_seq -- sine and cosine on an arithmetic progression
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+#define ULONG_BITS ((mpfr_prec_t) (sizeof (unsigned long) * CHAR_BIT))
+
+/* The points x0 + k*h are processed by blocks of 2^LOG2_BLOCK: the first
+   sine and cosine of each block are evaluated directly, the next ones
+   are obtained by rotation. */
+#define LOG2_BLOCK 8
+
+/* Set xk to x0 + k*h, changing the precision of xk as needed: exactly
+   if this takes at most EXP(x0 + k*h) + q bits (roughly), otherwise
+   rounded to nearest with an absolute error less than 2^(-q), so that
+   the precision of xk does not depend on the distance between the
+   exponents of x0 and k*h. Return 0 iff xk is exact. */
+static int
+set_point (mpfr_ptr xk, mpfr_srcptr x0, mpfr_srcptr h, unsigned long k,
+           mpfr_prec_t q)
+{
+  mpfr_t kh;
+  mpfr_exp_t emax, emin;
+  int inex;
+
+  mpfr_init2 (kh, MPFR_PREC (h) + ULONG_BITS);
+  inex = mpfr_mul_ui (kh, h, k, MPFR_RNDN);
+  MPFR_ASSERTN (inex == 0);
+  if (MPFR_IS_ZERO (kh))
+    {
+      mpfr_set_prec (xk, MPFR_PREC (x0));
+      inex = mpfr_set (xk, x0, MPFR_RNDN);
+    }
+  else if (MPFR_IS_ZERO (x0))
+    {
+      mpfr_set_prec (xk, MPFR_PREC (kh));
+      inex = mpfr_set (xk, kh, MPFR_RNDN);
+    }
+  else
+    {
+      /* x0 + k*h is a multiple of 2^emin, less than 2^emax in absolute
+         value: it is exact on emax - emin bits, and rounded to nearest on
+         emax + q bits its error is at most 2^(-q-1) */
+      emax = MAX (MPFR_GET_EXP (x0), MPFR_GET_EXP (kh)) + 1;
+      emin = MIN (MPFR_GET_EXP (x0) - MPFR_PREC (x0),
+                  MPFR_GET_EXP (kh) - MPFR_PREC (kh));
+      if (emin >= -q)
+        mpfr_set_prec (xk, emax - emin);
+      else
+        mpfr_set_prec (xk, MAX (emax + q, MPFR_PREC_MIN));
+      inex = mpfr_add (xk, x0, kh, MPFR_RNDN);
+    }
+  mpfr_clear (kh);
+  return inex;
+}
+
+/* Set r to sin(x0 + k*h) if i = 0, and to cos(x0 + k*h) otherwise,
+   rounded in the direction rnd_mode, and return the ternary value; xk is
+   used as a temporary. The point is computed with an absolute error
+   less than 2^(-q), and the sine or cosine v of the rounded point rounded
+   to nearest on q bits, thus with an error of at most
+   2^(-q) + 1/2 ulp(v) <= 2^(max(-EXP(v),0)+1) ulp(v), where -EXP(v)
+   counts the bits that cancel near a zero of the sine or cosine. */
+static int
+sin_cos_point (mpfr_ptr r, mpfr_ptr xk, mpfr_srcptr x0, mpfr_srcptr h,
+               unsigned long k, int i, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t v;
+  mpfr_prec_t q;
+  int inex;
+  MPFR_ZIV_DECL (loop);
+
+  q = MPFR_PREC (r) + MPFR_INT_CEIL_LOG2 (MPFR_PREC (r)) + 10;
+  mpfr_init2 (v, q);
+  MPFR_ZIV_INIT (loop, q);
+  for (;;)
+    {
+      if (set_point (xk, x0, h, k, q) == 0)
+        {
+          /* the point is exact */
+          inex = (i == 0) ? mpfr_sin (r, xk, rnd_mode)
+            : mpfr_cos (r, xk, rnd_mode);
+          break;
+        }
+      if (i == 0)
+        mpfr_sin (v, xk, MPFR_RNDN);
+      else
+        mpfr_cos (v, xk, MPFR_RNDN);
+      if (MPFR_LIKELY (!MPFR_IS_ZERO (v)
+                       && MPFR_CAN_ROUND (v, q - 1
+                                          - MAX (-MPFR_GET_EXP (v), 0),
+                                          MPFR_PREC (r), rnd_mode)))
+        {
+          inex = mpfr_set (r, v, rnd_mode);
+          break;
+        }
+      MPFR_ZIV_NEXT (loop, q);
+      mpfr_set_prec (v, q);
+    }
+  MPFR_ZIV_FREE (loop);
+  mpfr_clear (v);
+  return inex;
+}
+
+/* Set s[k] to sin(x0 + k*h) and c[k] to cos(x0 + k*h) for 0 <= k < n,
+   each one rounded to its own precision in the direction rnd_mode, where
+   x0 + k*h is the exact value. Either s or c may be a null pointer, and
+   the outputs may be the same variables as x0 or h, but s[k] and c[k]
+   must be different variables.
+   Return 0 iff all the results are exact, 1 otherwise: a ternary value
+   per output cannot be returned in an int, as for mpfr_zeta_ui_vec.
+
+   Let (C, S) be the approximation of (cos(x), sin(x)) and (ch, sh) that
+   of (cos(h), sin(h)), all rounded to nearest on w bits, thus with an
+   absolute error of at most 2^(-w) on each coordinate since they are at
+   most 1 in absolute value. The next point is (C*ch - S*sh, S*ch + C*sh):
+   for the Euclidean norm, the error E on (C, S) becomes at most
+   E*(1+2^(1-w)) + sqrt(2)*2^(-w) + 3*sqrt(2)*2^(-w), where the first term
+   comes from the rotation by (ch, sh) of norm at most 1+sqrt(2)*2^(-w),
+   the second one from the error on (ch, sh) and the third one from the
+   three roundings on each coordinate. Thus E_(k+1) <= E_k*(1+2^(1-w)) +
+   2^(3-w). The first point of each block is computed with an error of at
+   most 2^(-w-1) by set_point, thus E_0 <= sqrt(2)*2^(-w) + 2^(-w-1)
+   <= 2^(1-w), and for k < 2^(w-2) we get
+   E_k <= 2*(E_0 + k*2^(3-w)) <= (k+1)*2^(4-w) <= 2^(4+LOG2_BLOCK-w).
+   The entries that cannot be rounded from this bound, including the
+   exact ones, are evaluated separately by sin_cos_point.
+
+   All the results are computed in the extended exponent range, then
+   mpfr_check_range is applied to each of them with its ternary value,
+   which is kept in the array tern meanwhile.
+
+   Since the blocks are independent, a caller may split the progression
+   among several threads by calling this function on sub-progressions. */
+int
+mpfr_sin_cos_seq (mpfr_ptr *s, mpfr_ptr *c, mpfr_srcptr x0, mpfr_srcptr h,
+                  unsigned long n, mpfr_rnd_t rnd_mode)
+{
+  mpfr_t x0c, hc, sh, ch, sv, cv, t, u, xk;
+  mpfr_prec_t prec, w;
+  mpfr_exp_t err;
+  unsigned long j, k;
+  int inexact = 0, i;
+  int *tern;
+  MPFR_SAVE_EXPO_DECL (expo);
+  MPFR_TMP_DECL (marker);
+
+  MPFR_LOG_FUNC
+    (("x0[%Pu]=%.*Rg h[%Pu]=%.*Rg n=%lu rnd=%d",
+      mpfr_get_prec (x0), mpfr_log_prec, x0,
+      mpfr_get_prec (h), mpfr_log_prec, h, n, rnd_mode),
+     ("inexact=%d", inexact));
+
+  if (MPFR_UNLIKELY (n == 0))
+    return 0;
+
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x0) || MPFR_IS_SINGULAR (h)))
+    {
+      if (MPFR_IS_NAN (x0) || MPFR_IS_INF (x0)
+          || MPFR_IS_NAN (h) || MPFR_IS_INF (h))
+        {
+          for (k = 0; k < n; k++)
+            {
+              if (s != NULL)
+                MPFR_SET_NAN (s[k]);
+              if (c != NULL)
+                MPFR_SET_NAN (c[k]);
+            }
+          MPFR_RET_NAN;
+        }
+      /* a zero x0 or h is handled by the generic code */
+    }
+
+  prec = MPFR_PREC_MIN;
+  for (k = 0; k < n; k++)
+    {
+      if (s != NULL)
+        prec = MAX (prec, MPFR_PREC (s[k]));
+      if (c != NULL)
+        prec = MAX (prec, MPFR_PREC (c[k]));
+    }
+  w = prec + MPFR_INT_CEIL_LOG2 (prec) + LOG2_BLOCK + 10;
+  err = w - 4 - LOG2_BLOCK;
+
+  MPFR_ASSERTN (n <= (size_t) -1 / (2 * sizeof *tern));
+  MPFR_TMP_MARK (marker);
+  tern = (int *) MPFR_TMP_ALLOC (2 * n * sizeof *tern);
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* x0 and h are read until the last point, but may be outputs. */
+  mpfr_init2 (x0c, MPFR_PREC (x0));
+  mpfr_init2 (hc, MPFR_PREC (h));
+  mpfr_set (x0c, x0, MPFR_RNDN);
+  mpfr_set (hc, h, MPFR_RNDN);
+
+  mpfr_init2 (sh, w);
+  mpfr_init2 (ch, w);
+  mpfr_init2 (sv, w);
+  mpfr_init2 (cv, w);
+  mpfr_init2 (t, w);
+  mpfr_init2 (u, w);
+  mpfr_init2 (xk, MPFR_PREC_MIN);
+  mpfr_sin_cos (sh, ch, hc, MPFR_RNDN);
+
+  for (j = 0; j < n; j += k)
+    {
+      set_point (xk, x0c, hc, j, w + 1);
+      mpfr_sin_cos (sv, cv, xk, MPFR_RNDN);
+      for (k = 0; k < (1UL << LOG2_BLOCK) && k < n - j; k++)
+        {
+          if (k > 0)
+            {
+              /* (cv, sv) <- (cv*ch - sv*sh, sv*ch + cv*sh) */
+              mpfr_mul (t, cv, ch, MPFR_RNDN);
+              mpfr_mul (u, sv, sh, MPFR_RNDN);
+              mpfr_mul (sv, sv, ch, MPFR_RNDN);
+              mpfr_fma (sv, cv, sh, sv, MPFR_RNDN);
+              mpfr_sub (cv, t, u, MPFR_RNDN);
+            }
+          for (i = 0; i < 2; i++)
+            {
+              mpfr_ptr r = (i == 0) ? (s != NULL ? s[j + k] : NULL)
+                : (c != NULL ? c[j + k] : NULL);
+              mpfr_ptr v = (i == 0) ? sv : cv;
+
+              if (r == NULL)
+                continue;
+              if (MPFR_LIKELY (!MPFR_IS_ZERO (v)
+                               && MPFR_CAN_ROUND (v, err + MPFR_GET_EXP (v),
+                                                  MPFR_PREC (r), rnd_mode)))
+                tern[2 * (j + k) + i] = mpfr_set (r, v, rnd_mode);
+              else
+                tern[2 * (j + k) + i] =
+                  sin_cos_point (r, xk, x0c, hc, j + k, i, rnd_mode);
+            }
+        }
+    }
+
+  mpfr_clear (x0c);
+  mpfr_clear (hc);
+  mpfr_clear (sh);
+  mpfr_clear (ch);
+  mpfr_clear (sv);
+  mpfr_clear (cv);
+  mpfr_clear (t);
+  mpfr_clear (u);
+  mpfr_clear (xk);
+  MPFR_SAVE_EXPO_FREE (expo);
+
+  for (k = 0; k < n; k++)
+    {
+      if (s != NULL)
+        inexact |= mpfr_check_range (s[k], tern[2 * k], rnd_mode) != 0;
+      if (c != NULL)
+        inexact |= mpfr_check_range (c[k], tern[2 * k + 1], rnd_mode) != 0;
+    }
+  MPFR_TMP_FREE (marker);
+  return inexact;
+}
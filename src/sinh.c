@@ -76,8 +76,10 @@ mpfr_sinh (mpfr_ptr y, mpfr_srcptr xt, mpfr_rnd_t rnd_mode)
 
     MPFR_SAVE_EXPO_MARK (expo);
 
-    /* compute the precision of intermediary variable */
-    Nt = MAX (MPFR_PREC (x), MPFR_PREC (y));
+    /* compute the precision of intermediary variable: it only depends on
+       the output precision, since exp(x) is correctly rounded whatever the
+       precision of x */
+    Nt = MPFR_PREC (y);
     /* the optimal number of bits : see algorithms.ps */
     Nt = Nt + MPFR_INT_CEIL_LOG2 (Nt) + 4;
     /* If x is near 0, exp(x) - 1/exp(x) = 2*x+x^3/3+O(x^5) */
@@ -98,11 +100,14 @@ mpfr_sinh (mpfr_ptr y, mpfr_srcptr xt, mpfr_rnd_t rnd_mode)
         if (MPFR_OVERFLOW (flags))
           /* exp(x) does overflow */
           {
+            mpfr_t x2;
+
             /* sinh(x) = 2 * sinh(x/2) * cosh(x/2) */
-            mpfr_div_2ui (ti, x, 1, MPFR_RNDD); /* exact */
+            x2[0] = *x;
+            MPFR_SET_EXP (x2, MPFR_GET_EXP (x) - 1); /* x/2, exact */
 
             /* t <- cosh(x/2): error(t) <= 1 ulp(t) */
-            MPFR_BLOCK (flags, mpfr_cosh (t, ti, MPFR_RNDD));
+            MPFR_BLOCK (flags, mpfr_cosh (t, x2, MPFR_RNDD));
             if (MPFR_OVERFLOW (flags))
               /* when x>1 we have |sinh(x)| >= cosh(x/2), so sinh(x)
                  overflows too */
@@ -114,7 +119,7 @@ mpfr_sinh (mpfr_ptr y, mpfr_srcptr xt, mpfr_rnd_t rnd_mode)
 
             /* ti <- sinh(x/2): , error(ti) <= 1 ulp(ti)
                cannot overflow because 0 < sinh(x) < cosh(x) when x > 0 */
-            mpfr_sinh (ti, ti, MPFR_RNDD);
+            mpfr_sinh (ti, x2, MPFR_RNDD);
 
             /* multiplication below, error(t) <= 5 ulp(t) */
             MPFR_BLOCK (flags, mpfr_mul (t, t, ti, MPFR_RNDD));
@@ -30,7 +30,7 @@ mpfr_sqr (mpfr_ptr a, mpfr_srcptr b, mpfr_rnd_t rnd_mode)
   mp_limb_t *tmp;
   mp_limb_t b1;
   mpfr_prec_t bq;
-  mp_size_t bn, tn;
+  mp_size_t bn, bz, tn;
   MPFR_TMP_DECL(marker);
 
   MPFR_LOG_FUNC
@@ -62,14 +62,18 @@ mpfr_sqr (mpfr_ptr a, mpfr_srcptr b, mpfr_rnd_t rnd_mode)
   tn = MPFR_PREC2LIMBS (2 * bq); /* number of limbs of square,
                                     2*bn or 2*bn-1 */
 
-  if (MPFR_UNLIKELY(bn > MPFR_SQR_THRESHOLD))
+  /* mpfr_mul also truncates b when the destination has fewer limbs */
+  if (MPFR_UNLIKELY(bn > MPFR_SQR_THRESHOLD || bn > MPFR_LIMB_SIZE (a) + 1))
     return mpfr_mul (a, b, b, rnd_mode);
 
   MPFR_TMP_MARK(marker);
   tmp = MPFR_TMP_LIMBS_ALLOC (2 * bn);
 
-  /* Multiplies the mantissa in temporary allocated space */
-  mpn_sqr_n (tmp, MPFR_MANT(b), bn);
+  /* Multiplies the mantissa in temporary allocated space, skipping its
+     zero low limbs (the low limbs of the square are then zero) */
+  for (bz = 0; MPFR_MANT(b)[bz] == 0; bz++);
+  MPN_ZERO (tmp, 2 * bz);
+  mpn_sqr_n (tmp + 2 * bz, MPFR_MANT(b) + bz, bn - bz);
   b1 = tmp[2 * bn - 1];
 
   /* now tmp[0]..tmp[2*bn-1] contains the product of both mantissa,
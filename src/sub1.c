@@ -22,6 +22,49 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
 #include "mpfr-impl.h"
 
+/* The significands of b and c are aligned with the result by a right shift
+   of sh bits (0 <= sh < GMP_NUMB_BITS): if sh != 0, the shifted {up, un}
+   has un + 1 limbs, the low one containing the bits shifted out. Instead
+   of computing the whole shifted significands, only the limbs that are
+   actually read are computed by the functions below, so that the cost does
+   not depend on the precision of b or c when it is much larger than the
+   precision of a. */
+
+/* Return the limb j of the shifted {up, un}. */
+static mp_limb_t
+sub1_limb (mp_limb_t *up, mp_size_t un, int sh, mp_size_t j)
+{
+  if (sh == 0)
+    return up[j];
+  return (j > 0 ? up[j - 1] >> sh : 0)
+    | (j < un ? up[j] << (GMP_NUMB_BITS - sh) : 0);
+}
+
+/* Put in {rp, n} the limbs j0 to j0 + n - 1 of the shifted {up, un},
+   with n > 0. */
+static void
+sub1_limbs (mp_limb_t *rp, mp_limb_t *up, mp_size_t un, int sh,
+            mp_size_t j0, mp_size_t n)
+{
+  if (sh == 0)
+    {
+      MPN_COPY (rp, up + j0, n);
+      return;
+    }
+  if (j0 == 0)
+    {
+      rp[0] = up[0] << (GMP_NUMB_BITS - sh);
+      if (--n == 0)
+        return;
+      rp++;
+      j0++;
+    }
+  /* the limbs j0 to j0 + n - 1 depend on up[j0-1] to up[j0+n-1] */
+  mpn_rshift (rp, up + j0 - 1, n, sh);
+  if (j0 + n - 1 < un)
+    rp[n - 1] |= up[j0 + n - 1] << (GMP_NUMB_BITS - sh);
+}
+
 /* compute sign(b) * (|b| - |c|), with |b| > |c|, diff_exp = EXP(b) - EXP(c)
    Returns 0 iff result is exact,
    a negative value when the result is less than the exact value,
@@ -34,8 +77,8 @@ mpfr_sub1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   int sign;
   mpfr_uexp_t diff_exp;
   mpfr_prec_t cancel, cancel1;
-  mp_size_t cancel2, an, bn, cn, cn0;
-  mp_limb_t *ap, *bp, *cp;
+  mp_size_t cancel2, an, bn, cn, cn0, bn1, cn1;
+  mp_limb_t *ap, *bp, *cp, *cw;
   mp_limb_t carry, bb, cc;
   int inexact, shift_b, shift_c, add_exp = 0;
   int cmp_low = 0; /* used for rounding to nearest: 0 if low(b) = low(c),
@@ -145,32 +188,25 @@ mpfr_sub1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
 
   diff_exp = (mpfr_uexp_t) MPFR_GET_EXP (b) - MPFR_GET_EXP (c);
 
-  /* reserve a space to store b aligned with the result, i.e. shifted by
-     (-cancel) % GMP_NUMB_BITS to the right */
-  bn      = MPFR_LIMB_SIZE (b);
+  /* b is aligned with the result by a shift of (-cancel) % GMP_NUMB_BITS
+     bits to the right, giving bn limbs */
+  bn1     = MPFR_LIMB_SIZE (b);
   MPFR_UNSIGNED_MINUS_MODULO (shift_b, cancel);
   cancel1 = (cancel + shift_b) / GMP_NUMB_BITS;
 
   /* the high cancel1 limbs from b should not be taken into account */
-  if (MPFR_UNLIKELY (shift_b == 0))
+  bp = MPFR_MANT(b);
+  /* Ensure ap != bp (then a and b have the same number of limbs) */
+  if (MPFR_UNLIKELY (ap == bp))
     {
-      bp = MPFR_MANT(b); /* no need of an extra space */
-      /* Ensure ap != bp */
-      if (MPFR_UNLIKELY (ap == bp))
-        {
-          bp = MPFR_TMP_LIMBS_ALLOC (bn);
-          MPN_COPY (bp, ap, bn);
-        }
-    }
-  else
-    {
-      bp = MPFR_TMP_LIMBS_ALLOC (bn + 1);
-      bp[0] = mpn_rshift (bp + 1, MPFR_MANT(b), bn++, shift_b);
+      bp = MPFR_TMP_LIMBS_ALLOC (bn1);
+      MPN_COPY (bp, ap, bn1);
     }
+  bn = bn1 + (shift_b != 0);
 
-  /* reserve a space to store c aligned with the result, i.e. shifted by
-      (diff_exp-cancel) % GMP_NUMB_BITS to the right */
-  cn      = MPFR_LIMB_SIZE(c);
+  /* c is aligned with the result by a shift of
+     (diff_exp-cancel) % GMP_NUMB_BITS bits to the right, giving cn limbs */
+  cn1     = MPFR_LIMB_SIZE(c);
   if ((UINT_MAX % GMP_NUMB_BITS) == (GMP_NUMB_BITS-1)
       && ((-(unsigned) 1)%GMP_NUMB_BITS > 0))
     shift_c = ((mpfr_uexp_t) diff_exp - cancel) % GMP_NUMB_BITS;
@@ -181,21 +217,14 @@ mpfr_sub1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
     }
   MPFR_ASSERTD( shift_c >= 0 && shift_c < GMP_NUMB_BITS);
 
-  if (MPFR_UNLIKELY(shift_c == 0))
-    {
-       cp = MPFR_MANT(c);
-      /* Ensure ap != cp */
-      if (ap == cp)
-        {
-          cp = MPFR_TMP_LIMBS_ALLOC (cn);
-          MPN_COPY(cp, ap, cn);
-        }
-    }
- else
+  cp = MPFR_MANT(c);
+  /* Ensure ap != cp (then a and c have the same number of limbs) */
+  if (ap == cp)
     {
-      cp = MPFR_TMP_LIMBS_ALLOC (cn + 1);
-      cp[0] = mpn_rshift (cp + 1, MPFR_MANT(c), cn++, shift_c);
+      cp = MPFR_TMP_LIMBS_ALLOC (cn1);
+      MPN_COPY(cp, ap, cn1);
     }
+  cn = cn1 + (shift_c != 0);
 
 #ifdef DEBUG
   printf ("rnd=%s shift_b=%d shift_c=%d diffexp=%lu\n",
@@ -257,14 +286,15 @@ mpfr_sub1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   if (MPFR_LIKELY(an + (mp_size_t) cancel1 <= bn))
     /* a: <----------------+-----------|---->
        b: <-----------------------------------------> */
-      MPN_COPY (ap, bp + bn - (an + cancel1), an);
+    sub1_limbs (ap, bp, bn1, shift_b, bn - (an + cancel1), an);
   else
     /* a: <----------------+-----------|---->
        b: <-------------------------> */
     if ((mp_size_t) cancel1 < bn) /* otherwise b does not overlap with a */
       {
         MPN_ZERO (ap, an + cancel1 - bn);
-        MPN_COPY (ap + (an + cancel1 - bn), bp, bn - cancel1);
+        sub1_limbs (ap + (an + cancel1 - bn), bp, bn1, shift_b, 0,
+                    bn - cancel1);
       }
     else
       MPN_ZERO (ap, an);
@@ -273,24 +303,31 @@ mpfr_sub1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
   printf("after copying high(b), a="); mpfr_print_binary(a); putchar('\n');
 #endif
 
-  /* subtract high(c) */
+  /* subtract high(c), whose limbs are computed in cw */
   if (MPFR_LIKELY(an + cancel2 > 0)) /* otherwise c does not overlap with a */
     {
       mp_limb_t *ap2;
 
+      cw = MPFR_TMP_LIMBS_ALLOC (an);
       if (cancel2 >= 0)
         {
           if (an + cancel2 <= cn)
             /* a: <----------------------------->
                c: <-----------------------------------------> */
-            mpn_sub_n (ap, ap, cp + cn - (an + cancel2), an);
+            {
+              sub1_limbs (cw, cp, cn1, shift_c, cn - (an + cancel2), an);
+              mpn_sub_n (ap, ap, cw, an);
+            }
           else
             /* a: <---------------------------->
                c: <-------------------------> */
             {
               ap2 = ap + an + (cancel2 - cn);
               if (cn > cancel2)
-                mpn_sub_n (ap2, ap2, cp, cn - cancel2);
+                {
+                  sub1_limbs (cw, cp, cn1, shift_c, 0, cn - cancel2);
+                  mpn_sub_n (ap2, ap2, cw, cn - cancel2);
+                }
             }
         }
       else /* cancel2 < 0 */
@@ -300,14 +337,18 @@ mpfr_sub1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
           if (an + cancel2 <= cn)
             /* a: <----------------------------->
                c: <-----------------------------> */
-            borrow = mpn_sub_n (ap, ap, cp + cn - (an + cancel2),
-                                an + cancel2);
+            {
+              sub1_limbs (cw, cp, cn1, shift_c, cn - (an + cancel2),
+                          an + cancel2);
+              borrow = mpn_sub_n (ap, ap, cw, an + cancel2);
+            }
           else
             /* a: <---------------------------->
                c: <----------------> */
             {
               ap2 = ap + an + cancel2 - cn;
-              borrow = mpn_sub_n (ap2, ap2, cp, cn);
+              sub1_limbs (cw, cp, cn1, shift_c, 0, cn);
+              borrow = mpn_sub_n (ap2, ap2, cw, cn);
             }
           ap2 = ap + an + cancel2;
           mpn_sub_1 (ap2, ap2, -cancel2, borrow);
@@ -395,9 +436,9 @@ mpfr_sub1 (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd_mode)
          if cmp_low = 0, so far low(b) - low(c) = 0 */
 
       /* get next limbs */
-      bb = (bn > 0) ? bp[--bn] : 0;
+      bb = (bn > 0) ? sub1_limb (bp, bn1, shift_b, --bn) : 0;
       if ((cn > 0) && (cn-- <= cn0))
-        cc = cp[cn];
+        cc = sub1_limb (cp, cn1, shift_c, cn);
       else
         cc = 0;
 
@@ -72,10 +72,10 @@ mpfr_tan (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
     {
       /* The only way to get an overflow is to get ~ Pi/2
          But the result will be ~ 2^Prec(y). */
-      mpfr_sin_cos (s, c, x, MPFR_RNDN); /* err <= 1/2 ulp on s and c */
-      mpfr_div (c, s, c, MPFR_RNDN);     /* err <= 4 ulps */
+      mpfr_sin_cos (s, c, x, MPFR_RNDF); /* err <= 1 ulp on s and c */
+      mpfr_div (c, s, c, MPFR_RNDN);     /* err <= 8 ulps */
       MPFR_ASSERTD (!MPFR_IS_SINGULAR (c));
-      if (MPFR_LIKELY (MPFR_CAN_ROUND (c, m - 2, precy, rnd_mode)))
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (c, m - 3, precy, rnd_mode)))
         break;
       MPFR_ZIV_NEXT (loop, m);
       MPFR_GROUP_REPREC_2 (group, m, s, c);
@@ -106,7 +106,7 @@ mpfr_tanh (mpfr_ptr y, mpfr_srcptr xt , mpfr_rnd_t rnd_mode)
       /* tanh = (exp(2x)-1)/(exp(2x)+1) */
       mpfr_mul_2ui (te, x, 1, MPFR_RNDN);  /* 2x */
       /* since x > 0, we can only have an overflow */
-      mpfr_exp (te, te, MPFR_RNDN);        /* exp(2x) */
+      mpfr_exp (te, te, MPFR_RNDF);        /* exp(2x) */
       if (MPFR_UNLIKELY (MPFR_IS_INF (te))) {
       set_one:
         inexact = MPFR_FROM_SIGN_TO_INT (sign);
@@ -124,9 +124,10 @@ mpfr_tanh (mpfr_ptr y, mpfr_srcptr xt , mpfr_rnd_t rnd_mode)
       d = d - MPFR_GET_EXP (te);
       mpfr_div (t, te, t, MPFR_RNDN);      /* (exp(2x)-1)/(exp(2x)+1)*/
 
-      /* Calculation of the error */
+      /* Calculation of the error, with one more bit since exp(2x) is only
+         faithful */
       d = MAX(3, d + 1);
-      err = Nt - (d + 1);
+      err = Nt - (d + 2);
 
       if (MPFR_LIKELY ((d <= Nt / 2) && MPFR_CAN_ROUND (t, err, Ny, rnd_mode)))
         {
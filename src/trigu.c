@@ -0,0 +1,322 @@
+/* mpfr_sinu, mpfr_cosu, mpfr_tanu, mpfr_sinpi, mpfr_cospi, mpfr_tanpi --
+   trigonometric functions with an argument in units of u
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+#define ULONG_BITS ((mpfr_prec_t) (sizeof (unsigned long) * CHAR_BIT))
+
+#define TRIGU_SIN 0
+#define TRIGU_COS 1
+#define TRIGU_TAN 2
+
+/* Put in xr the exact value x - q*u/4 - k*u, where k is an integer and
+   q in [0, 3] is the return value, such that |xr| <= u/8.
+   Since u/4 is a multiple of 1/4, xr is a multiple of 2^(EXP(x)-PREC(x))
+   or of 1/4. In the former case |xr| <= |x| < 2^EXP(x), thus xr fits on
+   PREC(x) bits; in the latter case |xr| <= u/8 < 2^(ULONG_BITS-3), thus
+   xr fits on ULONG_BITS-1 bits.
+   When x = m*2^e is an integer with e > ULONG_BITS, mpfr_remquo would need
+   EXP(x) bits, thus we first replace x by m*(2^e mod u) mod u, which is
+   congruent to x modulo u and fits on ULONG_BITS bits. Likewise, tiny
+   values of x are not reduced at all. */
+static int
+reduce_u (mpfr_ptr xr, mpfr_srcptr x, unsigned long u)
+{
+  mpfr_t v, xu;
+  long q;
+  int inex;
+
+  MPFR_ASSERTD (MPFR_PREC (xr) >= MAX (MPFR_PREC (x), ULONG_BITS));
+  if (MPFR_GET_EXP (x) <= -3) /* |x| < 1/8 <= u/8 */
+    {
+      mpfr_set (xr, x, MPFR_RNDN); /* exact */
+      return 0;
+    }
+  if (MPFR_GET_EXP (x) > MPFR_PREC (x) + ULONG_BITS)
+    {
+      mpz_t m, t, uz;
+      mpfr_exp_t e;
+
+      mpz_init (m);
+      mpz_init_set_ui (t, 2);
+      mpz_init_set_ui (uz, u);
+      e = mpfr_get_z_2exp (m, x);
+      MPFR_ASSERTD (e > 0);
+      mpz_powm_ui (t, t, (unsigned long) e, uz);
+      mpz_mul (m, m, t);
+      mpz_fdiv_r (m, m, uz);
+      mpfr_init2 (xu, ULONG_BITS);
+      inex = mpfr_set_z (xu, m, MPFR_RNDN);
+      MPFR_ASSERTN (inex == 0);
+      mpz_clear (m);
+      mpz_clear (t);
+      mpz_clear (uz);
+      x = xu;
+    }
+  mpfr_init2 (v, ULONG_BITS);
+  mpfr_set_ui_2exp (v, u, -2, MPFR_RNDN); /* exact */
+  inex = mpfr_remquo (xr, &q, x, v, MPFR_RNDN);
+  MPFR_ASSERTN (inex == 0);
+  mpfr_clear (v);
+  if (x == (mpfr_srcptr) xu)
+    mpfr_clear (xu);
+  return (int) (q & 3);
+}
+
+/* Set y to f(2*Pi*x/u), where f is sin, cos or tan according to kind.
+   Since x is reduced exactly modulo u/4, the cost does not depend on the
+   exponent of x, and Pi is only needed to the target precision. */
+static int
+trigu (mpfr_ptr y, mpfr_srcptr x, unsigned long u, mpfr_rnd_t rnd_mode,
+       int kind)
+{
+  mpfr_t xr, t;
+  mpfr_prec_t precy, w;
+  mpfr_exp_t k = 0;
+  int q, inexact, cos_kernel, cot, neg;
+  MPFR_ZIV_DECL (loop);
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_LOG_FUNC
+    (("x[%Pu]=%.*Rg u=%lu kind=%d rnd=%d", mpfr_get_prec (x), mpfr_log_prec,
+      x, u, kind, rnd_mode),
+     ("y[%Pu]=%.*Rg inexact=%d", mpfr_get_prec (y), mpfr_log_prec, y,
+      inexact));
+
+  if (MPFR_UNLIKELY (MPFR_IS_SINGULAR (x) || u == 0))
+    {
+      if (MPFR_IS_NAN (x) || MPFR_IS_INF (x) || u == 0)
+        {
+          MPFR_SET_NAN (y);
+          MPFR_RET_NAN;
+        }
+      MPFR_ASSERTD (MPFR_IS_ZERO (x));
+      if (kind == TRIGU_COS)
+        return mpfr_set_ui (y, 1, rnd_mode);
+      MPFR_SET_ZERO (y);
+      MPFR_SET_SAME_SIGN (y, x);
+      MPFR_RET (0);
+    }
+
+  MPFR_SAVE_EXPO_MARK (expo);
+
+  /* cos(2*Pi*x/u) = 1 - a^2/2 + ... with |a| = |2*Pi*x/u| < 2^(EXP(x)+3),
+     thus the error is less than 2^(2*EXP(x)+5) = 2^(1-err) */
+  if (kind == TRIGU_COS)
+    MPFR_SMALL_INPUT_AFTER_SAVE_EXPO (y, __gmpfr_one,
+                                      -2 * MPFR_GET_EXP (x) - 4, 0, 0,
+                                      rnd_mode, expo, {});
+
+  mpfr_init2 (xr, MAX (MPFR_PREC (x), ULONG_BITS));
+  q = reduce_u (xr, x, u);
+
+  /* 2*Pi*x/u = q*Pi/2 + a with a = 2*Pi*xr/u and |a| <= Pi/4:
+     sin(q*Pi/2 + a) = sin(a), cos(a), -sin(a), -cos(a) for q = 0..3,
+     cos(q*Pi/2 + a) = cos(a), -sin(a), -cos(a), sin(a) for q = 0..3,
+     tan(q*Pi/2 + a) = tan(a) for q even, -cot(a) for q odd. */
+  cos_kernel = (kind == TRIGU_SIN && (q & 1)) || (kind == TRIGU_COS
+                                                  && (q & 1) == 0);
+  cot = kind == TRIGU_TAN && (q & 1);
+  neg = (kind == TRIGU_SIN) ? (q & 2) != 0
+    : (kind == TRIGU_COS) ? q == 1 || q == 2 : cot;
+
+  /* Exact cases: a = 0, a = +/-Pi/6 for sin(a), a = +/-Pi/4 for tan(a) */
+  if (MPFR_IS_ZERO (xr))
+    {
+      if (kind == TRIGU_TAN && cot)
+        {
+          /* tan(Pi/2) = +Inf and tan(3Pi/2) = -Inf, as tanPi in IEEE
+             754-2008 */
+          MPFR_SET_INF (y);
+          if (q == 1)
+            MPFR_SET_POS (y);
+          else
+            MPFR_SET_NEG (y);
+          MPFR_SAVE_EXPO_UPDATE_FLAGS (expo, MPFR_FLAGS_DIVBY0);
+          inexact = 0;
+        }
+      else if (cos_kernel)
+        inexact = mpfr_set_si (y, neg ? -1 : 1, rnd_mode);
+      else if (kind == TRIGU_COS)
+        {
+          /* cos(Pi/2) = cos(3Pi/2) = +0 */
+          MPFR_SET_ZERO (y);
+          MPFR_SET_POS (y);
+          inexact = 0;
+        }
+      else
+        {
+          /* sin(k*Pi) has the sign of x; tan(k*Pi) has the sign of x if
+             k is even, the opposite sign otherwise */
+          MPFR_SET_ZERO (y);
+          MPFR_SET_SAME_SIGN (y, x);
+          if (kind == TRIGU_TAN && q == 2)
+            MPFR_CHANGE_SIGN (y);
+          inexact = 0;
+        }
+      goto end;
+    }
+
+  if (kind == TRIGU_TAN || ! cos_kernel)
+    {
+      mpfr_t z;
+      int exact;
+
+      /* 8*xr and 12*xr are exact on PREC(xr)+4 bits */
+      mpfr_init2 (z, MPFR_PREC (xr) + 4);
+      mpfr_mul_ui (z, xr, (kind == TRIGU_TAN) ? 8 : 12, MPFR_RNDN);
+      MPFR_SET_POS (z);
+      exact = mpfr_cmp_ui (z, u) == 0;
+      mpfr_clear (z);
+      if (exact)
+        {
+          /* sin(Pi/6) = 1/2, tan(Pi/4) = cot(Pi/4) = 1, all odd functions */
+          if (MPFR_IS_NEG (xr))
+            neg = !neg;
+          inexact = mpfr_set_si_2exp (y, neg ? -1 : 1,
+                                      (kind == TRIGU_TAN) ? 0 : -1, rnd_mode);
+          goto end;
+        }
+    }
+
+  /* If a = 2*Pi*xr/u is below the extended exponent range, which can only
+     happen when xr = x, scale xr by 2^k: since sin(a) and tan(a) are
+     a*(1+O(a^2)), the result is the scaled one times 2^(-k). */
+  if (MPFR_UNLIKELY (MPFR_GET_EXP (xr) < MPFR_EMIN_MIN + ULONG_BITS))
+    {
+      MPFR_ASSERTD (q == 0 && kind != TRIGU_COS);
+      k = ULONG_BITS;
+      mpfr_mul_2si (xr, xr, k, MPFR_RNDN); /* exact */
+    }
+
+  precy = MPFR_PREC (y);
+  w = precy + MPFR_INT_CEIL_LOG2 (precy) + 10;
+  mpfr_init2 (t, w);
+  MPFR_ZIV_INIT (loop, w);
+  for (;;)
+    {
+      mpfr_const_pi (t, MPFR_RNDN);
+      mpfr_mul (t, t, xr, MPFR_RNDN);
+      mpfr_mul_2ui (t, t, 1, MPFR_RNDN);
+      mpfr_div_ui (t, t, u, MPFR_RNDN);
+      /* The relative error on a is at most (1+2^(-w))^3 - 1 < 2^(2-w).
+         Since |a| <= Pi/4, the relative error on sin(a) or tan(a) is at
+         most the relative error on a times a*cos(a)/sin(a) <= 1 or
+         2a/sin(2a) < Pi/2 respectively, and the one on cos(a) is at most
+         a*tan(a)*2^(2-w) < 2^(2-w). Adding the final rounding, and the one
+         of 1/tan(a), the relative error is less than 2^(4-w), thus the
+         error is less than 2^(EXP(t)+5-w). If k != 0, we use
+         sin(a) ~ tan(a) ~ a, with a relative error of at most
+         a^2 < 2^(2*(MPFR_EMIN_MIN+ULONG_BITS)), which is covered by the
+         above bound. */
+      if (k == 0)
+        {
+          if (cos_kernel)
+            mpfr_cos (t, t, MPFR_RNDN);
+          else if (kind == TRIGU_TAN)
+            {
+              mpfr_tan (t, t, MPFR_RNDN);
+              if (cot)
+                mpfr_ui_div (t, 1, t, MPFR_RNDN);
+            }
+          else
+            mpfr_sin (t, t, MPFR_RNDN);
+        }
+      if (MPFR_LIKELY (MPFR_CAN_ROUND (t, w - 5, precy, rnd_mode)))
+        break;
+      MPFR_ZIV_NEXT (loop, w);
+      mpfr_set_prec (t, w);
+    }
+  MPFR_ZIV_FREE (loop);
+
+  if (neg)
+    MPFR_CHANGE_SIGN (t);
+  inexact = mpfr_set (y, t, rnd_mode);
+  mpfr_clear (t);
+
+ end:
+  mpfr_clear (xr);
+  MPFR_SAVE_EXPO_FREE (expo);
+  if (MPFR_UNLIKELY (k != 0))
+    {
+      int inex2;
+
+      /* See mpfr_pow_general: in the underflow case for MPFR_RNDN with
+         |y| = 2^(emin-2) after scaling, the exact result is larger in
+         absolute value if inexact has the opposite sign of y. */
+      if (rnd_mode == MPFR_RNDN && MPFR_INT_SIGN (y) * inexact < 0
+          && MPFR_GET_EXP (y) == __gmpfr_emin - 1 + k
+          && mpfr_powerof2_raw (y))
+        {
+          MPFR_ASSERTN (MPFR_PREC_MIN > 1);
+          mpfr_nexttoinf (y);
+        }
+      inex2 = mpfr_mul_2si (y, y, -k, rnd_mode);
+      if (inex2 != 0) /* underflow */
+        return inex2;
+    }
+  return mpfr_check_range (y, inexact, rnd_mode);
+}
+
+/* sinu(x) = sin(2*Pi*x/u) */
+int
+mpfr_sinu (mpfr_ptr y, mpfr_srcptr x, unsigned long u, mpfr_rnd_t rnd_mode)
+{
+  return trigu (y, x, u, rnd_mode, TRIGU_SIN);
+}
+
+/* cosu(x) = cos(2*Pi*x/u) */
+int
+mpfr_cosu (mpfr_ptr y, mpfr_srcptr x, unsigned long u, mpfr_rnd_t rnd_mode)
+{
+  return trigu (y, x, u, rnd_mode, TRIGU_COS);
+}
+
+/* tanu(x) = tan(2*Pi*x/u) */
+int
+mpfr_tanu (mpfr_ptr y, mpfr_srcptr x, unsigned long u, mpfr_rnd_t rnd_mode)
+{
+  return trigu (y, x, u, rnd_mode, TRIGU_TAN);
+}
+
+/* sinpi(x) = sin(Pi*x) */
+int
+mpfr_sinpi (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  return trigu (y, x, 2, rnd_mode, TRIGU_SIN);
+}
+
+/* cospi(x) = cos(Pi*x) */
+int
+mpfr_cospi (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  return trigu (y, x, 2, rnd_mode, TRIGU_COS);
+}
+
+/* tanpi(x) = tan(Pi*x) */
+int
+mpfr_tanpi (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd_mode)
+{
+  return trigu (y, x, 2, rnd_mode, TRIGU_TAN);
+}
@@ -0,0 +1,372 @@
+/* mpfr_urandom_vec, mpfr_urandomb_vec -- arrays of uniform random numbers
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#define MPFR_NEED_LONGLONG_H
+#include "mpfr-impl.h"
+
+/* mpfr_urandom and mpfr_urandomb call the random generator for each
+   number, and mpfr_urandom even calls it for the exponent and for the
+   rounding bit, so that most of the bits produced by the generator are
+   discarded for small precisions. Here the random bits are drawn by
+   chunks of at least STREAM_BITS bits, and read as a stream (the least
+   significant bit first). Since the sizes of the chunks do not depend on
+   GMP_NUMB_BITS, the results only depend on the random state, on the
+   precisions and on the rounding mode, like for mpfr_urandomb. */
+#define STREAM_BITS 8192
+
+typedef struct {
+  mp_limb_t *p;     /* the bits not read yet are the bits pos to end-1 */
+  mp_limb_t *t;     /* space for the new bits */
+  mp_size_t alloc;  /* number of limbs allocated for p and for t */
+  mpfr_prec_t pos, end;
+} bit_stream;
+
+static void
+stream_init (bit_stream *s)
+{
+  s->alloc = 0;
+  s->pos = s->end = 0;
+}
+
+static void
+stream_clear (bit_stream *s)
+{
+  if (s->alloc != 0)
+    {
+      (*__gmp_free_func) (s->p, s->alloc * BYTES_PER_MP_LIMB);
+      (*__gmp_free_func) (s->t, s->alloc * BYTES_PER_MP_LIMB);
+    }
+}
+
+/* Make sure that at least k bits can be read from s. The limb following
+   the last bit is allocated and set to 0, so that stream_get can read it. */
+static void
+stream_fill (bit_stream *s, mpfr_prec_t k, gmp_randstate_t rstate)
+{
+  mpfr_prec_t avail, m;
+  mp_size_t i, n, nt, na;
+  int sh;
+
+  avail = s->end - s->pos;
+  if (avail >= k)
+    return;
+  m = MAX (k - avail, STREAM_BITS);
+
+  /* move the remaining bits to the bottom of p */
+  i = s->pos / GMP_NUMB_BITS;
+  sh = s->pos % GMP_NUMB_BITS;
+  if (i != 0 || sh != 0)  /* then end >= pos > 0 */
+    {
+      na = MPFR_PREC2LIMBS (s->end) - i;
+      if (sh != 0)
+        mpn_rshift (s->p, s->p + i, na, sh);
+      else
+        MPN_COPY_INCR (s->p, s->p + i, na);
+    }
+
+  n = MPFR_PREC2LIMBS (avail + m);
+  if (n + 1 > s->alloc)
+    {
+      size_t size = (n + 1) * BYTES_PER_MP_LIMB;
+
+      if (s->alloc == 0)
+        s->p = (mp_limb_t *) (*__gmp_allocate_func) (size);
+      else
+        {
+          s->p = (mp_limb_t *) (*__gmp_reallocate_func)
+            (s->p, s->alloc * BYTES_PER_MP_LIMB, size);
+          (*__gmp_free_func) (s->t, s->alloc * BYTES_PER_MP_LIMB);
+        }
+      s->t = (mp_limb_t *) (*__gmp_allocate_func) (size);
+      s->alloc = n + 1;
+    }
+
+  /* append m new bits */
+  nt = MPFR_PREC2LIMBS (m);
+  mpfr_rand_raw (s->t, rstate, m);
+  i = avail / GMP_NUMB_BITS;
+  sh = avail % GMP_NUMB_BITS;
+  if (sh == 0)
+    MPN_COPY (s->p + i, s->t, nt);
+  else
+    {
+      mp_limb_t low, cy;
+
+      low = s->p[i] & MPFR_LIMB_MASK (sh);
+      cy = mpn_lshift (s->p + i, s->t, nt, sh);
+      s->p[i] |= low;
+      if (i + nt < n)
+        s->p[i + nt] = cy;
+    }
+  s->p[n] = 0;
+  s->pos = 0;
+  s->end = avail + m;
+}
+
+/* Read k >= 1 bits from s, and store them shifted by d bits to the left
+   into the n limbs of rp, the other bits of rp being set to 0, where
+   0 <= d < GMP_NUMB_BITS and (n - 1) * GMP_NUMB_BITS < d + k <= n *
+   GMP_NUMB_BITS. This puts the bits directly at their place in the
+   significand. */
+static void
+stream_get (mpfr_limb_ptr rp, mp_size_t n, int d, mpfr_prec_t k,
+            bit_stream *s, gmp_randstate_t rstate)
+{
+  mp_limb_t *sp;
+  int c, t;
+
+  stream_fill (s, k, rstate);
+  sp = s->p + s->pos / GMP_NUMB_BITS;
+  c = s->pos % GMP_NUMB_BITS - d;
+  if (n == 1)
+    {
+      if (c > 0)
+        rp[0] = (sp[0] >> c) | (sp[1] << (GMP_NUMB_BITS - c));
+      else
+        rp[0] = sp[0] << -c;
+    }
+  else if (c > 0)
+    {
+      mpn_rshift (rp, sp, n, c);
+      rp[n - 1] |= sp[n] << (GMP_NUMB_BITS - c);
+    }
+  else if (c < 0)
+    mpn_lshift (rp, sp, n, -c);
+  else
+    MPN_COPY (rp, sp, n);
+  rp[0] &= ~MPFR_LIMB_MASK (d);
+  t = (d + k) % GMP_NUMB_BITS;
+  if (t != 0)
+    rp[n - 1] &= MPFR_LIMB_MASK (t);
+  s->pos += k;
+}
+
+/* Read one bit from s. */
+static int
+stream_bit (bit_stream *s, gmp_randstate_t rstate)
+{
+  int b;
+
+  stream_fill (s, 1, rstate);
+  b = (s->p[s->pos / GMP_NUMB_BITS] >> (s->pos % GMP_NUMB_BITS)) & 1;
+  s->pos++;
+  return b;
+}
+
+/* Read bits from s until a 1 is read or limit zeros are read, and return
+   the number of zeros read. */
+static mpfr_uexp_t
+stream_zeros (bit_stream *s, mpfr_uexp_t limit, gmp_randstate_t rstate)
+{
+  mpfr_uexp_t z = 0;
+  mpfr_prec_t avail;
+  mp_limb_t l;
+  int sh, cnt;
+
+  while (z < limit)
+    {
+      stream_fill (s, 1, rstate);
+      sh = s->pos % GMP_NUMB_BITS;
+      l = s->p[s->pos / GMP_NUMB_BITS] >> sh;
+      avail = MIN (GMP_NUMB_BITS - sh, s->end - s->pos);
+      if (avail < GMP_NUMB_BITS)
+        l &= MPFR_LIMB_MASK (avail);
+      if (l == 0)
+        cnt = avail;
+      else
+        count_trailing_zeros (cnt, l);
+      if ((mpfr_uexp_t) cnt >= limit - z)
+        {
+          s->pos += limit - z;
+          return limit;
+        }
+      z += cnt;
+      s->pos += cnt;
+      if (l != 0)
+        {
+          s->pos++;  /* the 1 bit */
+          return z;
+        }
+    }
+  return z;
+}
+
+/* Same as mpfr_urandomb, reading the bits from s. */
+static int
+urandomb_stream (mpfr_ptr rop, bit_stream *s, gmp_randstate_t rstate)
+{
+  mpfr_limb_ptr rp;
+  mpfr_prec_t nbits;
+  mp_size_t nlimbs;
+  mp_size_t k; /* number of high zero limbs */
+  mpfr_exp_t exp;
+  int cnt;
+
+  rp = MPFR_MANT (rop);
+  nbits = MPFR_PREC (rop);
+  nlimbs = MPFR_LIMB_SIZE (rop);
+  MPFR_SET_POS (rop);
+  cnt = nlimbs * GMP_NUMB_BITS - nbits;
+
+  stream_get (rp, nlimbs, cnt, nbits, s, rstate);
+
+  exp = 0;
+  k = 0;
+  while (nlimbs != 0 && rp[nlimbs - 1] == 0)
+    {
+      k ++;
+      nlimbs --;
+      exp -= GMP_NUMB_BITS;
+    }
+
+  if (MPFR_LIKELY (nlimbs != 0)) /* otherwise value is zero */
+    {
+      count_leading_zeros (cnt, rp[nlimbs - 1]);
+      if (mpfr_set_exp (rop, exp - cnt))
+        {
+          /* see mpfr_urandomb */
+          MPFR_SET_NAN (rop);
+          __gmpfr_flags |= MPFR_FLAGS_NAN;
+          return 1;
+        }
+      if (nlimbs == 1)
+        rp[k] = rp[0] << cnt;
+      else if (cnt != 0)
+        mpn_lshift (rp + k, rp, nlimbs, cnt);
+      if (k != 0)
+        MPN_ZERO (rp, k);
+    }
+  else
+    MPFR_SET_ZERO (rop);
+
+  return 0;
+}
+
+/* Same as mpfr_urandom, reading the bits from s: the exponent is given by
+   the number of leading zeros, then follow the bits of the significand
+   after the leading 1, then the rounding bit for MPFR_RNDN. */
+static int
+urandom_stream (mpfr_ptr rop, bit_stream *s, gmp_randstate_t rstate,
+                mpfr_rnd_t rnd_mode)
+{
+  mpfr_limb_ptr rp;
+  mpfr_prec_t nbits;
+  mp_size_t nlimbs;
+  mp_size_t n;
+  mpfr_exp_t exp;
+  mpfr_exp_t emin;
+  mpfr_uexp_t z;
+  int inex;
+
+  rp = MPFR_MANT (rop);
+  nbits = MPFR_PREC (rop);
+  nlimbs = MPFR_LIMB_SIZE (rop);
+  MPFR_SET_POS (rop);
+  emin = mpfr_get_emin ();
+  if (MPFR_UNLIKELY (emin > 0))
+    {
+      if (rnd_mode == MPFR_RNDU || rnd_mode == MPFR_RNDA
+          || (emin == 1 && rnd_mode == MPFR_RNDN && stream_bit (s, rstate)))
+        {
+          mpfr_set_ui_2exp (rop, 1, emin - 1, rnd_mode);
+          return +1;
+        }
+      else
+        {
+          MPFR_SET_ZERO (rop);
+          return -1;
+        }
+    }
+
+  /* Exponent: after 1 - emin leading zeros, the random number is less
+     than 2^(emin-1), and rounds to nearest to 2^(emin-1) iff the next
+     bit is 1. */
+  z = stream_zeros (s, (mpfr_uexp_t) 1 - emin, rstate);
+  if (MPFR_UNLIKELY (z == (mpfr_uexp_t) 1 - emin))
+    {
+      if (rnd_mode == MPFR_RNDU || rnd_mode == MPFR_RNDA
+          || (rnd_mode == MPFR_RNDN && stream_bit (s, rstate)))
+        {
+          mpfr_set_ui_2exp (rop, 1, emin - 1, rnd_mode);
+          return +1;
+        }
+      else
+        {
+          MPFR_SET_ZERO (rop);
+          return -1;
+        }
+    }
+  exp = - (mpfr_exp_t) z;
+  MPFR_EXP (rop) = exp; /* Warning: may be outside the current
+                           exponent range */
+
+  /* Significand */
+  n = nlimbs * GMP_NUMB_BITS - nbits;
+  stream_get (rp, nlimbs, n, nbits - 1, s, rstate);
+  rp[nlimbs - 1] |= MPFR_LIMB_HIGHBIT;
+
+  /* Rounding */
+  if (rnd_mode == MPFR_RNDU || rnd_mode == MPFR_RNDA
+      || (rnd_mode == MPFR_RNDN && stream_bit (s, rstate)))
+    {
+      /* add one ulp: an overflow is detected by mpfr_check_range */
+      if (mpn_add_1 (rp, rp, nlimbs, MPFR_LIMB_ONE << n) != 0)
+        {
+          rp[nlimbs - 1] = MPFR_LIMB_HIGHBIT;
+          MPFR_EXP (rop) = exp + 1;
+        }
+      inex = +1;
+    }
+  else
+    inex = -1;
+
+  return mpfr_check_range (rop, inex, rnd_mode);
+}
+
+int
+mpfr_urandomb_vec (mpfr_ptr *rop, unsigned long n, gmp_randstate_t rstate)
+{
+  bit_stream s;
+  unsigned long i;
+  int res = 0;
+
+  stream_init (&s);
+  for (i = 0; i < n; i++)
+    res |= urandomb_stream (rop[i], &s, rstate);
+  stream_clear (&s);
+  return res;
+}
+
+int
+mpfr_urandom_vec (mpfr_ptr *rop, unsigned long n, gmp_randstate_t rstate,
+                  mpfr_rnd_t rnd_mode)
+{
+  bit_stream s;
+  unsigned long i;
+  int res = 0;
+
+  stream_init (&s);
+  for (i = 0; i < n; i++)
+    res |= urandom_stream (rop[i], &s, rstate, rnd_mode) != 0;
+  stream_clear (&s);
+  return res;
+}
@@ -77,21 +77,25 @@ mpfr_zeta_part_b (mpfr_t b, mpfr_srcptr s, int n, int p, mpfr_t *tc)
   MPFR_GROUP_CLEAR (group);
 }
 
-/* Input: p - an integer
-   Output: fills tc[1..p], tc[i] = bernoulli(2i)/(2i)!
+/* Input: p0, p - integers, with tc[1..p0] already computed
+   Output: fills tc[p0+1..p], tc[i] = bernoulli(2i)/(2i)!
    tc[1]=1/12, tc[2]=-1/720, tc[3]=1/30240, ...
 */
 static void
-mpfr_zeta_c (int p, mpfr_t *tc)
+mpfr_zeta_c (int p0, int p, mpfr_t *tc)
 {
   mpfr_t d;
   int k, l;
 
-  if (p > 0)
+  if (p > p0)
     {
-      mpfr_init2 (d, MPFR_PREC (tc[1]));
-      mpfr_div_ui (tc[1], __gmpfr_one, 12, MPFR_RNDN);
-      for (k = 2; k <= p; k++)
+      mpfr_init2 (d, MPFR_PREC (tc[p]));
+      if (p0 == 0)
+        {
+          mpfr_div_ui (tc[1], __gmpfr_one, 12, MPFR_RNDN);
+          p0 = 1;
+        }
+      for (k = p0 + 1; k <= p; k++)
         {
           mpfr_set_ui (d, k-1, MPFR_RNDN);
           mpfr_div_ui (d, d, 12*k+6, MPFR_RNDN);
@@ -107,6 +111,66 @@ mpfr_zeta_c (int p, mpfr_t *tc)
     }
 }
 
+/* The coefficients tc[1..zeta_tc_size] computed by mpfr_zeta_c with
+   precision zeta_tc_prec are kept across calls, since they only depend
+   on the working precision. */
+static MPFR_THREAD_ATTR mpfr_t *zeta_tc = NULL;
+static MPFR_THREAD_ATTR int zeta_tc_size = 0;
+static MPFR_THREAD_ATTR int zeta_tc_alloc = 0;
+static MPFR_THREAD_ATTR mpfr_prec_t zeta_tc_prec = 0;
+
+/* Make zeta_tc[1..p] hold the coefficients with precision prec.
+   Return 0 if they would take more than MPFR_CACHE_TABLE_LIMBS limbs. */
+static int
+mpfr_zeta_tc_cache (int p, mpfr_prec_t prec)
+{
+  int l;
+
+  if ((unsigned long) (p + 1) * MPFR_PREC2LIMBS (prec)
+      > MPFR_CACHE_TABLE_LIMBS)
+    return 0;
+  if (prec != zeta_tc_prec)
+    {
+      for (l = 1; l <= zeta_tc_size; l++)
+        mpfr_clear (zeta_tc[l]);
+      zeta_tc_size = 0;
+      zeta_tc_prec = prec;
+    }
+  if (p > zeta_tc_size)
+    {
+      if (p >= zeta_tc_alloc)
+        {
+          if (zeta_tc_alloc == 0)
+            zeta_tc = (mpfr_t *) (*__gmp_allocate_func)
+              ((p + 1) * sizeof (mpfr_t));
+          else
+            zeta_tc = (mpfr_t *) (*__gmp_reallocate_func)
+              (zeta_tc, zeta_tc_alloc * sizeof (mpfr_t),
+               (p + 1) * sizeof (mpfr_t));
+          zeta_tc_alloc = p + 1;
+        }
+      for (l = zeta_tc_size + 1; l <= p; l++)
+        mpfr_init2 (zeta_tc[l], prec);
+      mpfr_zeta_c (zeta_tc_size, p, zeta_tc);
+      zeta_tc_size = p;
+    }
+  return 1;
+}
+
+void
+mpfr_zeta_freecache (void)
+{
+  int l;
+
+  for (l = 1; l <= zeta_tc_size; l++)
+    mpfr_clear (zeta_tc[l]);
+  if (zeta_tc_alloc != 0)
+    (*__gmp_free_func) (zeta_tc, zeta_tc_alloc * sizeof (mpfr_t));
+  zeta_tc = NULL;
+  zeta_tc_size = zeta_tc_alloc = 0;
+  zeta_tc_prec = 0;
+}
+
 /* Input: s - a floating-point number
           n - an integer
    Output: sum - a floating-point number approximating sum(1/i^s, i=1..n-1) */
@@ -145,7 +209,7 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
   double beta, sd, dnep;
   mpfr_t *tc1;
   mpfr_prec_t precz, precs, d, dint;
-  int p, n, l, add;
+  int p, n, l, add, cached;
   int inex;
   MPFR_GROUP_DECL (group);
   MPFR_ZIV_DECL (loop);
@@ -245,17 +309,24 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
           MPFR_TRACE (printf ("internal precision=%lu\n",
                               (unsigned long) dint));
 
-          size = (p + 1) * sizeof(mpfr_t);
-          tc1 = (mpfr_t*) (*__gmp_allocate_func) (size);
-          for (l=1; l<=p; l++)
-            mpfr_init2 (tc1[l], dint);
+          /* Computation of the coefficients c_k, or reuse of those of a
+             previous call with the same working precision */
+          cached = mpfr_zeta_tc_cache (p, dint);
+          if (cached)
+            tc1 = zeta_tc;
+          else
+            {
+              size = (p + 1) * sizeof(mpfr_t);
+              tc1 = (mpfr_t*) (*__gmp_allocate_func) (size);
+              for (l=1; l<=p; l++)
+                mpfr_init2 (tc1[l], dint);
+              mpfr_zeta_c (0, p, tc1);
+            }
           MPFR_GROUP_REPREC_4 (group, dint, b, c, z_pre, f);
 
           MPFR_TRACE (printf ("precision of z = %lu\n",
                               (unsigned long) precz));
 
-          /* Computation of the coefficients c_k */
-          mpfr_zeta_c (p, tc1);
           /* Computation of the 3 parts of the fonction Zeta. */
           mpfr_zeta_part_a (z_pre, s, n);
           mpfr_zeta_part_b (b, s, n, p, tc1);
@@ -266,9 +337,12 @@ mpfr_zeta_pos (mpfr_t z, mpfr_srcptr s, mpfr_rnd_t rnd_mode)
           MPFR_TRACE (MPFR_DUMP (c));
           mpfr_add (z_pre, z_pre, c, MPFR_RNDN);
           mpfr_add (z_pre, z_pre, b, MPFR_RNDN);
-          for (l=1; l<=p; l++)
-            mpfr_clear (tc1[l]);
-          (*__gmp_free_func) (tc1, size);
+          if (!cached)
+            {
+              for (l=1; l<=p; l++)
+                mpfr_clear (tc1[l]);
+              (*__gmp_free_func) (tc1, size);
+            }
           /* End branch 2 */
         }
 
@@ -23,6 +23,138 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define MPFR_NEED_LONGLONG_H
 #include "mpfr-impl.h"
 
+/* We use Borwein's algorithm: zeta(m) is approximated by
+   sum((-1)^(k-1)*d[k]/k^m, k=1..n)/d[0]/(1-2^(1-m)), where
+   d[k] = sum(t[i], i=k..n) and t[i] = n*(n+i-1)!*4^i/(n-i)!/(2i)!. */
+
+/* Set d to d[k-1] and t to t[k-1] from d = d[k] and t = t[k].
+   t[k-1]/t[k] = k*(2k-1)/(n-k+1)/(n+k-1)/2 */
+static void
+zeta_ui_next (mpz_ptr t, mpz_ptr d, unsigned long n, unsigned long k)
+{
+#if (GMP_NUMB_BITS == 32)
+#define KMAX 46341 /* max k such that k*(2k-1) < 2^32 */
+#elif (GMP_NUMB_BITS == 64)
+#define KMAX 3037000500
+#endif
+#ifdef KMAX
+  if (k <= KMAX)
+    mpz_mul_ui (t, t, k * (2 * k - 1));
+  else
+#endif
+    {
+      mpz_mul_ui (t, t, k);
+      mpz_mul_ui (t, t, 2 * k - 1);
+    }
+  mpz_fdiv_q_2exp (t, t, 1);
+  /* Warning: the test below assumes that an unsigned long
+     has no padding bits. */
+  if (n < 1UL << ((sizeof(unsigned long) * CHAR_BIT) / 2))
+    /* (n - k + 1) * (n + k - 1) < n^2 */
+    mpz_divexact_ui (t, t, (n - k + 1) * (n + k - 1));
+  else
+    {
+      mpz_divexact_ui (t, t, n - k + 1);
+      mpz_divexact_ui (t, t, n + k - 1);
+    }
+  mpz_add (d, d, t);
+}
+
+/* Set q to floor(d/k^m). */
+static void
+zeta_ui_div (mpz_ptr q, mpz_srcptr d, unsigned long k, unsigned long m)
+{
+  unsigned long kbits;
+
+  count_leading_zeros (kbits, k);
+  kbits = GMP_NUMB_BITS - kbits;
+  /* if k^m is too large, use mpz_tdiv_q */
+  if (m * kbits > 2 * GMP_NUMB_BITS)
+    {
+      /* if we know in advance that k^m > d, then floor(d/k^m) will
+         be zero below, so there is no need to compute k^m */
+      kbits = (kbits - 1) * m + 1;
+      /* k^m has at least kbits bits */
+      if (kbits > mpz_sizeinbase (d, 2))
+        mpz_set_ui (q, 0);
+      else
+        {
+          mpz_ui_pow_ui (q, k, m);
+          mpz_tdiv_q (q, d, q);
+        }
+    }
+  else /* use several mpz_tdiv_q_ui calls */
+    {
+      unsigned long km = k, mm = m - 1;
+      while (mm > 0 && km < ULONG_MAX / k)
+        {
+          km *= k;
+          mm --;
+        }
+      mpz_tdiv_q_ui (q, d, km);
+      while (mm > 0)
+        {
+          km = k;
+          mm --;
+          while (mm > 0 && km < ULONG_MAX / k)
+            {
+              km *= k;
+              mm --;
+            }
+          mpz_tdiv_q_ui (q, q, km);
+        }
+    }
+}
+
+/* The d[k] only depend on n, thus the table zeta_ui_d[0..zeta_ui_n] is
+   kept across calls (zeta_ui_n = 0 when it is empty). */
+static MPFR_THREAD_ATTR mpz_t *zeta_ui_d = NULL;
+static MPFR_THREAD_ATTR unsigned long zeta_ui_n = 0;
+
+/* Return the table of the d[k] for 0 <= k <= n, or NULL if it would take
+   more than MPFR_CACHE_TABLE_LIMBS limbs. */
+static mpz_t *
+zeta_ui_table (unsigned long n)
+{
+  mpz_t t;
+  unsigned long k;
+
+  if (n == zeta_ui_n)
+    return zeta_ui_d;
+  /* d[0] < (3+sqrt(8))^n < 2^(3n) */
+  if ((double) (n + 1) * ((3.0 * (double) n) / GMP_NUMB_BITS + 2.0)
+      > (double) MPFR_CACHE_TABLE_LIMBS)
+    return NULL;
+  mpfr_zeta_ui_freecache ();
+  zeta_ui_d = (mpz_t *) (*__gmp_allocate_func) ((n + 1) * sizeof (mpz_t));
+  mpz_init_set_ui (t, 1);
+  mpz_mul_2exp (t, t, 2 * n - 1); /* t[n] */
+  mpz_init_set (zeta_ui_d[n], t);
+  for (k = n; k > 0; k--)
+    {
+      mpz_init_set (zeta_ui_d[k - 1], zeta_ui_d[k]);
+      zeta_ui_next (t, zeta_ui_d[k - 1], n, k);
+    }
+  mpz_clear (t);
+  zeta_ui_n = n;
+  return zeta_ui_d;
+}
+
+void
+mpfr_zeta_ui_freecache (void)
+{
+  unsigned long k;
+
+  if (zeta_ui_n != 0)
+    {
+      for (k = 0; k <= zeta_ui_n; k++)
+        mpz_clear (zeta_ui_d[k]);
+      (*__gmp_free_func) (zeta_ui_d, (zeta_ui_n + 1) * sizeof (mpz_t));
+    }
+  zeta_ui_d = NULL;
+  zeta_ui_n = 0;
+}
+
 int
 mpfr_zeta_ui (mpfr_ptr z, unsigned long m, mpfr_rnd_t r)
 {
@@ -45,8 +177,8 @@ mpfr_zeta_ui (mpfr_ptr z, unsigned long m, mpfr_rnd_t r)
   else /* m >= 2 */
     {
       mpfr_prec_t p = MPFR_PREC(z);
-      unsigned long n, k, err, kbits;
-      mpz_t d, t, s, q;
+      unsigned long n, k, err;
+      mpz_t d, t, s, q, *tab;
       mpfr_t y;
       int inex;
 
@@ -114,84 +246,23 @@ mpfr_zeta_ui (mpfr_ptr z, unsigned long m, mpfr_rnd_t r)
           mpfr_set_prec (y, p);
 
           /* computation of the d[k] */
+          tab = zeta_ui_table (n);
           mpz_set_ui (s, 0);
-          mpz_set_ui (t, 1);
-          mpz_mul_2exp (t, t, 2 * n - 1); /* t[n] */
-          mpz_set (d, t);
+          if (tab == NULL)
+            {
+              mpz_set_ui (t, 1);
+              mpz_mul_2exp (t, t, 2 * n - 1); /* t[n] */
+              mpz_set (d, t);
+            }
           for (k = n; k > 0; k--)
             {
-              count_leading_zeros (kbits, k);
-              kbits = GMP_NUMB_BITS - kbits;
-              /* if k^m is too large, use mpz_tdiv_q */
-              if (m * kbits > 2 * GMP_NUMB_BITS)
-                {
-                  /* if we know in advance that k^m > d, then floor(d/k^m) will
-                     be zero below, so there is no need to compute k^m */
-                  kbits = (kbits - 1) * m + 1;
-                  /* k^m has at least kbits bits */
-                  if (kbits > mpz_sizeinbase (d, 2))
-                    mpz_set_ui (q, 0);
-                  else
-                    {
-                      mpz_ui_pow_ui (q, k, m);
-                      mpz_tdiv_q (q, d, q);
-                    }
-                }
-              else /* use several mpz_tdiv_q_ui calls */
-                {
-                  unsigned long km = k, mm = m - 1;
-                  while (mm > 0 && km < ULONG_MAX / k)
-                    {
-                      km *= k;
-                      mm --;
-                    }
-                  mpz_tdiv_q_ui (q, d, km);
-                  while (mm > 0)
-                    {
-                      km = k;
-                      mm --;
-                      while (mm > 0 && km < ULONG_MAX / k)
-                        {
-                          km *= k;
-                          mm --;
-                        }
-                      mpz_tdiv_q_ui (q, q, km);
-                    }
-                }
+              zeta_ui_div (q, tab != NULL ? tab[k] : d, k, m);
               if (k % 2)
                 mpz_add (s, s, q);
               else
                 mpz_sub (s, s, q);
-
-              /* we have d[k] = sum(t[i], i=k+1..n)
-                 with t[i] = n*(n+i-1)!*4^i/(n-i)!/(2i)!
-                 t[k-1]/t[k] = k*(2k-1)/(n-k+1)/(n+k-1)/2 */
-#if (GMP_NUMB_BITS == 32)
-#define KMAX 46341 /* max k such that k*(2k-1) < 2^32 */
-#elif (GMP_NUMB_BITS == 64)
-#define KMAX 3037000500
-#endif
-#ifdef KMAX
-              if (k <= KMAX)
-                mpz_mul_ui (t, t, k * (2 * k - 1));
-              else
-#endif
-                {
-                  mpz_mul_ui (t, t, k);
-                  mpz_mul_ui (t, t, 2 * k - 1);
-                }
-              mpz_fdiv_q_2exp (t, t, 1);
-              /* Warning: the test below assumes that an unsigned long
-                 has no padding bits. */
-              if (n < 1UL << ((sizeof(unsigned long) * CHAR_BIT) / 2))
-                /* (n - k + 1) * (n + k - 1) < n^2 */
-                mpz_divexact_ui (t, t, (n - k + 1) * (n + k - 1));
-              else
-                {
-                  mpz_divexact_ui (t, t, n - k + 1);
-                  mpz_divexact_ui (t, t, n + k - 1);
-                }
-              mpz_add (d, d, t);
+              if (tab == NULL)
+                zeta_ui_next (t, d, n, k);
             }
 
           /* multiply by 1/(1-2^(1-m)) = 1 + 2^(1-m) + 2^(2-m) + ... */
@@ -206,7 +277,7 @@ mpfr_zeta_ui (mpfr_ptr z, unsigned long m, mpfr_rnd_t r)
 
           /* divide by d[n] */
           mpz_mul_2exp (s, s, p);
-          mpz_tdiv_q (s, s, d);
+          mpz_tdiv_q (s, s, tab != NULL ? tab[0] : d);
           mpfr_set_z (y, s, MPFR_RNDN);
           mpfr_div_2ui (y, y, p, MPFR_RNDN);
 
@@ -228,3 +299,139 @@ mpfr_zeta_ui (mpfr_ptr z, unsigned long m, mpfr_rnd_t r)
       return inex;
     }
 }
+
+/* Set z[i] to zeta(m0+i) for 0 <= i < n, each one rounded to its own
+   precision in the direction rnd_mode. Return 0 iff all the results are
+   exact.
+
+   The values for 2 <= m < p, where p is the maximal precision of the z[i],
+   are computed by a single pass of Borwein's algorithm, with the working
+   precision and the number of terms that mpfr_zeta_ui uses at precision p:
+   the d[k] are shared by all the values of m, and since
+   floor(floor(d[k]/k^(m-1))/k) = floor(d[k]/k^m), the quotient for m+1 is
+   obtained from the quotient for m by a division by k. Thus each sum is
+   the one computed by mpfr_zeta_ui, with the same error bound. The other
+   values, and those that cannot be rounded, are computed by mpfr_zeta_ui.
+   Since the values are independent, a caller may split the range of m
+   among several threads. */
+int
+mpfr_zeta_ui_vec (mpfr_ptr *z, unsigned long m0, unsigned long n,
+                  mpfr_rnd_t rnd_mode)
+{
+  mpfr_prec_t prec = MPFR_PREC_MIN, p;
+  unsigned long ma = 0, mb = 0, nk, m, k, i, j, err;
+  mpz_t d, t, q, *s, *tab;
+  mpfr_t *y = NULL;
+  mpfr_rnd_t r;
+  int inexact = 0, inex;
+  MPFR_SAVE_EXPO_DECL (expo);
+
+  MPFR_LOG_FUNC
+    (("m0=%lu n=%lu rnd=%d", m0, n, rnd_mode),
+     ("inexact=%d", inexact));
+
+  for (i = 0; i < n; i++)
+    prec = MAX (prec, MPFR_PREC (z[i]));
+  r = (rnd_mode == MPFR_RNDA) ? MPFR_RNDU : rnd_mode; /* zeta(m) > 0 */
+
+  /* shared values: ma <= m <= mb */
+  if (n > 0 && m0 < (unsigned long) prec - 1)
+    {
+      ma = MAX (m0, 2);
+      mb = (n - 1 < (unsigned long) prec - 1 - m0) ? m0 + (n - 1)
+        : (unsigned long) prec - 1;
+    }
+  if (ma != 0 && ma <= mb)
+    {
+      MPFR_SAVE_EXPO_MARK (expo);
+
+      p = prec + MPFR_INT_CEIL_LOG2 (prec);
+      p += MPFR_INT_CEIL_LOG2 (p) + 15;
+      /* 0.39321985067869744 = log(2)/log(3+sqrt(8)) */
+      nk = 1 + (unsigned long) (0.39321985067869744 * (double) p);
+
+      s = (mpz_t *) (*__gmp_allocate_func) ((mb - ma + 1) * sizeof (mpz_t));
+      y = (mpfr_t *) (*__gmp_allocate_func) ((mb - ma + 1) * sizeof (mpfr_t));
+      for (j = 0; j <= mb - ma; j++)
+        mpz_init (s[j]);
+      mpz_init (d);
+      mpz_init (t);
+      mpz_init (q);
+
+      tab = zeta_ui_table (nk);
+      if (tab == NULL)
+        {
+          mpz_set_ui (t, 1);
+          mpz_mul_2exp (t, t, 2 * nk - 1); /* t[nk] */
+          mpz_set (d, t);
+        }
+      for (k = nk; k > 0; k--)
+        {
+          zeta_ui_div (q, tab != NULL ? tab[k] : d, k, ma);
+          for (j = 0; ; j++)
+            {
+              if (k % 2)
+                mpz_add (s[j], s[j], q);
+              else
+                mpz_sub (s[j], s[j], q);
+              if (j == mb - ma || mpz_sgn (q) == 0)
+                break;
+              if (k > 1)
+                mpz_tdiv_q_ui (q, q, k);
+            }
+          if (tab == NULL)
+            zeta_ui_next (t, d, nk, k);
+        }
+
+      for (j = 0; j <= mb - ma; j++)
+        {
+          m = ma + j;
+          err = nk + 4;
+          /* multiply by 1/(1-2^(1-m)) = 1 + 2^(1-m) + 2^(2-m) + ... */
+          mpz_fdiv_q_2exp (t, s[j], m - 1);
+          do
+            {
+              err ++;
+              mpz_add (s[j], s[j], t);
+              mpz_fdiv_q_2exp (t, t, m - 1);
+            }
+          while (mpz_cmp_ui (t, 0) > 0);
+          /* divide by d[0] */
+          mpz_mul_2exp (s[j], s[j], p);
+          mpz_tdiv_q (s[j], s[j], tab != NULL ? tab[0] : d);
+          mpfr_init2 (y[j], p);
+          mpfr_set_z (y[j], s[j], MPFR_RNDN);
+          mpfr_div_2ui (y[j], y[j], p, MPFR_RNDN);
+          mpz_clear (s[j]);
+          err = MPFR_INT_CEIL_LOG2 (err);
+          /* the values that cannot be rounded are marked as NaN */
+          if (! MPFR_CAN_ROUND (y[j], p - err, MPFR_PREC (z[m - m0]), r))
+            MPFR_SET_NAN (y[j]);
+        }
+
+      (*__gmp_free_func) (s, (mb - ma + 1) * sizeof (mpz_t));
+      mpz_clear (d);
+      mpz_clear (t);
+      mpz_clear (q);
+      MPFR_SAVE_EXPO_FREE (expo);
+    }
+
+  /* the results are rounded in the user exponent range */
+  for (i = 0; i < n; i++)
+    {
+      m = m0 + i;
+      if (y != NULL && ma <= m && m <= mb && ! MPFR_IS_NAN (y[m - ma]))
+        inex = mpfr_set (z[i], y[m - ma], r);
+      else
+        inex = mpfr_zeta_ui (z[i], m, rnd_mode);
+      inexact |= inex != 0;
+    }
+
+  if (y != NULL)
+    {
+      for (j = 0; j <= mb - ma; j++)
+        mpfr_clear (y[j]);
+      (*__gmp_free_func) (y, (mb - ma + 1) * sizeof (mpfr_t));
+    }
+  return inexact;
+}
@@ -614,6 +614,103 @@ reduced_expo_range (void)
   mpfr_clears (x, y, ex_y, (mpfr_ptr) 0);
 }
 
+/* check the bit-burst code with atan(2) + atan(1/2) = Pi/2 and
+   atan(1/2) - atan(-1/3) = Pi/4 */
+static void
+high_precision (void)
+{
+  mpfr_t x, a, b, c;
+  mpfr_prec_t p = 20000;
+
+  /* x has a small precision, so that a + i*b = 1 + i*x is small too */
+  mpfr_init2 (x, 53);
+  mpfr_inits2 (p, a, b, c, (mpfr_ptr) 0);
+  mpfr_set_ui (x, 1, MPFR_RNDN);
+  mpfr_div_2ui (x, x, 1, MPFR_RNDN);
+  mpfr_atan (a, x, MPFR_RNDN);
+  mpfr_ui_div (x, 1, x, MPFR_RNDN);
+  mpfr_atan (b, x, MPFR_RNDN); /* atan(2) */
+  mpfr_add (b, a, b, MPFR_RNDN);
+  mpfr_const_pi (c, MPFR_RNDN);
+  mpfr_div_2ui (c, c, 1, MPFR_RNDN);
+  mpfr_sub (b, b, c, MPFR_RNDN);
+  if (! MPFR_IS_ZERO (b) && MPFR_GET_EXP (b) > 3 - p)
+    {
+      printf ("Error in high_precision: atan(2) + atan(1/2) <> Pi/2\n");
+      exit (1);
+    }
+  mpfr_set_prec (x, p + 10);
+  mpfr_set_ui (x, 3, MPFR_RNDN);
+  mpfr_ui_div (x, 1, x, MPFR_RNDN);
+  mpfr_neg (x, x, MPFR_RNDN);
+  mpfr_atan (b, x, MPFR_RNDN); /* -atan(1/3) */
+  mpfr_sub (b, a, b, MPFR_RNDN);
+  mpfr_div_2ui (c, c, 1, MPFR_RNDN);
+  mpfr_sub (b, b, c, MPFR_RNDN);
+  if (! MPFR_IS_ZERO (b) && MPFR_GET_EXP (b) > 3 - p)
+    {
+      printf ("Error in high_precision: atan(1/2) + atan(1/3) <> Pi/4\n");
+      exit (1);
+    }
+  mpfr_clears (x, a, b, c, (mpfr_ptr) 0);
+}
+
+/* Check mpfr_atan_bitburst, used by mpfr_atan from MPFR_ATAN_THRESHOLD,
+   against mpfr_atan (thus the generic code) in small precisions and just
+   below the threshold, in all the rounding modes, with the ternary
+   value. */
+static void
+check_bitburst (void)
+{
+  mpfr_t x, y1, y2;
+  mpfr_exp_t emin, emax;
+  int i, rnd, inex1, inex2;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  mpfr_inits2 (MPFR_PREC_MIN, x, y1, y2, (mpfr_ptr) 0);
+  for (i = 0; i < 60; i++)
+    {
+      mpfr_set_prec (x, MPFR_PREC_MIN + randlimb () % 1000);
+      if (i < 10)
+        mpfr_set_prec (y1, MPFR_ATAN_THRESHOLD - 1
+                       - (mpfr_prec_t) (randlimb () % 100));
+      else
+        mpfr_set_prec (y1, MPFR_PREC_MIN + randlimb () % 300);
+      mpfr_set_prec (y2, MPFR_PREC (y1));
+      do
+        mpfr_urandomb (x, RANDS);
+      while (MPFR_IS_ZERO (x));
+      mpfr_mul_2si (x, x, (int) (randlimb () % 40) - 20, MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      if (mpfr_cmpabs (x, __gmpfr_one) == 0)
+        continue;
+      RND_LOOP (rnd)
+        {
+          inex2 = mpfr_atan (y2, x, (mpfr_rnd_t) rnd);
+          set_emin (MPFR_EMIN_MIN);
+          set_emax (MPFR_EMAX_MAX);
+          inex1 = mpfr_atan_bitburst (y1, x, (mpfr_rnd_t) rnd);
+          set_emin (emin);
+          set_emax (emax);
+          if (! mpfr_equal_p (y1, y2) || ! SAME_SIGN (inex1, inex2))
+            {
+              printf ("Error in mpfr_atan_bitburst for rnd=%s\nx=",
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+              mpfr_dump (x);
+              printf ("expected ");
+              mpfr_dump (y2);
+              printf ("got      ");
+              mpfr_dump (y1);
+              printf ("inex1=%d inex2=%d\n", inex1, inex2);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (x, y1, y2, (mpfr_ptr) 0);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -626,6 +723,8 @@ main (int argc, char *argv[])
   atan2_bug_20071003 ();
   atan2_different_prec ();
   reduced_expo_range ();
+  high_precision ();
+  check_bitburst ();
 
   test_generic_atan  (2, 200, 17);
   test_generic_atan2 (2, 200, 17);
@@ -0,0 +1,218 @@
+/* Test file for mpfr_atan2u.
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+/* check that atan2u(y, x, 8) = m, which is exact */
+static void
+check_exact (const char *ys, const char *xs, long m, int neg_zero)
+{
+  mpfr_t x, y, z;
+  int inex;
+
+  mpfr_inits2 (53, x, y, z, (mpfr_ptr) 0);
+  mpfr_set_str (y, ys, 10, MPFR_RNDN);
+  mpfr_set_str (x, xs, 10, MPFR_RNDN);
+  inex = mpfr_atan2u (z, y, x, 8, MPFR_RNDN);
+  if (inex != 0 || mpfr_cmp_si (z, m) != 0
+      || (m == 0 && (neg_zero ? MPFR_IS_POS (z) : MPFR_IS_NEG (z))))
+    {
+      printf ("Error in mpfr_atan2u for y=%s x=%s u=8\n", ys, xs);
+      printf ("expected %ld%s, got ", m, neg_zero ? " (-0)" : "");
+      mpfr_dump (z);
+      exit (1);
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
+static void
+check_special (void)
+{
+  mpfr_t x, y, z;
+
+  mpfr_inits2 (53, x, y, z, (mpfr_ptr) 0);
+  mpfr_set_nan (y);
+  mpfr_set_ui (x, 1, MPFR_RNDN);
+  mpfr_atan2u (z, y, x, 1, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_nan_p (z));
+  mpfr_atan2u (z, x, y, 1, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_nan_p (z));
+  mpfr_atan2u (z, x, x, 0, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_nan_p (z));
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+
+  check_exact ("0", "1", 0, 0);
+  check_exact ("-0", "1", 0, 1);
+  check_exact ("0", "0", 0, 0);
+  check_exact ("-0", "0", 0, 1);
+  check_exact ("0", "-0", 4, 0);
+  check_exact ("-0", "-0", -4, 0);
+  check_exact ("0", "-1", 4, 0);
+  check_exact ("-0", "-1", -4, 0);
+  check_exact ("3", "0", 2, 0);
+  check_exact ("-3", "-0", -2, 0);
+  check_exact ("Inf", "17", 2, 0);
+  check_exact ("-Inf", "17", -2, 0);
+  check_exact ("Inf", "Inf", 1, 0);
+  check_exact ("-Inf", "Inf", -1, 0);
+  check_exact ("Inf", "-Inf", 3, 0);
+  check_exact ("-Inf", "-Inf", -3, 0);
+  check_exact ("17", "Inf", 0, 0);
+  check_exact ("-17", "Inf", 0, 1);
+  check_exact ("17", "-Inf", 4, 0);
+  check_exact ("-17", "-Inf", -4, 0);
+  check_exact ("17", "17", 1, 0);
+  check_exact ("-17", "17", -1, 0);
+  check_exact ("17", "-17", 3, 0);
+  check_exact ("-17", "-17", -3, 0);
+}
+
+/* compare with atan2(y, x) * u / (2*Pi) computed with enough precision */
+static void
+check_random (void)
+{
+  mpfr_t x, y, z, t, pi;
+  mpfr_prec_t p;
+  unsigned long u;
+  mpfr_rnd_t rnd;
+  int n, inex1, inex2;
+
+  mpfr_inits2 (80, x, y, (mpfr_ptr) 0);
+  for (n = 0; n < 500; n++)
+    {
+      mpfr_init2 (z, 2 + (randlimb () % 100));
+      mpfr_urandomb (x, RANDS);
+      mpfr_urandomb (y, RANDS);
+      if (MPFR_IS_ZERO (x) || MPFR_IS_ZERO (y) || mpfr_equal_p (x, y))
+        {
+          mpfr_clear (z);
+          continue;
+        }
+      mpfr_mul_2si (y, y, (int) (randlimb () % 40) - 20, MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (y, y, MPFR_RNDN);
+      u = (n & 1) ? 1 + randlimb () % 360 : randlimb () | 1;
+      rnd = RND_RAND ();
+      inex1 = mpfr_atan2u (z, y, x, u, rnd);
+
+      p = MPFR_PREC (z) + 64;
+      mpfr_inits2 (p, t, pi, (mpfr_ptr) 0);
+      for (;;)
+        {
+          mpfr_atan2 (t, y, x, MPFR_RNDN);
+          mpfr_mul_ui (t, t, u, MPFR_RNDN);
+          mpfr_const_pi (pi, MPFR_RNDN);
+          mpfr_div (t, t, pi, MPFR_RNDN);
+          mpfr_div_2ui (t, t, 1, MPFR_RNDN);
+          if (mpfr_can_round (t, p - 3, MPFR_RNDN, MPFR_RNDZ,
+                              MPFR_PREC (z) + (rnd == MPFR_RNDN)))
+            break;
+          p += p;
+          mpfr_set_prec (t, p);
+          mpfr_set_prec (pi, p);
+        }
+      /* the error interval of t contains no number representable on
+         PREC(z) + 1 bits, thus the sign of z - t is that of the ternary
+         value */
+      inex2 = mpfr_cmp (z, t);
+      mpfr_prec_round (t, MPFR_PREC (z), rnd);
+      if (! mpfr_equal_p (t, z) || ! SAME_SIGN (inex1, inex2))
+        {
+          printf ("Error in mpfr_atan2u for u=%lu rnd=%s\ny=", u,
+                  mpfr_print_rnd_mode (rnd));
+          mpfr_dump (y);
+          printf ("x=");
+          mpfr_dump (x);
+          printf ("expected ");
+          mpfr_dump (t);
+          printf ("got      ");
+          mpfr_dump (z);
+          printf ("inex1 = %d\n", inex1);
+          exit (1);
+        }
+      mpfr_clears (z, t, pi, (mpfr_ptr) 0);
+    }
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+}
+
+/* atan2(y, x) underflows in the extended exponent range, but not
+   atan2(y, x) * u / (2*Pi) */
+static void
+check_underflow (void)
+{
+  mpfr_t x, y, z, t;
+  mpfr_exp_t emin, emax;
+  int inex;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  set_emin (MPFR_EMIN_MIN);
+  set_emax (MPFR_EMAX_MAX);
+
+  mpfr_inits2 (53, x, y, z, t, (mpfr_ptr) 0);
+  mpfr_set_ui_2exp (y, 1, MPFR_EMIN_MIN + 10, MPFR_RNDN);
+  mpfr_set_ui_2exp (x, 1, 20, MPFR_RNDN);
+  /* atan2(y, x) ~ 2^(MPFR_EMIN_MIN-10) */
+  inex = mpfr_atan2u (z, y, x, 1UL << 31, MPFR_RNDN);
+  /* expected: 2^(MPFR_EMIN_MIN+20)/Pi rounded to nearest */
+  mpfr_const_pi (t, MPFR_RNDN);
+  mpfr_ui_div (t, 1, t, MPFR_RNDN);
+  mpfr_mul_2si (t, t, MPFR_EMIN_MIN + 20, MPFR_RNDN);
+  if (! mpfr_equal_p (z, t) || inex == 0)
+    {
+      printf ("Error in check_underflow\nexpected ");
+      mpfr_dump (t);
+      printf ("got      ");
+      mpfr_dump (z);
+      exit (1);
+    }
+
+  /* result below 2^(emin-2): +0 for MPFR_RNDN */
+  mpfr_set_ui_2exp (y, 1, MPFR_EMIN_MIN, MPFR_RNDN);
+  mpfr_set_ui_2exp (x, 1, 200, MPFR_RNDN);
+  mpfr_clear_flags ();
+  inex = mpfr_atan2u (z, y, x, 1000, MPFR_RNDN);
+  MPFR_ASSERTN (MPFR_IS_ZERO (z) && MPFR_IS_POS (z) && inex < 0);
+  MPFR_ASSERTN (mpfr_underflow_p ());
+
+  mpfr_clears (x, y, z, t, (mpfr_ptr) 0);
+  set_emin (emin);
+  set_emax (emax);
+}
+
+int
+main (int argc, char *argv[])
+{
+  tests_start_mpfr ();
+
+  check_special ();
+  check_random ();
+  check_underflow ();
+
+  tests_end_mpfr ();
+  return 0;
+}
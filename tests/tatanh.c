@@ -168,12 +168,34 @@ special (void)
   mpfr_clear (z);
 }
 
+/* Check an input with many more bits than the output, close to 0 and
+   to 1. */
+static void
+large_input_prec (void)
+{
+  mpfr_t x;
+  int i;
+
+  mpfr_init2 (x, 3000);
+  for (i = 0; i < 20; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      if (i & 1)
+        mpfr_div_2ui (x, x, randlimb () % 100, MPFR_RNDN);
+      else
+        mpfr_ui_sub (x, 1, x, MPFR_RNDN);
+      tests_large_input (mpfr_atanh, x, "mpfr_atanh");
+    }
+  mpfr_clear (x);
+}
+
 int
 main (int argc, char *argv[])
 {
   tests_start_mpfr ();
 
   special ();
+  large_input_prec ();
 
   test_generic (2, 100, 25);
 
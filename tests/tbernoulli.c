@@ -0,0 +1,252 @@
+/* Test file for the Bernoulli numbers cache.
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+#define NMAX 120
+
+/* Compute B[0], ..., B[2*NMAX] with the Akiyama-Tanigawa algorithm, and
+   compare B[2n]*(2n+1)! with mpfr_bernoulli_cache(n). The entries from
+   n = 40 are computed from zeta(2n). */
+static void
+check_exact (void)
+{
+  mpq_t a[2 * NMAX + 1], t;
+  mpz_t c;
+  unsigned long m, j;
+
+  mpq_init (t);
+  mpz_init (c);
+  for (m = 0; m <= 2 * NMAX; m++)
+    {
+      mpq_init (a[m]);
+      mpq_set_ui (a[m], 1, m + 1);
+      for (j = m; j >= 1; j--)
+        {
+          /* a[j-1] <- j*(a[j-1] - a[j]) */
+          mpq_sub (a[j-1], a[j-1], a[j]);
+          mpq_set_ui (t, j, 1);
+          mpq_mul (a[j-1], a[j-1], t);
+        }
+      /* a[0] = B[m] with B[1] = +1/2 */
+      if (m % 2 == 0)
+        {
+          mpz_fac_ui (c, m + 1);
+          mpz_mul (c, c, mpq_numref (a[0]));
+          MPFR_ASSERTN (mpz_divisible_p (c, mpq_denref (a[0])));
+          mpz_divexact (c, c, mpq_denref (a[0]));
+          if (mpz_cmp (c, mpfr_bernoulli_cache (m / 2)) != 0)
+            {
+              printf ("Error in mpfr_bernoulli_cache for n=%lu\n", m / 2);
+              exit (1);
+            }
+        }
+    }
+  for (m = 0; m <= 2 * NMAX; m++)
+    mpq_clear (a[m]);
+  mpq_clear (t);
+  mpz_clear (c);
+}
+
+/* check the rounded values, and that the cache can be rebuilt after
+   mpfr_free_cache, possibly starting with a large index */
+static void
+check_fr (void)
+{
+  mpfr_t x;
+  mpz_t c;
+  mpfr_srcptr b;
+  unsigned long n;
+  mpfr_prec_t p;
+
+  mpfr_init2 (x, MPFR_PREC_MIN);
+  mpz_init (c);
+  for (p = 2; p < 200; p += 17)
+    for (n = 0; n < 60; n += 3)
+      {
+        mpz_set (c, mpfr_bernoulli_cache (n));
+        b = mpfr_bernoulli_cache_fr (n, p);
+        mpfr_set_prec (x, p);
+        mpfr_set_z (x, c, MPFR_RNDN);
+        if (MPFR_PREC (b) != p || ! mpfr_equal_p (b, x))
+          {
+            printf ("Error in mpfr_bernoulli_cache_fr for n=%lu p=%lu\n",
+                    n, (unsigned long) p);
+            exit (1);
+          }
+      }
+  mpfr_free_cache ();
+  /* B[400]*401! has 4722 bits, B[400] is negative */
+  mpz_set (c, mpfr_bernoulli_cache (200));
+  MPFR_ASSERTN (mpz_sizeinbase (c, 2) == 4722 && mpz_sgn (c) < 0);
+  mpfr_free_cache ();
+  /* B[4]*5! = -4 */
+  MPFR_ASSERTN (mpz_cmp_si (mpfr_bernoulli_cache (2), -4) == 0);
+  mpfr_clear (x);
+  mpz_clear (c);
+}
+
+/* For n large, B[2n]*(2n+1)! is -(-1)^n*2*(2n)!*(2n+1)!/(2*Pi)^(2n) with
+   a relative error less than 2^(1-2n), which gives an approximation of
+   the rounded value of C[n] on p bits. */
+static void
+check_approx (unsigned long n, mpfr_srcptr b, mpfr_prec_t p)
+{
+  mpfr_t x, y;
+
+  mpfr_init2 (x, p + 20);
+  mpfr_init2 (y, p + 20);
+  mpfr_fac_ui (x, 2 * n, MPFR_RNDN);
+  mpfr_fac_ui (y, 2 * n + 1, MPFR_RNDN);
+  mpfr_mul (x, x, y, MPFR_RNDN);
+  mpfr_const_pi (y, MPFR_RNDN);
+  mpfr_mul_2ui (y, y, 1, MPFR_RNDN);
+  mpfr_pow_ui (y, y, 2 * n, MPFR_RNDN);
+  mpfr_div (x, x, y, MPFR_RNDN);
+  mpfr_mul_2ui (x, x, 1, MPFR_RNDN);
+  if ((n & 1) == 0)
+    mpfr_neg (x, x, MPFR_RNDN);
+  mpfr_sub (y, x, b, MPFR_RNDN);
+  if (MPFR_PREC (b) != p || MPFR_IS_ZERO (b)
+      || (MPFR_NOTZERO (y) && MPFR_GET_EXP (y) > MPFR_GET_EXP (x) - p + 1))
+    {
+      printf ("Error in mpfr_bernoulli_cache_fr for n=%lu p=%lu\n",
+              n, (unsigned long) p);
+      printf ("expected about ");
+      mpfr_dump (x);
+      printf ("got            ");
+      mpfr_dump (b);
+      exit (1);
+    }
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+/* check the entries that do not fit in the cache, which are recomputed on
+   each call, before and after mpfr_free_cache */
+static void
+check_uncached (void)
+{
+  mpz_t c;
+  mpfr_t x;
+  mpfr_prec_t p;
+  unsigned long n = 6000;
+  int i;
+
+  mpz_init (c);
+  for (i = 0; i < 2; i++)
+    {
+      /* C[0], ..., C[6000] do not fit in the cache, thus C[6000] is
+         computed directly and the cache stays empty */
+      mpfr_free_cache ();
+      if (i == 0)
+        mpz_set (c, mpfr_bernoulli_cache (n));
+      else if (mpz_cmp (c, mpfr_bernoulli_cache (n)) != 0)
+        {
+          printf ("Error in mpfr_bernoulli_cache for n=%lu after "
+                  "mpfr_free_cache\n", n);
+          exit (1);
+        }
+      check_approx (n, mpfr_bernoulli_cache_fr (n, 64), 64);
+      check_approx (n + 1, mpfr_bernoulli_cache_fr (n + 1, 100), 100);
+      /* the cache can still be filled */
+      MPFR_ASSERTN (mpz_cmp_si (mpfr_bernoulli_cache (2), -4) == 0);
+    }
+
+  /* the rounded values of C[0], ..., C[100] on p bits take more than
+     MPFR_CACHE_TABLE_LIMBS limbs, thus are not kept */
+  mpfr_free_cache ();
+  p = (mpfr_prec_t) (MPFR_CACHE_TABLE_LIMBS / 101 + 1) * GMP_NUMB_BITS;
+  mpfr_init2 (x, 30);
+  mpfr_set_z (x, mpfr_bernoulli_cache (50), MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_equal_p (mpfr_bernoulli_cache_fr (50, 30), x));
+  for (i = 0; i < 2; i++)
+    {
+      mpfr_srcptr b;
+
+      mpz_set (c, mpfr_bernoulli_cache (100));
+      b = mpfr_bernoulli_cache_fr (100, p);
+      MPFR_ASSERTN (MPFR_PREC (b) == p && mpfr_cmp_z (b, c) == 0);
+      /* the rounded values on 30 bits are kept in the cache for i = 0,
+         and recomputed after mpfr_free_cache for i = 1 */
+      MPFR_ASSERTN (mpfr_equal_p (mpfr_bernoulli_cache_fr (50, 30), x));
+      mpfr_free_cache ();
+    }
+  mpfr_clear (x);
+  mpz_clear (c);
+}
+
+/* the rounded values are kept for several precisions, thus calls that
+   alternate between two precisions do not round them again */
+static void
+check_fr_precisions (void)
+{
+  mpfr_t x, y;
+  mpfr_srcptr b1, b2, b;
+  unsigned long n = 30;
+  int i;
+
+  mpfr_free_cache ();
+  mpfr_init2 (x, 53);
+  mpfr_init2 (y, 100);
+  mpfr_set_z (x, mpfr_bernoulli_cache (n), MPFR_RNDN);
+  mpfr_set_z (y, mpfr_bernoulli_cache (n), MPFR_RNDN);
+  b1 = mpfr_bernoulli_cache_fr (n, 53);
+  for (i = 0; i < 3; i++)
+    {
+      b2 = mpfr_bernoulli_cache_fr (n, 100);
+      MPFR_ASSERTN (b2 != b1 && mpfr_equal_p (b2, y));
+      /* the 53-bit values were not touched */
+      MPFR_ASSERTN (MPFR_PREC (b1) == 53 && mpfr_equal_p (b1, x));
+      MPFR_ASSERTN (mpfr_bernoulli_cache_fr (n, 53) == b1);
+    }
+  /* many precisions in turn, as in a Ziv loop */
+  for (i = 0; i < 20; i++)
+    {
+      mpfr_set_prec (y, 60 + 10 * i);
+      mpfr_set_z (y, mpfr_bernoulli_cache (n), MPFR_RNDN);
+      b = mpfr_bernoulli_cache_fr (n, 60 + 10 * i);
+      MPFR_ASSERTN (MPFR_PREC (b) == 60 + 10 * i && mpfr_equal_p (b, y));
+      b = mpfr_bernoulli_cache_fr (n / 2, 53);
+      mpfr_set_z (x, mpfr_bernoulli_cache (n / 2), MPFR_RNDN);
+      MPFR_ASSERTN (MPFR_PREC (b) == 53 && mpfr_equal_p (b, x));
+    }
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_exact ();
+  check_fr ();
+  check_fr_precisions ();
+  check_uncached ();
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -54,6 +54,55 @@ check_round_p (void)
     }
 }
 
+/* check that when mpfr_can_round returns 1 for MPFR_RNDF, rounding to
+   nearest gives a faithful rounding of any value within the error bound */
+static void
+check_rndf (void)
+{
+  mpfr_t x, y, z, d, u;
+  mpfr_prec_t p;
+  mpfr_exp_t err;
+  int i, k;
+
+  mpfr_inits2 (200, x, z, d, (mpfr_ptr) 0);
+  mpfr_init2 (y, MPFR_PREC_MIN);
+  mpfr_init2 (u, MPFR_PREC_MIN);
+  for (i = 0; i < 1000; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      if (MPFR_IS_ZERO (x))
+        continue;
+      p = MPFR_PREC_MIN + randlimb () % 100;
+      err = p + randlimb () % 5;
+      if (mpfr_can_round (x, err, MPFR_RNDN, MPFR_RNDF, p) == 0)
+        {
+          MPFR_ASSERTN (err < p + 2);
+          continue;
+        }
+      mpfr_set_prec (y, p);
+      mpfr_set (y, x, MPFR_RNDN);
+      for (k = -1; k <= 1; k += 2)
+        {
+          /* z = x + k * 2^(EXP(x)-err) */
+          mpfr_set_si_2exp (d, k, MPFR_GET_EXP (x) - err, MPFR_RNDN);
+          mpfr_add (z, x, d, MPFR_RNDN);
+          mpfr_set_prec (u, p);
+          mpfr_set (u, z, MPFR_RNDD);
+          if (mpfr_equal_p (u, y))
+            continue;
+          mpfr_set (u, z, MPFR_RNDU);
+          if (! mpfr_equal_p (u, y))
+            {
+              printf ("Error in mpfr_can_round with MPFR_RNDF, err=%ld,"
+                      " prec=%lu\nx=", (long) err, (unsigned long) p);
+              mpfr_dump (x);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (x, y, z, d, u, (mpfr_ptr) 0);
+}
+
 int
 main (void)
 {
@@ -118,6 +167,7 @@ main (void)
   mpfr_clear (x);
 
   check_round_p ();
+  check_rndf ();
 
   tests_end_mpfr ();
   return 0;
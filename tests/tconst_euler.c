@@ -68,6 +68,21 @@ main (int argc, char *argv[])
       exit (1);
     }
 
+  /* check a larger precision against a known value */
+  mpfr_set_prec (y, 1024);
+  mpfr_set_prec (z, 1024);
+  mpfr_const_euler (y, MPFR_RNDN);
+  mpfr_set_str (z, "9.3c467e37db0c7a4d1be3f810152cb56a1cecc3af65cc0190c03df"
+                "34709affbd8e4b59fa03a9f0eed0649ccb621057d11056ae9132135a08e4"
+                "3b4673d74bafea58deb878cc86d733dbe7bf38154b36cf8a96d1567899aa"
+                "ae0c09d4c8b6b7b86fd2a1ea1de62ff8643ec7c271827977225e6ac2f0bd"
+                "61c746961542a3ce3bea5e0@-1", 16, MPFR_RNDN);
+  if (mpfr_cmp (y, z))
+    {
+      printf ("Error for prec=1024\n");
+      exit (1);
+    }
+
   for (prec = p0; prec <= p1; prec++)
     {
       mpfr_set_prec (z, prec);
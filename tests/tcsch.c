@@ -94,12 +94,33 @@ check_specials (void)
   mpfr_clear (y);
 }
 
+/* Check inputs with many more bits than the output: as for mpfr_sinh,
+   the working precision only depends on the output precision. */
+static void
+large_input_prec (void)
+{
+  mpfr_t x;
+  int i;
+
+  mpfr_init2 (x, 3000);
+  for (i = 0; i < 20; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_2si (x, x, (long) (randlimb () % 60) - 50, MPFR_RNDN);
+      if (i & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      tests_large_input (mpfr_csch, x, "mpfr_csch");
+    }
+  mpfr_clear (x);
+}
+
 int
 main (int argc, char *argv[])
 {
   tests_start_mpfr ();
 
   check_specials ();
+  large_input_prec ();
   test_generic (2, 200, 10);
 
   tests_end_mpfr ();
@@ -51,7 +51,8 @@ mpfr_all_div (mpfr_ptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t r)
   oldflags = __gmpfr_flags;
   inex = mpfr_div (a, b, c, r);
 
-  if (a == b || a == c)
+  /* with MPFR_RNDF, the other functions may return the other neighbor */
+  if (a == b || a == c || r == MPFR_RNDF)
     return inex;
 
   newflags = __gmpfr_flags;
@@ -1101,6 +1102,55 @@ test_20070628 (void)
 #define RAND_FUNCTION(x) mpfr_random2(x, MPFR_LIMB_SIZE (x), randlimb () % 100, RANDS)
 #include "tgeneric.c"
 
+/* The divisors with zero low limbs give the same results as the same
+   values in a small precision. */
+static void
+check_few_bits (void)
+{
+  mpfr_t q1, q2, u, v1, v2, w;
+  mpfr_prec_t pv;
+  int i, inex1, inex2;
+  mpfr_rnd_t rnd;
+
+  mpfr_inits2 (MPFR_PREC_MIN, q1, q2, u, v1, v2, w, (mpfr_ptr) 0);
+  for (i = 0; i < 500; i++)
+    {
+      pv = MPFR_PREC_MIN + randlimb () % 4000;
+      tests_few_bits_random (v1, v2, pv, MPFR_PREC_MIN + randlimb () % pv);
+      if (i % 2)
+        tests_few_bits_random (u, w, MPFR_PREC_MIN + randlimb () % 4000,
+                               MPFR_PREC_MIN + randlimb () % 100);
+      else
+        {
+          mpfr_set_prec (u, MPFR_PREC_MIN + randlimb () % 4000);
+          mpfr_urandomb (u, RANDS);
+        }
+      if (i % 16 == 0)
+        /* exact quotient */
+        mpfr_mul (u, v1, v1, MPFR_RNDN);
+      mpfr_set_prec (q1, MPFR_PREC_MIN + randlimb () % 4000);
+      mpfr_set_prec (q2, MPFR_PREC (q1));
+      rnd = RND_RAND ();
+      inex1 = mpfr_div (q1, u, v1, rnd);
+      inex2 = mpfr_div (q2, u, v2, rnd);
+      if (! mpfr_equal_p (q1, q2) || ! SAME_SIGN (inex1, inex2))
+        {
+          printf ("Error in check_few_bits for %s\nu = ",
+                  mpfr_print_rnd_mode (rnd));
+          mpfr_dump (u);
+          printf ("v = ");
+          mpfr_dump (v1);
+          printf ("got      ");
+          mpfr_dump (q1);
+          printf ("expected ");
+          mpfr_dump (q2);
+          printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+          exit (1);
+        }
+    }
+  mpfr_clears (q1, q2, u, v1, v2, w, (mpfr_ptr) 0);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -1110,6 +1160,7 @@ main (int argc, char *argv[])
   check_hard ();
   check_special ();
   check_lowr ();
+  check_few_bits ();
   check_float (); /* checks single precision */
   check_double ();
   check_convergence ();
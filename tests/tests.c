@@ -550,6 +550,59 @@ tests_default_random (mpfr_ptr x, int pos, mpfr_exp_t emin, mpfr_exp_t emax)
     mpfr_neg (x, x, MPFR_RNDN);
 }
 
+/* Set x to a random number of precision p whose significand has only q
+   significant bits (thus with zero low limbs when q is small compared to p),
+   and y to the same value in precision q (q is reduced to p if larger). */
+void
+tests_few_bits_random (mpfr_ptr x, mpfr_ptr y, mpfr_prec_t p, mpfr_prec_t q)
+{
+  mpfr_set_prec (y, MIN (p, q));
+  mpfr_urandomb (y, RANDS);
+  if (MPFR_IS_ZERO (y))
+    mpfr_set_ui (y, 1, MPFR_RNDN);
+  if (randlimb () & 1)
+    mpfr_neg (y, y, MPFR_RNDN);
+  mpfr_set_prec (x, p);
+  mpfr_set (x, y, MPFR_RNDN);
+}
+
+/* Check that the value of fct at x, computed in precision 30 in all the
+   rounding modes, agrees with the correct rounding of fct(x) computed in
+   the precision of x, when the latter can be rounded. This is meant for
+   functions whose working precision only depends on the output precision,
+   with an input x of much larger precision. */
+void
+tests_large_input (int (*fct) (FLIST), mpfr_srcptr x, const char *name)
+{
+  mpfr_t y, z, t;
+  int r;
+
+  mpfr_init2 (y, 30);
+  mpfr_init2 (z, MPFR_PREC (x));
+  mpfr_init2 (t, 30);
+  fct (z, x, MPFR_RNDN);
+  RND_LOOP (r)
+    {
+      if (! mpfr_can_round (z, MPFR_PREC (x) - 1, MPFR_RNDN,
+                            (mpfr_rnd_t) r, 30))
+        continue;
+      mpfr_set (t, z, (mpfr_rnd_t) r);
+      fct (y, x, (mpfr_rnd_t) r);
+      if (! mpfr_equal_p (y, t))
+        {
+          printf ("Error in %s with a large input precision for %s, x=",
+                  name, mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+          mpfr_dump (x);
+          printf ("expected ");
+          mpfr_dump (t);
+          printf ("got      ");
+          mpfr_dump (y);
+          exit (1);
+        }
+    }
+  mpfr_clears (y, z, t, (mpfr_ptr) 0);
+}
+
 /* The test_one argument is seen a boolean. If it is true and rnd is
    a rounding mode toward infinity, then the function is tested in
    only one rounding mode (the one provided in rnd) and the variable
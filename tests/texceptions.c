@@ -44,7 +44,7 @@ check_default_rnd (void)
 {
   int r;
   mpfr_rnd_t t;
-  for(r = 0 ; r < MPFR_RND_MAX ; r++)
+  for(r = 0 ; r <= MPFR_RNDF ; r++)
     {
       mpfr_set_default_rounding_mode ((mpfr_rnd_t) r);
       t = (mpfr_get_default_rounding_mode) ();
@@ -55,11 +55,11 @@ check_default_rnd (void)
           ERROR("ERROR in setting / getting default rounding mode (1)");
         }
     }
-  mpfr_set_default_rounding_mode ((mpfr_rnd_t) MPFR_RND_MAX);
-  if (mpfr_get_default_rounding_mode() != MPFR_RNDA)
+  mpfr_set_default_rounding_mode ((mpfr_rnd_t) (MPFR_RNDF + 1));
+  if (mpfr_get_default_rounding_mode() != MPFR_RNDF)
     ERROR("ERROR in setting / getting default rounding mode (2)");
   mpfr_set_default_rounding_mode((mpfr_rnd_t) -1);
-  if (mpfr_get_default_rounding_mode() != MPFR_RNDA)
+  if (mpfr_get_default_rounding_mode() != MPFR_RNDF)
     ERROR("ERROR in setting / getting default rounding mode (3)");
 }
 
@@ -114,6 +114,46 @@ test_int (void)
   mpfr_clear (y);
 }
 
+/* larger arguments, for which the product tree is rounded, or
+   mpfr_gamma is used */
+static void
+test_large (void)
+{
+  unsigned long n;
+  mpz_t f;
+  mpfr_t x, y;
+  int i, inex1, inex2;
+  mpfr_rnd_t r;
+
+  mpz_init (f);
+  mpfr_init (x);
+  mpfr_init (y);
+  for (i = 0; i < 40; i++)
+    {
+      n = (i < 20) ? 100 + randlimb () % 1000 : 1000 + randlimb () % 20000;
+      mpz_fac_ui (f, n);
+      mpfr_set_prec (x, 2 + randlimb () % ((i & 1) ? 100 : 3000));
+      mpfr_set_prec (y, MPFR_PREC (x));
+      r = RND_RAND ();
+      inex1 = mpfr_fac_ui (x, n, r);
+      inex2 = mpfr_set_z (y, f, r);
+      if (! mpfr_equal_p (x, y) || ! SAME_SIGN (inex1, inex2))
+        {
+          printf ("Error for n=%lu prec=%lu rnd=%s\n", n,
+                  (unsigned long) MPFR_PREC (x), mpfr_print_rnd_mode (r));
+          printf ("expected ");
+          mpfr_dump (y);
+          printf ("got      ");
+          mpfr_dump (x);
+          printf ("inex1=%d inex2=%d\n", inex1, inex2);
+          exit (1);
+        }
+    }
+  mpz_clear (f);
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
 static void
 overflowed_fac0 (void)
 {
@@ -198,6 +238,7 @@ main (int argc, char *argv[])
   special ();
 
   test_int ();
+  test_large ();
 
   mpfr_init (x);
   mpfr_init (y);
@@ -435,6 +435,74 @@ gamma_integer (void)
   mpz_clear (n);
 }
 
+/* test gamma at half-integers k+1/2 and 1/2-k, where
+   gamma(k+1/2) = (2k-1)!!*sqrt(Pi)/2^k and
+   gamma(1/2-k) = (-2)^k*sqrt(Pi)/(2k-1)!! */
+static void
+gamma_half_integer (void)
+{
+  mpz_t f;
+  mpfr_t x, y, z, t;
+  unsigned long k, j;
+  int i, neg, inex;
+  mpfr_prec_t p;
+  mpfr_rnd_t r;
+
+  mpz_init (f);
+  mpfr_inits2 (64, x, y, z, t, (mpfr_ptr) 0);
+  for (i = 0; i < 200; i++)
+    {
+      k = (i < 20) ? (unsigned long) i : randlimb () % 2000;
+      neg = i & 1;
+      mpz_set_ui (f, 1);
+      for (j = 1; j < 2 * k; j += 2)
+        mpz_mul_ui (f, f, j);
+      mpfr_set_ui (x, k, MPFR_RNDN);
+      if (neg)
+        mpfr_ui_sub (x, 0, x, MPFR_RNDN);
+      mpfr_add_d (x, x, 0.5, MPFR_RNDN);
+      mpfr_set_prec (y, 2 + randlimb () % 200);
+      r = RND_RAND ();
+      inex = mpfr_gamma (y, x, r);
+      for (p = MPFR_PREC (y) + 20; ; p += 32)
+        {
+          mpfr_set_prec (z, p);
+          mpfr_set_prec (t, p);
+          mpfr_const_pi (t, MPFR_RNDN);
+          mpfr_sqrt (t, t, MPFR_RNDN);
+          mpfr_set_z (z, f, MPFR_RNDN);
+          if (neg)
+            {
+              mpfr_div (z, t, z, MPFR_RNDN);
+              mpfr_mul_2ui (z, z, k, MPFR_RNDN);
+              if (k & 1)
+                mpfr_neg (z, z, MPFR_RNDN);
+            }
+          else
+            {
+              mpfr_mul (z, z, t, MPFR_RNDN);
+              mpfr_div_2ui (z, z, k, MPFR_RNDN);
+            }
+          if (mpfr_can_round (z, p - 3, MPFR_RNDN, MPFR_RNDZ,
+                              MPFR_PREC (y) + (r == MPFR_RNDN)))
+            break;
+        }
+      mpfr_set_prec (t, MPFR_PREC (y));
+      mpfr_set (t, z, r);
+      if (! mpfr_equal_p (y, t) || ! SAME_SIGN (inex, mpfr_cmp (t, z)))
+        {
+          printf ("Error for gamma(%s%lu+1/2), prec=%lu, rnd=%s\n",
+                  neg ? "-" : "", k, (unsigned long) MPFR_PREC (y),
+                  mpfr_print_rnd_mode (r));
+          printf ("expected "); mpfr_dump (t);
+          printf ("got      "); mpfr_dump (y);
+          exit (1);
+        }
+    }
+  mpfr_clears (x, y, z, t, (mpfr_ptr) 0);
+  mpz_clear (f);
+}
+
 /* bug found by Kevin Rauch */
 static void
 test20071231 (void)
@@ -1043,6 +1111,25 @@ exp_lgamma_tests (void)
   set_emax (emax);
 }
 
+/* Check the reflection formula for an input with many more bits than the
+   output: the working precision only depends on the output precision. */
+static void
+large_input_prec (void)
+{
+  mpfr_t x;
+  int i;
+
+  mpfr_init2 (x, 3000);
+  for (i = 0; i < 20; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_si (x, x, -(long) (randlimb () % 20), MPFR_RNDN);
+      mpfr_add_d (x, x, 0.75, MPFR_RNDN);
+      tests_large_input (mpfr_gamma, x, "mpfr_gamma");
+    }
+  mpfr_clear (x);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -1054,6 +1141,8 @@ main (int argc, char *argv[])
   tiny (argc == 1);
   test_generic (2, 100, 2);
   gamma_integer ();
+  gamma_half_integer ();
+  large_input_prec ();
   test20071231 ();
   test20100709 ();
   test20120426 ();
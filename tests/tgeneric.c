@@ -50,6 +50,9 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 #define TGENERIC_SO_TEST 1
 #endif
 
+/* Define TGENERIC_NO_RNDF to omit the test with MPFR_RNDF, for instance
+   when the tested function depends on the rounding mode. */
+
 #define STR(F) #F
 #define MAKE_STR(S) STR(S)
 
@@ -124,7 +127,7 @@ static void
 test_generic (mpfr_prec_t p0, mpfr_prec_t p1, unsigned int nmax)
 {
   mpfr_prec_t prec, xprec, yprec;
-  mpfr_t x, y, z, t, w;
+  mpfr_t x, y, z, t, v, w;
 #ifdef TWO_ARGS
   mpfr_t u;
 #elif defined(DOUBLE_ARG1) || defined(DOUBLE_ARG2)
@@ -140,7 +143,7 @@ test_generic (mpfr_prec_t p0, mpfr_prec_t p1, unsigned int nmax)
   old_emin = mpfr_get_emin ();
   old_emax = mpfr_get_emax ();
 
-  mpfr_inits2 (MPFR_PREC_MIN, x, y, z, t, w, (mpfr_ptr) 0);
+  mpfr_inits2 (MPFR_PREC_MIN, x, y, z, t, v, w, (mpfr_ptr) 0);
 #if defined(TWO_ARGS) || defined(DOUBLE_ARG1) || defined(DOUBLE_ARG2)
   mpfr_init2 (u, MPFR_PREC_MIN);
 #endif
@@ -150,6 +153,7 @@ test_generic (mpfr_prec_t p0, mpfr_prec_t p1, unsigned int nmax)
     {
       mpfr_set_prec (z, prec);
       mpfr_set_prec (t, prec);
+      mpfr_set_prec (v, prec);
       yprec = prec + 10;
       mpfr_set_prec (y, yprec);
       mpfr_set_prec (w, yprec);
@@ -453,6 +457,43 @@ test_generic (mpfr_prec_t p0, mpfr_prec_t p1, unsigned int nmax)
                   printf ("t="); mpfr_print_binary (t); puts ("");
                   exit (1);
                 }
+#ifndef TGENERIC_NO_RNDF
+              /* With MPFR_RNDF, the result must be one of the two
+                 representable numbers surrounding f(x). */
+              if (mpfr_can_round (y, yprec, rnd, MPFR_RNDD, prec) &&
+                  mpfr_can_round (y, yprec, rnd, MPFR_RNDU, prec))
+                {
+                  mpfr_set (t, y, MPFR_RNDD);
+                  mpfr_set (v, y, MPFR_RNDU);
+                  mpfr_clear_flags ();
+#if defined(TWO_ARGS)
+                  inexact = TEST_FUNCTION (z, x, u, MPFR_RNDF);
+#elif defined(DOUBLE_ARG1)
+                  inexact = TEST_FUNCTION (z, d, x, MPFR_RNDF);
+#elif defined(DOUBLE_ARG2)
+                  inexact = TEST_FUNCTION (z, x, d, MPFR_RNDF);
+#else
+                  inexact = TEST_FUNCTION (z, x, MPFR_RNDF);
+#endif
+                  if (! mpfr_erangeflag_p () &&
+                      ! mpfr_equal_p (z, t) && ! mpfr_equal_p (z, v))
+                    {
+                      printf ("Non-faithful result with MPFR_RNDF for x=");
+                      mpfr_dump (x);
+#if defined(TWO_ARGS) || defined(DOUBLE_ARG1) || defined(DOUBLE_ARG2)
+                      printf ("u=");
+                      mpfr_dump (u);
+#endif
+                      printf ("prec=%u\ngot      ", (unsigned) prec);
+                      mpfr_dump (z);
+                      printf ("expected ");
+                      mpfr_dump (t);
+                      printf ("or       ");
+                      mpfr_dump (v);
+                      exit (1);
+                    }
+                }
+#endif
             }
           else if (getenv ("MPFR_SUSPICIOUS_OVERFLOW") != NULL)
             {
@@ -489,7 +530,7 @@ test_generic (mpfr_prec_t p0, mpfr_prec_t p1, unsigned int nmax)
             ctrn, ctrt);
 #endif
 
-  mpfr_clears (x, y, z, t, w, (mpfr_ptr) 0);
+  mpfr_clears (x, y, z, t, v, w, (mpfr_ptr) 0);
 #if defined(TWO_ARGS) || defined(DOUBLE_ARG1) || defined(DOUBLE_ARG2)
   mpfr_clear (u);
 #endif
@@ -503,4 +544,5 @@ test_generic (mpfr_prec_t p0, mpfr_prec_t p1, unsigned int nmax)
 #undef TWO_ARGS
 #undef TWO_ARGS_UI
 #undef TEST_FUNCTION
+#undef TGENERIC_NO_RNDF
 #undef test_generic
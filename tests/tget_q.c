@@ -0,0 +1,134 @@
+/* Test file for mpfr_get_q.
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+static void
+special (void)
+{
+  mpfr_t x;
+  mpq_t q;
+  int i;
+
+  mpfr_init2 (x, MPFR_PREC_MIN);
+  mpq_init (q);
+
+  for (i = 0; i < 5; i++)
+    {
+      if (i == 0)
+        mpfr_set_nan (x);
+      else if (i <= 2)
+        mpfr_set_inf (x, i == 1 ? 1 : -1);
+      else
+        mpfr_set_zero (x, i == 3 ? 1 : -1);
+      mpq_set_si (q, 17, 3);
+      mpfr_clear_flags ();
+      mpfr_get_q (q, x);
+      if (mpq_sgn (q) != 0 || mpz_cmp_ui (mpq_denref (q), 1) != 0
+          || (mpfr_erangeflag_p () != 0) != (i <= 2))
+        {
+          printf ("Error in mpfr_get_q for x=");
+          mpfr_dump (x);
+          printf ("got q=");
+          mpq_out_str (stdout, 10, q);
+          printf (", erange=%d\n", mpfr_erangeflag_p () != 0);
+          exit (1);
+        }
+    }
+
+  /* 3/8 and -24 */
+  mpfr_set_ui_2exp (x, 3, -3, MPFR_RNDN);
+  mpfr_get_q (q, x);
+  if (mpz_cmp_ui (mpq_numref (q), 3) != 0
+      || mpz_cmp_ui (mpq_denref (q), 8) != 0)
+    {
+      printf ("Error in mpfr_get_q for 3/8\n");
+      exit (1);
+    }
+  mpfr_set_si_2exp (x, -3, 3, MPFR_RNDN);
+  mpfr_get_q (q, x);
+  if (mpz_cmp_si (mpq_numref (q), -24) != 0
+      || mpz_cmp_ui (mpq_denref (q), 1) != 0)
+    {
+      printf ("Error in mpfr_get_q for -24\n");
+      exit (1);
+    }
+
+  mpq_clear (q);
+  mpfr_clear (x);
+}
+
+/* Check that the conversion is exact and that the result is canonical. */
+static void
+random_tests (int nmax)
+{
+  mpfr_t x, y;
+  mpq_t q, r;
+  int n, inex;
+
+  mpfr_inits2 (MPFR_PREC_MIN, x, y, (mpfr_ptr) 0);
+  mpq_init (q);
+  mpq_init (r);
+
+  for (n = 0; n < nmax; n++)
+    {
+      mpfr_set_prec (x, MPFR_PREC_MIN + randlimb () % 500);
+      mpfr_set_prec (y, MPFR_PREC (x));
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_2si (x, x, (long) (randlimb () % 2000) - 1000, MPFR_RNDN);
+      if (n & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      mpfr_get_q (q, x);
+      mpq_set (r, q);
+      mpq_canonicalize (r);
+      inex = mpfr_set_q (y, q, MPFR_RNDN);
+      if (! mpq_equal (q, r) || inex != 0 || ! mpfr_equal_p (x, y)
+          || mpfr_cmp_q (x, q) != 0)
+        {
+          printf ("Error in mpfr_get_q for x=");
+          mpfr_dump (x);
+          printf ("got q=");
+          mpq_out_str (stdout, 16, q);
+          putchar ('\n');
+          exit (1);
+        }
+    }
+
+  mpq_clear (r);
+  mpq_clear (q);
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  special ();
+  random_tests (1000);
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -342,6 +342,261 @@ test_cmp_q (mpfr_prec_t pmin, mpfr_prec_t pmax, int nmax)
   mpfr_clear (z);
 }
 
+/* Check mpfr_add_q, mpfr_sub_q, mpfr_add_z, mpfr_sub_z, mpfr_z_sub,
+   mpfr_cmp_q and mpfr_cmp_z against the exact result computed with mpq,
+   with operands of various sizes, signs and exponents (so that both the
+   exact and the fallback code paths are tested). */
+static void
+test_exact_zq (int nmax)
+{
+  mpfr_t x, y, r;
+  mpq_t q, qx, qr;
+  mpz_t z;
+  mpfr_exp_t e;
+  mpfr_prec_t px, py;
+  mpfr_rnd_t rnd;
+  int n, k, inex1, inex2, c1, c2;
+
+  mpfr_inits2 (MPFR_PREC_MIN, x, y, r, (mpfr_ptr) 0);
+  mpq_init (q);
+  mpq_init (qx);
+  mpq_init (qr);
+  mpz_init (z);
+
+  for (n = 0; n < nmax; n++)
+    {
+      px = MPFR_PREC_MIN + randlimb () % 200;
+      py = MPFR_PREC_MIN + randlimb () % 200;
+      mpfr_set_prec (x, px);
+      mpfr_set_prec (y, py);
+      mpfr_set_prec (r, py);
+      mpfr_urandomb (x, RANDS);
+      if (MPFR_IS_ZERO (x))
+        continue;
+      e = (mpfr_exp_t) (randlimb () % (n % 8 == 0 ? 20000 : 600)) -
+        (n % 8 == 0 ? 10000 : 300);
+      mpfr_mul_2si (x, x, e, MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      e = mpfr_get_z_2exp (z, x);
+      mpq_set_z (qx, z);
+      if (e >= 0)
+        mpq_mul_2exp (qx, qx, e);
+      else
+        mpq_div_2exp (qx, qx, -e);
+
+      mpz_urandomb (mpq_numref (q), RANDS, 1 + randlimb () % 300);
+      mpz_urandomb (mpq_denref (q), RANDS, 1 + randlimb () % 300);
+      mpz_add_ui (mpq_denref (q), mpq_denref (q), 1);
+      if (randlimb () & 1)
+        mpz_neg (mpq_numref (q), mpq_numref (q));
+      /* sometimes make x and q (almost) cancel */
+      if (n % 4 == 1)
+        {
+          mpq_set (q, qx);
+          if (n % 8 == 1)
+            mpz_add_ui (mpq_numref (q), mpq_numref (q), 1);
+        }
+      mpq_canonicalize (q);
+      rnd = RND_RAND ();
+
+      for (k = 0; k < 5; k++)
+        {
+          /* k = 0, 1: add_q, sub_q; k = 2, 3, 4: add_z, sub_z, z_sub */
+          if (k == 0)
+            {
+              mpq_add (qr, qx, q);
+              inex1 = mpfr_add_q (y, x, q, rnd);
+            }
+          else if (k == 1)
+            {
+              mpq_sub (qr, qx, q);
+              inex1 = mpfr_sub_q (y, x, q, rnd);
+            }
+          else
+            {
+              mpq_set_z (qr, mpq_numref (q));
+              if (k == 2)
+                {
+                  mpq_add (qr, qx, qr);
+                  inex1 = mpfr_add_z (y, x, mpq_numref (q), rnd);
+                }
+              else if (k == 3)
+                {
+                  mpq_sub (qr, qx, qr);
+                  inex1 = mpfr_sub_z (y, x, mpq_numref (q), rnd);
+                }
+              else
+                {
+                  mpq_sub (qr, qr, qx);
+                  inex1 = mpfr_z_sub (y, mpq_numref (q), x, rnd);
+                }
+            }
+          inex2 = mpfr_set_q (r, qr, rnd);
+          if (mpq_sgn (qr) == 0 && rnd == MPFR_RNDD)
+            mpfr_neg (r, r, MPFR_RNDN);
+          if (! SAME_SIGN (inex1, inex2) || ! mpfr_equal_p (y, r)
+              || (MPFR_IS_ZERO (r) && MPFR_SIGN (y) != MPFR_SIGN (r)))
+            {
+              printf ("Error in test_exact_zq for k=%d, %s\nx=", k,
+                      mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("q=");
+              mpq_out_str (stdout, 16, q);
+              printf ("\ngot      inex=%d ", inex1);
+              mpfr_dump (y);
+              printf ("expected inex=%d ", inex2);
+              mpfr_dump (r);
+              exit (1);
+            }
+        }
+
+      c1 = mpfr_cmp_q (x, q);
+      c2 = mpq_cmp (qx, q);
+      if (! SAME_SIGN (c1, c2))
+        {
+          printf ("Error for mpfr_cmp_q: got %d, expected %d\nx=", c1, c2);
+          mpfr_dump (x);
+          printf ("q=");
+          mpq_out_str (stdout, 16, q);
+          putchar ('\n');
+          exit (1);
+        }
+      c1 = mpfr_cmp_z (x, mpq_numref (q));
+      mpq_set_z (qr, mpq_numref (q));
+      c2 = mpq_cmp (qx, qr);
+      if (! SAME_SIGN (c1, c2))
+        {
+          printf ("Error for mpfr_cmp_z: got %d, expected %d\nx=", c1, c2);
+          mpfr_dump (x);
+          printf ("z=");
+          mpz_out_str (stdout, 16, mpq_numref (q));
+          putchar ('\n');
+          exit (1);
+        }
+    }
+
+  mpz_clear (z);
+  mpq_clear (qr);
+  mpq_clear (qx);
+  mpq_clear (q);
+  mpfr_clears (x, y, r, (mpfr_ptr) 0);
+}
+
+/* Check mpfr_z_div and mpfr_q_div against the exact quotient computed
+   with mpq, and in the special cases. */
+static void
+test_zq_div (int nmax)
+{
+  mpfr_t x, y, r;
+  mpq_t q, qx, qr;
+  mpfr_rnd_t rnd;
+  int n, k, inex1, inex2;
+
+  mpfr_inits2 (MPFR_PREC_MIN, x, y, r, (mpfr_ptr) 0);
+  mpq_init (q);
+  mpq_init (qx);
+  mpq_init (qr);
+
+  /* special cases: q/0, q/Inf, 0/x and NaN/x */
+  mpq_set_si (q, -3, 5);
+  mpfr_set_zero (x, 1);
+  mpfr_clear_flags ();
+  inex1 = mpfr_q_div (y, q, x, MPFR_RNDN);
+  if (inex1 != 0 || ! mpfr_inf_p (y) || MPFR_IS_POS (y)
+      || ! mpfr_divby0_p ())
+    {
+      printf ("Error for mpfr_q_div (-3/5, +0)\n");
+      exit (1);
+    }
+  mpfr_clear_flags ();
+  inex1 = mpfr_z_div (y, mpq_numref (q), x, MPFR_RNDN);
+  if (inex1 != 0 || ! mpfr_inf_p (y) || MPFR_IS_POS (y)
+      || ! mpfr_divby0_p ())
+    {
+      printf ("Error for mpfr_z_div (-3, +0)\n");
+      exit (1);
+    }
+  mpfr_set_inf (x, -1);
+  inex1 = mpfr_q_div (y, q, x, MPFR_RNDN);
+  if (inex1 != 0 || ! mpfr_zero_p (y) || MPFR_IS_NEG (y))
+    {
+      printf ("Error for mpfr_q_div (-3/5, -Inf)\n");
+      exit (1);
+    }
+  mpq_set_ui (q, 0, 1);
+  mpfr_set_si (x, -7, MPFR_RNDN);
+  inex1 = mpfr_z_div (y, mpq_numref (q), x, MPFR_RNDN);
+  if (inex1 != 0 || ! mpfr_zero_p (y) || MPFR_IS_POS (y))
+    {
+      printf ("Error for mpfr_z_div (0, -7)\n");
+      exit (1);
+    }
+  mpz_set_ui (mpq_denref (q), 0);
+  inex1 = mpfr_q_div (y, q, x, MPFR_RNDN);
+  if (! mpfr_nan_p (y))
+    {
+      printf ("Error for mpfr_q_div (0/0, -7)\n");
+      exit (1);
+    }
+
+  for (n = 0; n < nmax; n++)
+    {
+      mpfr_set_prec (x, MPFR_PREC_MIN + randlimb () % 200);
+      mpfr_set_prec (y, MPFR_PREC_MIN + randlimb () % 200);
+      mpfr_set_prec (r, MPFR_PREC (y));
+      mpfr_urandomb (x, RANDS);
+      if (MPFR_IS_ZERO (x))
+        continue;
+      mpfr_mul_2si (x, x, (long) (randlimb () % 600) - 300, MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      mpfr_get_q (qx, x);
+      mpz_urandomb (mpq_numref (q), RANDS, 1 + randlimb () % 300);
+      mpz_urandomb (mpq_denref (q), RANDS, 1 + randlimb () % 300);
+      mpz_add_ui (mpq_numref (q), mpq_numref (q), 1);
+      mpz_add_ui (mpq_denref (q), mpq_denref (q), 1);
+      if (randlimb () & 1)
+        mpz_neg (mpq_numref (q), mpq_numref (q));
+      mpq_canonicalize (q);
+      rnd = RND_RAND ();
+
+      for (k = 0; k < 2; k++)
+        {
+          if (k == 0)
+            {
+              mpq_div (qr, q, qx);
+              inex1 = mpfr_q_div (y, q, x, rnd);
+            }
+          else
+            {
+              mpq_set_z (qr, mpq_numref (q));
+              mpq_div (qr, qr, qx);
+              inex1 = mpfr_z_div (y, mpq_numref (q), x, rnd);
+            }
+          inex2 = mpfr_set_q (r, qr, rnd);
+          if (! SAME_SIGN (inex1, inex2) || ! mpfr_equal_p (y, r))
+            {
+              printf ("Error for mpfr_%c_div, %s\nx=", k == 0 ? 'q' : 'z',
+                      mpfr_print_rnd_mode (rnd));
+              mpfr_dump (x);
+              printf ("q=");
+              mpq_out_str (stdout, 16, q);
+              printf ("\ngot      inex=%d ", inex1);
+              mpfr_dump (y);
+              printf ("expected inex=%d ", inex2);
+              mpfr_dump (r);
+              exit (1);
+            }
+        }
+    }
+
+  mpq_clear (qr);
+  mpq_clear (qx);
+  mpq_clear (q);
+  mpfr_clears (x, y, r, (mpfr_ptr) 0);
+}
+
 static void
 test_cmp_f (mpfr_prec_t pmin, mpfr_prec_t pmax, int nmax)
 {
@@ -1246,6 +1501,8 @@ main (int argc, char *argv[])
   test_cmp_z (2, 100, 100);
   test_cmp_q (2, 100, 100);
   test_cmp_f (2, 100, 100);
+  test_exact_zq (10000);
+  test_zq_div (10000);
 
   check_for_zero ();
 
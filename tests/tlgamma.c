@@ -47,6 +47,8 @@ mpfr_lgamma_nosign (mpfr_ptr y, mpfr_srcptr x, mpfr_rnd_t rnd)
 }
 
 #define TEST_FUNCTION mpfr_lgamma_nosign
+/* the tested function would differ between MPFR_RNDF and the other modes */
+#define TGENERIC_NO_RNDF
 #include "tgeneric.c"
 
 static void
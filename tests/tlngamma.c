@@ -222,12 +222,45 @@ special (void)
   mpfr_clear (y);
 }
 
+/* Check the argument reconstruction for an input with few bits and a
+   large target precision (product by binary splitting) against the same
+   value given on as many bits as the target (product term by term). */
+static void
+short_arg (void)
+{
+  mpfr_t x, xl, y, z;
+  int i, inex1, inex2;
+
+  mpfr_init2 (x, 20);
+  mpfr_init2 (xl, 1500);
+  mpfr_init2 (y, 1200);
+  mpfr_init2 (z, 1200);
+  for (i = 0; i < 10; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_ui (x, x, 1 + randlimb () % 100, MPFR_RNDN);
+      if (mpfr_cmp_ui (x, 1) <= 0)
+        mpfr_add_ui (x, x, 1, MPFR_RNDN);
+      mpfr_set (xl, x, MPFR_RNDN);
+      inex1 = mpfr_lngamma (y, x, MPFR_RNDN);
+      inex2 = mpfr_lngamma (z, xl, MPFR_RNDN);
+      if (! mpfr_equal_p (y, z) || inex1 != inex2)
+        {
+          printf ("Error in short_arg for x=");
+          mpfr_dump (x);
+          exit (1);
+        }
+    }
+  mpfr_clears (x, xl, y, z, (mpfr_ptr) 0);
+}
+
 int
 main (void)
 {
   tests_start_mpfr ();
 
   special ();
+  short_arg ();
   test_generic (2, 100, 2);
 
   tests_end_mpfr ();
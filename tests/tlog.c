@@ -265,6 +265,91 @@ x_near_one (void)
   mpfr_clears (x, y, (mpfr_ptr) 0);
 }
 
+/* Check mpfr_log_newton, used by mpfr_log above MPFR_LOG_THRESHOLD, against
+   mpfr_log (thus the AGM) in a moderate precision, in all the rounding
+   modes, with the ternary value. */
+static void
+check_newton (void)
+{
+  mpfr_t x, y1, y2;
+  mpfr_exp_t emin, emax;
+  int i, rnd, inex1, inex2;
+
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  mpfr_inits2 (MPFR_PREC_MIN, x, y1, y2, (mpfr_ptr) 0);
+  for (i = 0; i < 200; i++)
+    {
+      mpfr_set_prec (x, MPFR_PREC_MIN + randlimb () % 1000);
+      mpfr_set_prec (y1, MPFR_PREC_MIN + randlimb () % 1000);
+      mpfr_set_prec (y2, MPFR_PREC (y1));
+      do
+        mpfr_urandomb (x, RANDS);
+      while (MPFR_IS_ZERO (x));
+      if (i % 4 == 0)
+        /* x close to 1 */
+        mpfr_add_ui (x, x, 1, MPFR_RNDN);
+      else
+        mpfr_mul_2si (x, x, (int) (randlimb () % 200) - 100, MPFR_RNDN);
+      if (mpfr_cmp_ui (x, 1) == 0)
+        continue;
+      RND_LOOP (rnd)
+        {
+          inex2 = mpfr_log (y2, x, (mpfr_rnd_t) rnd);
+          set_emin (MPFR_EMIN_MIN);
+          set_emax (MPFR_EMAX_MAX);
+          inex1 = mpfr_log_newton (y1, x, (mpfr_rnd_t) rnd);
+          set_emin (emin);
+          set_emax (emax);
+          if (! mpfr_equal_p (y1, y2) || ! SAME_SIGN (inex1, inex2))
+            {
+              printf ("Error in mpfr_log_newton for rnd=%s\nx=",
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) rnd));
+              mpfr_dump (x);
+              printf ("expected ");
+              mpfr_dump (y2);
+              printf ("got      ");
+              mpfr_dump (y1);
+              printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+              exit (1);
+            }
+        }
+    }
+  mpfr_clears (x, y1, y2, (mpfr_ptr) 0);
+}
+
+/* Check mpfr_log_newton in a very large precision with exp(log(x)) = x.
+   This takes a few seconds, thus is done only if MPFR_CHECK_LARGEMEM is
+   set. */
+static void
+check_newton_large (void)
+{
+  mpfr_t x, y, z;
+  mpfr_prec_t p = 1000000;
+  mpfr_exp_t emin, emax;
+
+  mpfr_init2 (x, 53);
+  mpfr_inits2 (p, y, z, (mpfr_ptr) 0);
+  mpfr_set_ui (x, 3, MPFR_RNDN);
+  mpfr_div_ui (x, x, 7, MPFR_RNDN);
+  emin = mpfr_get_emin ();
+  emax = mpfr_get_emax ();
+  set_emin (MPFR_EMIN_MIN);
+  set_emax (MPFR_EMAX_MAX);
+  mpfr_log_newton (y, x, MPFR_RNDN);
+  set_emin (emin);
+  set_emax (emax);
+  mpfr_exp (z, y, MPFR_RNDN);
+  mpfr_sub (z, z, x, MPFR_RNDN);
+  if (! MPFR_IS_ZERO (z) && MPFR_GET_EXP (z) > MPFR_GET_EXP (x) + 2 - p)
+    {
+      printf ("Error in check_newton_large for prec=%lu\n",
+              (unsigned long) p);
+      exit (1);
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
 #define TEST_FUNCTION test_log
 #define TEST_RANDOM_POS 8
 #include "tgeneric.c"
@@ -346,6 +431,9 @@ main (int argc, char *argv[])
   check2("6.09969788341579732815e+00",MPFR_RNDD,"1.80823924264386204363e+00");
 
   x_near_one ();
+  check_newton ();
+  if (getenv ("MPFR_CHECK_LARGEMEM") != NULL)
+    check_newton_large ();
 
   test_generic (2, 100, 40);
 
@@ -641,6 +641,129 @@ valgrind20110503 (void)
   mpfr_clears (a, b, c, (mpfr_ptr) 0);
 }
 
+/* The operands with zero low limbs give the same results as the same
+   values in a small precision. */
+static void
+check_few_bits (void)
+{
+  mpfr_t a1, a2, b1, b2, c1, c2;
+  mpfr_prec_t pb, pc;
+  int i, inex1, inex2;
+  mpfr_rnd_t rnd;
+
+  mpfr_inits2 (MPFR_PREC_MIN, a1, a2, b1, b2, c1, c2, (mpfr_ptr) 0);
+  for (i = 0; i < 500; i++)
+    {
+      pb = MPFR_PREC_MIN + randlimb () % 4000;
+      pc = (randlimb () & 1) ? pb
+        : MPFR_PREC_MIN + (mpfr_prec_t) (randlimb () % 4000);
+      tests_few_bits_random (b1, b2, pb, MPFR_PREC_MIN + randlimb () % pb);
+      if (i % 4 == 0)
+        {
+          /* c has all its bits */
+          mpfr_set_prec (c1, pc);
+          mpfr_urandomb (c1, RANDS);
+          mpfr_set_prec (c2, pc);
+          mpfr_set (c2, c1, MPFR_RNDN);
+        }
+      else
+        tests_few_bits_random (c1, c2, pc, MPFR_PREC_MIN + randlimb () % pc);
+      mpfr_set_prec (a1, MPFR_PREC_MIN + randlimb () % 4000);
+      mpfr_set_prec (a2, MPFR_PREC (a1));
+      rnd = RND_RAND ();
+      if (i % 8 == 1)
+        {
+          /* square */
+          inex1 = mpfr_mul (a1, b1, b1, rnd);
+          inex2 = mpfr_mul (a2, b2, b2, rnd);
+        }
+      else
+        {
+          inex1 = mpfr_mul (a1, b1, c1, rnd);
+          inex2 = mpfr_mul (a2, b2, c2, rnd);
+        }
+      if (! mpfr_equal_p (a1, a2) || ! SAME_SIGN (inex1, inex2))
+        {
+          printf ("Error in check_few_bits for %s\nb = ",
+                  mpfr_print_rnd_mode (rnd));
+          mpfr_dump (b1);
+          printf ("c = ");
+          mpfr_dump (i % 8 == 1 ? b1 : c1);
+          printf ("got      ");
+          mpfr_dump (a1);
+          printf ("expected ");
+          mpfr_dump (a2);
+          printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+          exit (1);
+        }
+    }
+  mpfr_clears (a1, a2, b1, b2, c1, c2, (mpfr_ptr) 0);
+}
+
+/* Check the products in a destination with much fewer limbs than the
+   operands (the operands are then truncated), against the exact product
+   rounded by mpfr_set. With MPFR_RNDF, the result must be the exact
+   product rounded toward -Inf or toward +Inf. */
+static void
+check_truncated (void)
+{
+  mpfr_t a1, a2, b, c, t;
+  int i, inex1, inex2, ok;
+  mpfr_rnd_t rnd;
+
+  mpfr_inits2 (MPFR_PREC_MIN, a1, a2, b, c, t, (mpfr_ptr) 0);
+  for (i = 0; i < 2000; i++)
+    {
+      mpfr_set_prec (a1, MPFR_PREC_MIN + randlimb () % 300);
+      mpfr_set_prec (a2, MPFR_PREC (a1));
+      mpfr_set_prec (b, MPFR_PREC (a1) + randlimb () % 2000);
+      mpfr_set_prec (c, (randlimb () & 1) ? MPFR_PREC (b) :
+                     MPFR_PREC_MIN + (mpfr_prec_t) (randlimb () % 2000));
+      /* random2 gives long runs of zeros and ones, hence hard cases */
+      mpfr_random2 (b, MPFR_LIMB_SIZE (b), 0, RANDS);
+      if (i % 4 == 0)
+        {
+          mpfr_set_prec (c, MPFR_PREC (b));
+          mpfr_set (c, b, MPFR_RNDN);
+        }
+      else
+        mpfr_random2 (c, MPFR_LIMB_SIZE (c), 0, RANDS);
+      if (MPFR_IS_ZERO (b) || MPFR_IS_ZERO (c))
+        continue;
+      mpfr_set_prec (t, MPFR_PREC (b) + MPFR_PREC (c));
+      MPFR_ASSERTN (mpfr_mul (t, b, c, MPFR_RNDN) == 0);
+      rnd = (i % 5 == 0) ? MPFR_RNDF : RND_RAND ();
+      inex1 = mpfr_mul (a1, b, i % 4 == 0 ? b : c, rnd);
+      if (rnd == MPFR_RNDF)
+        {
+          inex2 = mpfr_set (a2, t, MPFR_RNDD);
+          if (! mpfr_equal_p (a1, a2))
+            inex2 = mpfr_set (a2, t, MPFR_RNDU);
+          ok = mpfr_equal_p (a1, a2);
+        }
+      else
+        {
+          inex2 = mpfr_set (a2, t, rnd);
+          ok = mpfr_equal_p (a1, a2) && SAME_SIGN (inex1, inex2);
+        }
+      if (! ok)
+        {
+          printf ("Error in check_truncated for %s\nb = ",
+                  mpfr_print_rnd_mode (rnd));
+          mpfr_dump (b);
+          printf ("c = ");
+          mpfr_dump (c);
+          printf ("got      ");
+          mpfr_dump (a1);
+          printf ("expected ");
+          mpfr_dump (a2);
+          printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+          exit (1);
+        }
+    }
+  mpfr_clears (a1, a2, b, c, t, (mpfr_ptr) 0);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -683,6 +806,8 @@ main (int argc, char *argv[])
   check_min();
 
   check_regression ();
+  check_few_bits ();
+  check_truncated ();
   test_generic (2, 500, 100);
 
   data_check ("data/mulpi", mpfr_mulpi, "mpfr_mulpi");
@@ -0,0 +1,181 @@
+/* Test file for mpfr_nrandom
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+static void
+test_special (mpfr_prec_t p)
+{
+  mpfr_t x;
+  int inexact;
+
+  mpfr_init2 (x, p);
+
+  inexact = mpfr_nrandom (x, RANDS, MPFR_RNDN);
+  if (inexact == 0)
+    {
+      printf ("Error: mpfr_nrandom() returns a zero ternary value.\n");
+      exit (1);
+    }
+
+  mpfr_clear (x);
+}
+
+/* Check the sample mean and variance, with bounds at more than 5 standard
+   deviations for 1000 samples. */
+static void
+test_nrandom (long nbtests, mpfr_prec_t prec, mpfr_rnd_t rnd,
+              int verbose)
+{
+  mpfr_t x;
+  double d, av = 0.0, va = 0.0;
+  long i;
+
+  mpfr_init2 (x, prec);
+  for (i = 0; i < nbtests; i++)
+    {
+      if (mpfr_nrandom (x, RANDS, rnd) == 0)
+        {
+          printf ("Error: mpfr_nrandom() returns a zero ternary value.\n");
+          exit (1);
+        }
+      d = mpfr_get_d (x, MPFR_RNDN);
+      av += d;
+      va += d * d;
+    }
+  mpfr_clear (x);
+
+  av /= nbtests;
+  va = va / nbtests - av * av;
+  if (verbose)
+    printf ("Average = %.5f\nVariance = %.5f\n", av, va);
+  if (nbtests >= 1000 && (av < -0.2 || av > 0.2 || va < 0.75 || va > 1.25))
+    {
+      printf ("Error: mpfr_nrandom() gives average %f and variance %f\n",
+              av, va);
+      exit (1);
+    }
+}
+
+/* Check that the same deviate is correctly rounded in all the directions:
+   the random state is seeded identically for each rounding mode. */
+static void
+test_rnd (mpfr_prec_t prec)
+{
+  gmp_randstate_t s;
+  mpfr_t x[5], y;
+  int inex[5], r, neg;
+  unsigned long seed;
+
+  seed = randlimb ();
+  for (r = 0; r < 5; r++)
+    {
+      mpfr_init2 (x[r], prec);
+      gmp_randinit_default (s);
+      gmp_randseed_ui (s, seed);
+      inex[r] = mpfr_nrandom (x[r], s, (mpfr_rnd_t) r);
+      gmp_randclear (s);
+    }
+  mpfr_init2 (y, prec);
+  mpfr_set (y, x[MPFR_RNDD], MPFR_RNDN);
+  mpfr_nextabove (y);
+  neg = MPFR_IS_NEG (x[MPFR_RNDD]);
+  if (inex[MPFR_RNDD] >= 0 || inex[MPFR_RNDU] <= 0 || inex[MPFR_RNDN] == 0
+      || ! mpfr_equal_p (y, x[MPFR_RNDU])
+      || ! mpfr_equal_p (x[MPFR_RNDZ], x[neg ? MPFR_RNDU : MPFR_RNDD])
+      || ! mpfr_equal_p (x[MPFR_RNDA], x[neg ? MPFR_RNDD : MPFR_RNDU])
+      || ! mpfr_equal_p (x[MPFR_RNDN],
+                         x[inex[MPFR_RNDN] > 0 ? MPFR_RNDU : MPFR_RNDD]))
+    {
+      printf ("Error: inconsistent rounding in mpfr_nrandom() for prec=%lu,"
+              " seed=%lu\n", (unsigned long) prec, seed);
+      for (r = 0; r < 5; r++)
+        {
+          printf ("%s: inex=%d x=", mpfr_print_rnd_mode ((mpfr_rnd_t) r),
+                  inex[r]);
+          mpfr_dump (x[r]);
+        }
+      exit (1);
+    }
+  for (r = 0; r < 5; r++)
+    mpfr_clear (x[r]);
+  mpfr_clear (y);
+}
+
+/* With emax = 1, |x| >= 2 overflows. */
+static void
+test_overflow (void)
+{
+  mpfr_exp_t emax;
+  mpfr_t x;
+  int i, inex;
+
+  emax = mpfr_get_emax ();
+  set_emax (1);
+  mpfr_init2 (x, 20);
+  for (i = 0; i < 100; i++)
+    {
+      mpfr_clear_flags ();
+      inex = mpfr_nrandom (x, RANDS, MPFR_RNDN);
+      if (inex == 0 || (mpfr_inf_p (x) != 0) != (mpfr_overflow_p () != 0)
+          || (mpfr_inf_p (x) && (MPFR_IS_NEG (x) ? inex > 0 : inex < 0)))
+        {
+          printf ("Error: mpfr_nrandom() with emax=1, inex=%d, x=", inex);
+          mpfr_dump (x);
+          exit (1);
+        }
+    }
+  mpfr_clear (x);
+  set_emax (emax);
+}
+
+int
+main (int argc, char *argv[])
+{
+  long nbtests;
+  int verbose, i;
+  tests_start_mpfr ();
+
+  verbose = 0;
+  nbtests = 1000;
+  if (argc > 1)
+    {
+      long a = atol (argv[1]);
+      verbose = 1;
+      if (a != 0)
+        nbtests = a;
+    }
+
+  test_nrandom (nbtests, 53, MPFR_RNDN, verbose);
+  test_nrandom (100, 420, MPFR_RNDD, 0);
+  test_special (2);
+  test_special (42000);
+  for (i = 0; i < 100; i++)
+    test_rnd (MPFR_PREC_MIN + (randlimb () % 200));
+  test_overflow ();
+
+  tests_end_mpfr ();
+  return 0;
+}
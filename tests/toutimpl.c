@@ -64,8 +64,13 @@ main (void)
       printf ("Error for printing MPFR_RNDZ\n");
       exit (1);
     }
+  if (strcmp (mpfr_print_rnd_mode(MPFR_RNDF), "MPFR_RNDF"))
+    {
+      printf ("Error for printing MPFR_RNDF\n");
+      exit (1);
+    }
   if (mpfr_print_rnd_mode ((mpfr_rnd_t) -1) != NULL ||
-      mpfr_print_rnd_mode (MPFR_RND_MAX) != NULL)
+      mpfr_print_rnd_mode ((mpfr_rnd_t) (MPFR_RNDF + 1)) != NULL)
     {
       printf ("Error for illegal rounding mode values.\n");
       exit (1);
@@ -0,0 +1,304 @@
+/* Test file for mpfr_set_allocator_mode, mpfr_get_allocator_mode,
+   mpfr_set_workspace and mpfr_get_workspace_peak
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+static void
+check_mode (int mode, int expected_old)
+{
+  int old;
+
+  old = mpfr_set_allocator_mode (mode);
+  if (old != expected_old || mpfr_get_allocator_mode () != mode)
+    {
+      printf ("Error in mpfr_set_allocator_mode (%d): old mode %d (expected"
+              " %d), new mode %d\n", mode, old, expected_old,
+              mpfr_get_allocator_mode ());
+      exit (1);
+    }
+}
+
+/* In the pool mode, a significand freed by mpfr_clear is reused by the
+   next mpfr_init2 with the same precision. */
+static void
+check_reuse (void)
+{
+  mpfr_t x, y;
+  mp_limb_t *p;
+
+  check_mode (MPFR_ALLOCATOR_POOL, MPFR_ALLOCATOR_DEFAULT);
+  mpfr_init2 (x, 200);
+  p = MPFR_MANT (x);
+  mpfr_clear (x);
+  mpfr_init2 (y, 200);
+  if (MPFR_MANT (y) != p)
+    {
+      printf ("Error: the block freed by mpfr_clear is not reused\n");
+      exit (1);
+    }
+  mpfr_clear (y);
+  check_mode (MPFR_ALLOCATOR_DEFAULT, MPFR_ALLOCATOR_POOL);
+}
+
+/* The significands allocated in the pool mode go back to the pool of
+   their owner; a block whose owner has released its pool by calling
+   mpfr_free_cache is taken by the thread that frees it. This is checked
+   in a single thread, with the memory checker of the test suite for the
+   sizes of the blocks. */
+static void
+check_owner (void)
+{
+  mpfr_t x, y;
+  mp_limb_t *p;
+
+  check_mode (MPFR_ALLOCATOR_POOL, MPFR_ALLOCATOR_DEFAULT);
+  mpfr_init2 (x, 200);
+  mpfr_set_ui (x, 3, MPFR_RNDN);
+  MPFR_ASSERTN (MPFR_GET_ALLOC_SIZE (x) == MPFR_PREC2LIMBS (200));
+  mpfr_prec_round (x, 1000, MPFR_RNDN);
+  MPFR_ASSERTN (MPFR_GET_ALLOC_SIZE (x) == MPFR_PREC2LIMBS (1000));
+  MPFR_ASSERTN (mpfr_cmp_ui (x, 3) == 0);
+  p = MPFR_MANT (x);
+  mpfr_free_cache ();
+  mpfr_clear (x);
+  mpfr_init2 (y, 1000);
+  if (MPFR_MANT (y) != p)
+    {
+      printf ("Error: the block of a released owner is not reused\n");
+      exit (1);
+    }
+  check_mode (MPFR_ALLOCATOR_DEFAULT, MPFR_ALLOCATOR_POOL);
+  mpfr_set_prec (y, 2000);
+  mpfr_clear (y);
+}
+
+/* Compute a few functions in precision prec, which use the groups and the
+   temporary allocations for the large precisions, and return the sum of
+   the results in z. */
+static void
+compute (mpfr_ptr z, mpfr_prec_t prec, unsigned long k)
+{
+  mpfr_t x, y;
+
+  mpfr_init2 (x, prec);
+  mpfr_init2 (y, prec);
+  mpfr_set_ui (x, k, MPFR_RNDN);
+  mpfr_div_ui (x, x, 7, MPFR_RNDN);
+  mpfr_log (y, x, MPFR_RNDN);
+  mpfr_set (z, y, MPFR_RNDN);
+  mpfr_exp (y, x, MPFR_RNDU);
+  mpfr_add (z, z, y, MPFR_RNDN);
+  mpfr_set_prec (x, prec + 100);
+  mpfr_const_pi (x, MPFR_RNDN);
+  mpfr_sin (y, x, MPFR_RNDZ);
+  mpfr_add (z, z, y, MPFR_RNDN);
+  mpfr_sqrt_ui (y, k, MPFR_RNDD);
+  mpfr_add (z, z, y, MPFR_RNDN);
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+/* The results do not depend on the mode. The blocks allocated in a mode
+   and freed in the other one are also checked, and the memory checker of
+   the test suite checks the sizes given back to the GMP memory functions
+   (in particular by mpfr_free_cache). */
+static void
+check_results (void)
+{
+  mpfr_t z1, z2, t;
+  mpfr_prec_t prec;
+  unsigned long k;
+
+  for (prec = MPFR_PREC_MIN; prec < 20000; prec += prec / 2 + 1)
+    for (k = 1; k < 4; k++)
+      {
+        mpfr_inits2 (prec, z1, z2, (mpfr_ptr) 0);
+        compute (z1, prec, k);
+        check_mode (MPFR_ALLOCATOR_POOL, MPFR_ALLOCATOR_DEFAULT);
+        mpfr_init2 (t, prec + k);
+        compute (z2, prec, k);
+        compute (z2, prec, k);
+        mpfr_free_cache ();
+        if (! mpfr_equal_p (z1, z2))
+          {
+            printf ("Error: different results in the pool mode for"
+                    " prec=%lu, k=%lu\n", (unsigned long) prec, k);
+            mpfr_dump (z1);
+            mpfr_dump (z2);
+            exit (1);
+          }
+        mpfr_clear (z1);
+        check_mode (MPFR_ALLOCATOR_DEFAULT, MPFR_ALLOCATOR_POOL);
+        mpfr_set_prec (t, 2 * prec);
+        mpfr_clears (z2, t, (mpfr_ptr) 0);
+      }
+}
+
+#define WS_LIMBS 100000
+
+static mp_limb_t ws[WS_LIMBS];
+
+/* With a workspace, the significands and the temporary blocks are carved
+   from the buffer, the results are the same, and the workspace can only
+   be unbound when all its blocks have been freed. */
+static void
+check_workspace (void)
+{
+  mpfr_t x, z1, z2;
+  mpfr_prec_t prec;
+  size_t peak, size = sizeof (ws);
+  unsigned long k;
+  int mode;
+
+  if (mpfr_get_workspace_peak () != 0)
+    {
+      printf ("Error: mpfr_get_workspace_peak() is non-zero without any"
+              " workspace\n");
+      exit (1);
+    }
+  for (mode = 0; mode < 2; mode++)
+    for (prec = MPFR_PREC_MIN; prec < 10000; prec += prec / 2 + 1)
+      for (k = 1; k < 4; k++)
+        {
+          mpfr_inits2 (prec, z1, z2, (mpfr_ptr) 0);
+          compute (z1, prec, k);
+          mpfr_set_allocator_mode (mode);
+          /* misaligned buffer */
+          if (mpfr_set_workspace ((char *) ws + (k & 1), size - 1) != 0)
+            {
+              printf ("Error: mpfr_set_workspace() fails\n");
+              exit (1);
+            }
+          mpfr_init2 (x, prec);
+          if ((char *) MPFR_MANT (x) < (char *) ws
+              || (char *) MPFR_MANT (x) >= (char *) ws + size)
+            {
+              printf ("Error: the significand is not in the workspace\n");
+              exit (1);
+            }
+          compute (x, prec, k);
+          compute (x, prec, k);
+          mpfr_set (z2, x, MPFR_RNDN);
+          if (mpfr_set_workspace (NULL, 0) == 0)
+            {
+              printf ("Error: the workspace is unbound while in use\n");
+              exit (1);
+            }
+          mpfr_clear (x);
+          /* The caches of the constants may be in the workspace. */
+          mpfr_free_cache ();
+          peak = mpfr_get_workspace_peak ();
+          if (peak == 0 || peak > size)
+            {
+              printf ("Error: wrong workspace peak %lu for prec=%lu\n",
+                      (unsigned long) peak, (unsigned long) prec);
+              exit (1);
+            }
+          if (mpfr_set_workspace (NULL, 0) != 0)
+            {
+              printf ("Error: the workspace cannot be unbound\n");
+              exit (1);
+            }
+          mpfr_set_allocator_mode (MPFR_ALLOCATOR_DEFAULT);
+          if (! mpfr_equal_p (z1, z2))
+            {
+              printf ("Error: different results with a workspace for"
+                      " prec=%lu, k=%lu\n", (unsigned long) prec, k);
+              mpfr_dump (z1);
+              mpfr_dump (z2);
+              exit (1);
+            }
+          mpfr_clears (z1, z2, (mpfr_ptr) 0);
+        }
+}
+
+#define IN_WS(x) \
+  ((char *) MPFR_MANT (x) >= (char *) ws                \
+   && (char *) MPFR_MANT (x) < (char *) ws + sizeof (ws))
+
+/* The numbers allocated before the workspace has been bound can be
+   cleared or reallocated while it is bound, and those allocated in the
+   workspace can be cleared or reallocated by the same thread while it is
+   still bound (reallocating the last block in place). */
+static void
+check_workspace_clear (void)
+{
+  mpfr_t x, y, z;
+  mp_limb_t *p;
+
+  mpfr_init2 (y, 100);
+  mpfr_init2 (z, 100);
+  mpfr_set_ui (z, 17, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_set_workspace (ws, sizeof (ws)) == 0);
+  mpfr_init2 (x, 100);
+  MPFR_ASSERTN (IN_WS (x) && ! IN_WS (y));
+  mpfr_clear (y);
+  /* z goes to the workspace, keeping its value */
+  mpfr_prec_round (z, 1000, MPFR_RNDN);
+  MPFR_ASSERTN (IN_WS (z) && mpfr_cmp_ui (z, 17) == 0);
+  p = MPFR_MANT (z);
+  mpfr_set_prec (z, 2000);
+  MPFR_ASSERTN (MPFR_MANT (z) == p);
+  MPFR_ASSERTN (MPFR_GET_ALLOC_SIZE (z) == MPFR_PREC2LIMBS (2000));
+  mpfr_set_prec (x, 200);
+  MPFR_ASSERTN (IN_WS (x) && MPFR_GET_ALLOC_SIZE (x) == MPFR_PREC2LIMBS (200));
+  mpfr_clears (x, z, (mpfr_ptr) 0);
+  if (mpfr_set_workspace (NULL, 0) != 0)
+    {
+      printf ("Error: the workspace cannot be unbound after the clears\n");
+      exit (1);
+    }
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  if (mpfr_get_allocator_mode () != MPFR_ALLOCATOR_DEFAULT)
+    {
+      printf ("Error: the default mode is not MPFR_ALLOCATOR_DEFAULT\n");
+      exit (1);
+    }
+  check_reuse ();
+  check_owner ();
+  check_results ();
+  check_workspace ();
+  check_workspace_clear ();
+
+  /* The pool is left non-empty: it is emptied by mpfr_free_cache, which
+     is called by tests_end_mpfr. */
+  check_mode (MPFR_ALLOCATOR_POOL, MPFR_ALLOCATOR_DEFAULT);
+  {
+    mpfr_t z;
+
+    mpfr_init2 (z, 1000);
+    compute (z, 1000, 5);
+    mpfr_clear (z);
+  }
+  tests_end_mpfr ();
+  return 0;
+}
@@ -143,6 +143,84 @@ check_nan_inf_mpq (void)
   mpfr_clear (mpfr_value);
 }
 
+/* Check mpfr_set_q on random rationals with large numerators and
+   denominators, using the exact comparison mpfr_cmp_q: the results in
+   the different rounding modes must surround q. */
+static void
+check_random (int nmax)
+{
+  mpq_t q;
+  mpfr_t y[MPFR_RND_MAX], t;
+  mpfr_prec_t p;
+  int inex[MPFR_RND_MAX], r, n, c;
+
+  mpq_init (q);
+  mpfr_init2 (t, MPFR_PREC_MIN);
+  for (r = 0; r < MPFR_RND_MAX; r++)
+    mpfr_init2 (y[r], MPFR_PREC_MIN);
+
+  for (n = 0; n < nmax; n++)
+    {
+      p = MPFR_PREC_MIN + randlimb () % 300;
+      mpz_urandomb (mpq_numref (q), RANDS, 1 + randlimb () % 2000);
+      mpz_urandomb (mpq_denref (q), RANDS, 1 + randlimb () % 2000);
+      mpz_add_ui (mpq_numref (q), mpq_numref (q), 1);
+      mpz_add_ui (mpq_denref (q), mpq_denref (q), 1);
+      if (n & 1)
+        mpz_neg (mpq_numref (q), mpq_numref (q));
+      mpq_canonicalize (q);
+      RND_LOOP (r)
+        {
+          mpfr_set_prec (y[r], p);
+          inex[r] = mpfr_set_q (y[r], q, (mpfr_rnd_t) r);
+          c = mpfr_cmp_q (y[r], q);
+          if (! SAME_SIGN (c, inex[r]))
+            {
+              printf ("Error in check_random: wrong ternary value for %s,"
+                      " got %d, expected %d\nq=",
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) r), inex[r], c);
+              mpq_out_str (stdout, 16, q);
+              printf ("\ny=");
+              mpfr_dump (y[r]);
+              exit (1);
+            }
+        }
+      mpfr_set_prec (t, p);
+      mpfr_set (t, y[MPFR_RNDD], MPFR_RNDN);
+      if (inex[MPFR_RNDD] != 0)
+        mpfr_nextabove (t);
+      if (! mpfr_equal_p (t, y[MPFR_RNDU])
+          || ! mpfr_equal_p (y[MPFR_RNDZ], y[n & 1 ? MPFR_RNDU : MPFR_RNDD])
+          || ! mpfr_equal_p (y[MPFR_RNDA], y[n & 1 ? MPFR_RNDD : MPFR_RNDU]))
+        goto error;
+      /* compare q with the middle of y[RNDD] and y[RNDU] */
+      mpfr_set_prec (t, p + 1);
+      mpfr_add (t, y[MPFR_RNDD], y[MPFR_RNDU], MPFR_RNDN);
+      mpfr_div_2ui (t, t, 1, MPFR_RNDN);
+      c = mpfr_cmp_q (t, q);
+      if (! mpfr_equal_p (y[MPFR_RNDN], y[c > 0 ? MPFR_RNDD : MPFR_RNDU])
+          && ! (c == 0 && mpfr_equal_p (y[MPFR_RNDN], y[MPFR_RNDD])))
+        goto error;
+    }
+
+  for (r = 0; r < MPFR_RND_MAX; r++)
+    mpfr_clear (y[r]);
+  mpfr_clear (t);
+  mpq_clear (q);
+  return;
+
+ error:
+  printf ("Error in check_random: inconsistent rounding\nq=");
+  mpq_out_str (stdout, 16, q);
+  putchar ('\n');
+  RND_LOOP (r)
+    {
+      printf ("%s: ", mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+      mpfr_dump (y[r]);
+    }
+  exit (1);
+}
+
 int
 main (void)
 {
@@ -161,6 +239,7 @@ main (void)
   check0();
 
   check_nan_inf_mpq ();
+  check_random (1000);
 
   tests_end_mpfr ();
   return 0;
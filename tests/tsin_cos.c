@@ -661,6 +661,175 @@ coverage_01032011 (void)
   mpfr_clears(val, cval, sval, svalf, (mpfr_ptr) 0);
 }
 
+/* check the Payne-Hanek reduction used for huge arguments against a
+   reduction with mpfr_remainder at high precision */
+static void
+check_huge (void)
+{
+  mpfr_t x, s, c, t, sref, cref, xr, pi2;
+  mpfr_exp_t e[] = { MPFR_REDUCE_THRESHOLD, 5000, 100000 };
+  mpfr_prec_t p = 300;
+  mpfr_rnd_t r;
+  int i, j;
+
+  mpfr_inits2 (53, x, s, c, t, (mpfr_ptr) 0);
+  mpfr_inits2 (p, sref, cref, xr, (mpfr_ptr) 0);
+  for (i = 0; i < (int) (sizeof (e) / sizeof (e[0])); i++)
+    for (j = 0; j < 4; j++)
+      {
+        mpfr_urandomb (x, RANDS);
+        if (MPFR_IS_ZERO (x))
+          continue;
+        mpfr_set_exp (x, e[i]);
+        if (j & 1)
+          mpfr_neg (x, x, MPFR_RNDN);
+        r = RND_RAND ();
+
+        mpfr_init2 (pi2, e[i] + p);
+        mpfr_const_pi (pi2, MPFR_RNDN);
+        mpfr_mul_2ui (pi2, pi2, 1, MPFR_RNDN);
+        mpfr_remainder (xr, x, pi2, MPFR_RNDN);
+        mpfr_clear (pi2);
+        mpfr_sin_cos (sref, cref, xr, MPFR_RNDN);
+
+        mpfr_sin (s, x, r);
+        mpfr_set (t, sref, r);
+        if (! mpfr_equal_p (s, t))
+          {
+            printf ("Error in mpfr_sin for huge argument, rnd=%s\nx=",
+                    mpfr_print_rnd_mode (r));
+            mpfr_dump (x);
+            printf ("expected "); mpfr_dump (t);
+            printf ("got      "); mpfr_dump (s);
+            exit (1);
+          }
+        mpfr_cos (c, x, r);
+        mpfr_set (t, cref, r);
+        if (! mpfr_equal_p (c, t))
+          {
+            printf ("Error in mpfr_cos for huge argument, rnd=%s\nx=",
+                    mpfr_print_rnd_mode (r));
+            mpfr_dump (x);
+            printf ("expected "); mpfr_dump (t);
+            printf ("got      "); mpfr_dump (c);
+            exit (1);
+          }
+        mpfr_sin_cos (s, c, x, r);
+        mpfr_set (t, sref, r);
+        MPFR_ASSERTN (mpfr_equal_p (s, t));
+        mpfr_set (t, cref, r);
+        MPFR_ASSERTN (mpfr_equal_p (c, t));
+        mpfr_sincos_fast (s, c, x, r);
+        mpfr_set (t, sref, r);
+        MPFR_ASSERTN (mpfr_equal_p (s, t));
+        mpfr_set (t, cref, r);
+        MPFR_ASSERTN (mpfr_equal_p (c, t));
+        mpfr_tan (s, x, r);
+        mpfr_div (sref, sref, cref, MPFR_RNDN);
+        mpfr_set (t, sref, r);
+        MPFR_ASSERTN (mpfr_equal_p (s, t));
+      }
+  mpfr_clears (x, s, c, t, sref, cref, xr, (mpfr_ptr) 0);
+}
+
+/* Check sin and cos near multiples of Pi/2, where the reduced argument
+   suffers from cancellation. The reference values are obtained from
+   d = x - k*Pi/2, computed with Pi in a much larger precision, with |d| <
+   Pi/4 < 1 thus without any argument reduction. */
+static void
+check_near_pi2 (void)
+{
+  mpfr_t x, s, c, t, sref, cref, pi2, d;
+  mpfr_prec_t px, py;
+  mpfr_rnd_t r;
+  long k;
+  int i;
+
+  for (i = 0; i < 50; i++)
+    {
+      px = 2 + (randlimb () % 200);
+      py = 2 + (randlimb () % 100);
+      mpfr_init2 (x, px);
+      mpfr_inits2 (py, s, c, t, (mpfr_ptr) 0);
+      mpfr_inits2 (py + 2 * px + 50, sref, cref, (mpfr_ptr) 0);
+      mpfr_init2 (d, py + 2 * px + 60);
+      mpfr_init2 (pi2, MPFR_PREC (d) + px + 30);
+      mpfr_const_pi (x, MPFR_RNDN);
+      mpfr_mul_ui (x, x, 1 + (randlimb () % 100), MPFR_RNDN);
+      mpfr_div_2ui (x, x, 1, MPFR_RNDN);
+      if (i & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      r = RND_RAND ();
+
+      /* sref and cref have enough bits to determine the roundings, since
+         d = |x - k*Pi/2| >= 2^(-px-8) for k <= 100, and the distance of
+         sin(x) or cos(x) to -1, 0 or 1 is at least about d^2/2; the
+         absolute error on k*Pi/2 is much less than 2^(-PREC(d)) * |d| */
+      mpfr_const_pi (pi2, MPFR_RNDN);
+      mpfr_div_2ui (pi2, pi2, 1, MPFR_RNDN);
+      mpfr_div (d, x, pi2, MPFR_RNDN);
+      k = mpfr_get_si (d, MPFR_RNDN);
+      mpfr_mul_si (pi2, pi2, k, MPFR_RNDN);
+      mpfr_sub (d, x, pi2, MPFR_RNDN);
+      switch (((k % 4) + 4) % 4)
+        {
+        case 0:
+          mpfr_sin (sref, d, MPFR_RNDN);
+          mpfr_cos (cref, d, MPFR_RNDN);
+          break;
+        case 1:
+          mpfr_cos (sref, d, MPFR_RNDN);
+          mpfr_sin (cref, d, MPFR_RNDN);
+          mpfr_neg (cref, cref, MPFR_RNDN);
+          break;
+        case 2:
+          mpfr_sin (sref, d, MPFR_RNDN);
+          mpfr_cos (cref, d, MPFR_RNDN);
+          mpfr_neg (sref, sref, MPFR_RNDN);
+          mpfr_neg (cref, cref, MPFR_RNDN);
+          break;
+        default:
+          mpfr_cos (sref, d, MPFR_RNDN);
+          mpfr_sin (cref, d, MPFR_RNDN);
+          mpfr_neg (sref, sref, MPFR_RNDN);
+        }
+
+      mpfr_sin (s, x, r);
+      mpfr_set (t, sref, r);
+      if (! mpfr_equal_p (s, t))
+        {
+          printf ("Error in mpfr_sin near k*Pi/2, rnd=%s\nx=",
+                  mpfr_print_rnd_mode (r));
+          mpfr_dump (x);
+          printf ("expected "); mpfr_dump (t);
+          printf ("got      "); mpfr_dump (s);
+          exit (1);
+        }
+      mpfr_cos (c, x, r);
+      mpfr_set (t, cref, r);
+      if (! mpfr_equal_p (c, t))
+        {
+          printf ("Error in mpfr_cos near k*Pi/2, rnd=%s\nx=",
+                  mpfr_print_rnd_mode (r));
+          mpfr_dump (x);
+          printf ("expected "); mpfr_dump (t);
+          printf ("got      "); mpfr_dump (c);
+          exit (1);
+        }
+      mpfr_sin_cos (s, c, x, r);
+      mpfr_set (t, sref, r);
+      MPFR_ASSERTN (mpfr_equal_p (s, t));
+      mpfr_set (t, cref, r);
+      MPFR_ASSERTN (mpfr_equal_p (c, t));
+      mpfr_sincos_fast (s, c, x, r);
+      mpfr_set (t, sref, r);
+      MPFR_ASSERTN (mpfr_equal_p (s, t));
+      mpfr_set (t, cref, r);
+      MPFR_ASSERTN (mpfr_equal_p (c, t));
+      mpfr_clears (x, s, c, t, sref, cref, pi2, d, (mpfr_ptr) 0);
+    }
+}
+
 /* tsin_cos prec [N] performs N tests with prec bits */
 int
 main (int argc, char *argv[])
@@ -715,6 +884,8 @@ main (int argc, char *argv[])
   test20071214 ();
 
   coverage_01032011 ();
+  check_huge ();
+  check_near_pi2 ();
 
  end:
   tests_end_mpfr ();
@@ -0,0 +1,278 @@
+/* Test file for mpfr_sin_cos_seq.
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+#define NMAX 700
+
+/* check s[k] and c[k] against mpfr_sin and mpfr_cos at x0 + k*h */
+static void
+check_seq (mpfr_ptr *s, mpfr_ptr *c, mpfr_srcptr x0, mpfr_srcptr h,
+           unsigned long n, mpfr_rnd_t rnd)
+{
+  mpfr_t x, y;
+  unsigned long k;
+  int inex, inex_ref = 0;
+
+  mpfr_clear_flags ();
+  inex = mpfr_sin_cos_seq (s, c, x0, h, n, rnd);
+  MPFR_ASSERTN (!mpfr_erangeflag_p () && !mpfr_nanflag_p ());
+  mpfr_init2 (x, MPFR_PREC (x0) + MPFR_PREC (h) + 100);
+  mpfr_init2 (y, MPFR_PREC_MIN);
+  for (k = 0; k < n; k++)
+    {
+      mpfr_mul_ui (x, h, k, MPFR_RNDN);
+      mpfr_add (x, x, x0, MPFR_RNDN);
+      if (s != NULL)
+        {
+          mpfr_set_prec (y, MPFR_PREC (s[k]));
+          inex_ref |= mpfr_sin (y, x, rnd) != 0;
+          if (! mpfr_equal_p (y, s[k]) || MPFR_SIGN (y) != MPFR_SIGN (s[k]))
+            goto error;
+        }
+      if (c != NULL)
+        {
+          mpfr_set_prec (y, MPFR_PREC (c[k]));
+          inex_ref |= mpfr_cos (y, x, rnd) != 0;
+          if (! mpfr_equal_p (y, c[k]))
+            goto error;
+        }
+    }
+  if ((inex != 0) != inex_ref)
+    {
+      printf ("Wrong ternary value in mpfr_sin_cos_seq: expected %d, "
+              "got %d\n", inex_ref, inex);
+      exit (1);
+    }
+  mpfr_clears (x, y, (mpfr_ptr) 0);
+  return;
+
+ error:
+  printf ("Error in mpfr_sin_cos_seq for k=%lu, n=%lu, rnd=%s\nx0=", k, n,
+          mpfr_print_rnd_mode (rnd));
+  mpfr_dump (x0);
+  printf ("h=");
+  mpfr_dump (h);
+  printf ("expected ");
+  mpfr_dump (y);
+  exit (1);
+}
+
+static void
+check_random (void)
+{
+  mpfr_t st[NMAX], ct[NMAX], x0, h;
+  mpfr_ptr s[NMAX], c[NMAX];
+  mpfr_exp_t emin;
+  unsigned long n, k;
+  int i;
+
+  for (k = 0; k < NMAX; k++)
+    {
+      s[k] = st[k];
+      c[k] = ct[k];
+      mpfr_init2 (s[k], MPFR_PREC_MIN);
+      mpfr_init2 (c[k], MPFR_PREC_MIN);
+    }
+  mpfr_init2 (x0, 100);
+  mpfr_init2 (h, 100);
+  for (i = 0; i < 20; i++)
+    {
+      n = (i < 4) ? NMAX : 1 + randlimb () % 50;
+      for (k = 0; k < n; k++)
+        {
+          mpfr_set_prec (s[k], 2 + randlimb () % 150);
+          mpfr_set_prec (c[k], (i & 1) ? MPFR_PREC (s[k])
+                         : 2 + (mpfr_prec_t) (randlimb () % 150));
+        }
+      mpfr_set_prec (x0, 2 + randlimb () % 200);
+      mpfr_set_prec (h, 2 + randlimb () % 200);
+      mpfr_urandomb (x0, RANDS);
+      mpfr_urandomb (h, RANDS);
+      mpfr_mul_2si (x0, x0, (int) (randlimb () % 20) - 5, MPFR_RNDN);
+      mpfr_mul_2si (h, h, -(int) (randlimb () % 12), MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (x0, x0, MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (h, h, MPFR_RNDN);
+      check_seq (s, (i % 3 == 2) ? NULL : c, x0, h, n, RND_RAND ());
+    }
+
+  /* h = 0, x0 = 0 */
+  mpfr_set_prec (x0, 100);
+  mpfr_set_ui (x0, 0, MPFR_RNDN);
+  mpfr_set_ui (h, 0, MPFR_RNDN);
+  check_seq (s, c, x0, h, 10, MPFR_RNDN);
+  mpfr_set_ui_2exp (h, 1, -3, MPFR_RNDN);
+  check_seq (s, c, x0, h, NMAX, MPFR_RNDZ);
+  /* x0 + k*h goes through zero */
+  mpfr_set_si (x0, -100, MPFR_RNDN);
+  check_seq (NULL, c, x0, h, NMAX, MPFR_RNDU);
+  check_seq (s, c, x0, h, NMAX, MPFR_RNDN);
+
+  /* twiddle factors in a reduced exponent range */
+  emin = mpfr_get_emin ();
+  set_emin (-10);
+  mpfr_set_prec (h, 128);
+  mpfr_const_pi (h, MPFR_RNDN);
+  mpfr_div_ui (h, h, 256, MPFR_RNDN);
+  mpfr_set_ui (x0, 0, MPFR_RNDN);
+  for (k = 0; k < 512; k++)
+    {
+      mpfr_set_prec (s[k], 100);
+      mpfr_set_prec (c[k], 100);
+    }
+  check_seq (s, c, x0, h, 512, MPFR_RNDN);
+  set_emin (emin);
+
+  /* NaN */
+  mpfr_set_nan (h);
+  mpfr_clear_flags ();
+  mpfr_sin_cos_seq (s, c, x0, h, 3, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_nanflag_p ());
+  MPFR_ASSERTN (mpfr_nan_p (s[0]) && mpfr_nan_p (c[2]));
+
+  mpfr_clears (x0, h, (mpfr_ptr) 0);
+  for (k = 0; k < NMAX; k++)
+    {
+      mpfr_clear (s[k]);
+      mpfr_clear (c[k]);
+    }
+}
+
+/* outputs that are the same variables as x0 or h */
+static void
+check_alias (void)
+{
+  mpfr_t st[3], ct[3], x0, h, x, y;
+  mpfr_ptr s[3], c[3];
+  int k, inex;
+
+  mpfr_inits2 (53, x0, h, y, (mpfr_ptr) 0);
+  mpfr_init2 (x, 200);
+  mpfr_set_str (x0, "1.25", 10, MPFR_RNDN);
+  mpfr_set_str (h, "0.1", 10, MPFR_RNDN);
+  for (k = 0; k < 3; k++)
+    {
+      mpfr_init2 (st[k], 53);
+      mpfr_init2 (ct[k], 53);
+      s[k] = st[k];
+      c[k] = ct[k];
+    }
+  /* x0 is s[0] and h is c[1] */
+  mpfr_set (st[0], x0, MPFR_RNDN);
+  mpfr_set (ct[1], h, MPFR_RNDN);
+  inex = mpfr_sin_cos_seq (s, c, st[0], ct[1], 3, MPFR_RNDN);
+  MPFR_ASSERTN (inex == 1);
+  for (k = 0; k < 3; k++)
+    {
+      mpfr_mul_ui (x, h, k, MPFR_RNDN);
+      mpfr_add (x, x, x0, MPFR_RNDN);
+      mpfr_sin (y, x, MPFR_RNDN);
+      if (! mpfr_equal_p (y, s[k]))
+        goto error;
+      mpfr_cos (y, x, MPFR_RNDN);
+      if (! mpfr_equal_p (y, c[k]))
+        goto error;
+    }
+  for (k = 0; k < 3; k++)
+    {
+      mpfr_clear (st[k]);
+      mpfr_clear (ct[k]);
+    }
+  mpfr_clears (x0, h, x, y, (mpfr_ptr) 0);
+  return;
+
+ error:
+  printf ("Error in mpfr_sin_cos_seq with aliased inputs, k=%d\n", k);
+  exit (1);
+}
+
+/* x0 and h with very different exponents: the points x0 + k*h, k > 0,
+   are not representable in a reasonable precision, and their sine and
+   cosine round like those of x0 */
+static void
+check_far_exponents (void)
+{
+  mpfr_t st[3], ct[3], x0, h, y;
+  mpfr_ptr s[3], c[3];
+  mpfr_exp_t emin;
+  int k, r, inex;
+
+  mpfr_inits2 (53, x0, h, y, (mpfr_ptr) 0);
+  for (k = 0; k < 3; k++)
+    {
+      mpfr_init2 (st[k], 53);
+      mpfr_init2 (ct[k], 42);
+      s[k] = st[k];
+      c[k] = ct[k];
+    }
+  mpfr_set_str (x0, "1.2345678901234", 10, MPFR_RNDN);
+  mpfr_mul_2ui (x0, x0, 60, MPFR_RNDN);
+  emin = mpfr_get_emin ();
+  for (k = 0; k < 2; k++)
+    {
+      if (k == 0)
+        mpfr_set_ui_2exp (h, 1, -1000000000, MPFR_RNDN);
+      else
+        {
+          set_emin (MPFR_EMIN_MIN);
+          mpfr_set_ui_2exp (h, 3, MPFR_EMIN_MIN - 2, MPFR_RNDN);
+        }
+      RND_LOOP (r)
+        {
+          inex = mpfr_sin_cos_seq (s, c, x0, h, 3, (mpfr_rnd_t) r);
+          MPFR_ASSERTN (inex == 1);
+          mpfr_set_prec (y, 53);
+          mpfr_sin (y, x0, (mpfr_rnd_t) r);
+          MPFR_ASSERTN (mpfr_equal_p (y, s[0]) && mpfr_equal_p (y, s[1])
+                        && mpfr_equal_p (y, s[2]));
+          mpfr_set_prec (y, 42);
+          mpfr_cos (y, x0, (mpfr_rnd_t) r);
+          MPFR_ASSERTN (mpfr_equal_p (y, c[0]) && mpfr_equal_p (y, c[1])
+                        && mpfr_equal_p (y, c[2]));
+        }
+    }
+  set_emin (emin);
+  for (k = 0; k < 3; k++)
+    {
+      mpfr_clear (st[k]);
+      mpfr_clear (ct[k]);
+    }
+  mpfr_clears (x0, h, y, (mpfr_ptr) 0);
+}
+
+int
+main (void)
+{
+  tests_start_mpfr ();
+
+  check_random ();
+  check_alias ();
+  check_far_exponents ();
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -88,12 +88,44 @@ special (void)
   mpfr_clear (x);
 }
 
+/* Check inputs with many more bits than the output, including one for
+   which exp(x) overflows in the extended exponent range. */
+static void
+large_input_prec (void)
+{
+  mpfr_t x, y;
+  int i, inex;
+
+  mpfr_init2 (x, 3000);
+  mpfr_init2 (y, 30);
+  for (i = 0; i < 20; i++)
+    {
+      mpfr_urandomb (x, RANDS);
+      mpfr_mul_2si (x, x, (long) (randlimb () % 60) - 50, MPFR_RNDN);
+      if (i & 1)
+        mpfr_neg (x, x, MPFR_RNDN);
+      tests_large_input (mpfr_sinh, x, "mpfr_sinh");
+    }
+
+  mpfr_urandomb (x, RANDS);
+  mpfr_add_ui (x, x, 1, MPFR_RNDN);
+  mpfr_mul_2ui (x, x, 1000000000, MPFR_RNDN);
+  mpfr_clear_flags ();
+  inex = mpfr_sinh (y, x, MPFR_RNDN);
+  MPFR_ASSERTN (MPFR_IS_INF (y) && MPFR_SIGN (y) > 0);
+  MPFR_ASSERTN (mpfr_overflow_p () && inex > 0);
+
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
 int
 main (int argc, char *argv[])
 {
   tests_start_mpfr ();
 
   special ();
+  large_input_prec ();
 
   test_generic (2, 100, 100);
 
@@ -0,0 +1,317 @@
+/* Test file for mpfr_sinu, mpfr_cosu, mpfr_tanu, mpfr_sinpi, mpfr_cospi
+   and mpfr_tanpi.
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+typedef int (*fu_t) (mpfr_ptr, mpfr_srcptr, unsigned long, mpfr_rnd_t);
+typedef int (*f_t) (mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+
+static const char *name[] = { "mpfr_sinu", "mpfr_cosu", "mpfr_tanu" };
+static fu_t fu[] = { mpfr_sinu, mpfr_cosu, mpfr_tanu };
+static f_t f[] = { mpfr_sin, mpfr_cos, mpfr_tan };
+
+/* check y = f(x, u) for x given as a string in base 10, where y is exact */
+static void
+check_exact (int i, const char *xs, unsigned long u, const char *ys,
+             int neg_zero)
+{
+  mpfr_t x, y, z;
+  int inex;
+
+  mpfr_init2 (x, 53);
+  mpfr_init2 (y, 53);
+  mpfr_init2 (z, 53);
+  mpfr_set_str (x, xs, 10, MPFR_RNDN);
+  mpfr_set_str (z, ys, 10, MPFR_RNDN);
+  if (neg_zero)
+    mpfr_neg (z, z, MPFR_RNDN);
+  mpfr_clear_flags ();
+  inex = fu[i] (y, x, u, MPFR_RNDN);
+  if (inex != 0 || ! mpfr_equal_p (y, z) || MPFR_SIGN (y) != MPFR_SIGN (z)
+      || (mpfr_inf_p (z) ? ! mpfr_divby0_p () : mpfr_divby0_p ()))
+    {
+      printf ("Error in %s for x=%s u=%lu\nexpected ", name[i], xs, u);
+      mpfr_dump (z);
+      printf ("got      ");
+      mpfr_dump (y);
+      printf ("inex = %d, divby0 = %d\n", inex, mpfr_divby0_p ());
+      exit (1);
+    }
+  mpfr_clears (x, y, z, (mpfr_ptr) 0);
+}
+
+static void
+check_special (void)
+{
+  mpfr_t x, y;
+  int i;
+
+  mpfr_init2 (x, 53);
+  mpfr_init2 (y, 53);
+
+  for (i = 0; i < 3; i++)
+    {
+      mpfr_set_nan (x);
+      fu[i] (y, x, 1, MPFR_RNDN);
+      MPFR_ASSERTN (mpfr_nan_p (y));
+      mpfr_set_inf (x, 1);
+      fu[i] (y, x, 1, MPFR_RNDN);
+      MPFR_ASSERTN (mpfr_nan_p (y));
+      mpfr_set_inf (x, -1);
+      fu[i] (y, x, 1, MPFR_RNDN);
+      MPFR_ASSERTN (mpfr_nan_p (y));
+      mpfr_set_ui (x, 1, MPFR_RNDN);
+      fu[i] (y, x, 0, MPFR_RNDN);
+      MPFR_ASSERTN (mpfr_nan_p (y));
+      mpfr_set_ui (x, 0, MPFR_RNDN);
+      fu[i] (y, x, 17, MPFR_RNDN);
+      if (i == 1)
+        MPFR_ASSERTN (mpfr_cmp_ui (y, 1) == 0);
+      else
+        MPFR_ASSERTN (MPFR_IS_ZERO (y) && MPFR_IS_POS (y));
+      mpfr_neg (x, x, MPFR_RNDN);
+      fu[i] (y, x, 17, MPFR_RNDN);
+      if (i == 1)
+        MPFR_ASSERTN (mpfr_cmp_ui (y, 1) == 0);
+      else
+        MPFR_ASSERTN (MPFR_IS_ZERO (y) && MPFR_IS_NEG (y));
+    }
+
+  /* sinu */
+  check_exact (0, "1", 4, "1", 0);
+  check_exact (0, "3", 4, "-1", 0);
+  check_exact (0, "2", 4, "0", 0);
+  check_exact (0, "-2", 4, "0", 1);
+  check_exact (0, "-4", 4, "0", 1);
+  check_exact (0, "1", 12, "0.5", 0);
+  check_exact (0, "5", 12, "0.5", 0);
+  check_exact (0, "7", 12, "-0.5", 0);
+  check_exact (0, "-11", 12, "0.5", 0);
+  check_exact (0, "3e20", 3, "0", 0);
+  /* cosu */
+  check_exact (1, "1", 4, "0", 0);
+  check_exact (1, "-3", 4, "0", 0);
+  check_exact (1, "2", 4, "-1", 0);
+  check_exact (1, "4", 4, "1", 0);
+  check_exact (1, "2", 12, "0.5", 0);
+  check_exact (1, "4", 12, "-0.5", 0);
+  check_exact (1, "-8", 12, "-0.5", 0);
+  /* tanu */
+  check_exact (2, "1", 8, "1", 0);
+  check_exact (2, "3", 8, "-1", 0);
+  check_exact (2, "-5", 8, "-1", 0);
+  check_exact (2, "2", 8, "Inf", 0);
+  check_exact (2, "6", 8, "-Inf", 0);
+  check_exact (2, "-2", 8, "-Inf", 0);
+  check_exact (2, "4", 8, "0", 1);
+  check_exact (2, "-4", 8, "0", 0);
+  check_exact (2, "8", 8, "0", 0);
+
+  /* sinpi, cospi, tanpi */
+  mpfr_set_str (x, "2.5", 10, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_sinpi (y, x, MPFR_RNDN) == 0);
+  MPFR_ASSERTN (mpfr_cmp_ui (y, 1) == 0);
+  MPFR_ASSERTN (mpfr_cospi (y, x, MPFR_RNDN) == 0 && MPFR_IS_ZERO (y)
+                && MPFR_IS_POS (y));
+  mpfr_set_str (x, "-0.25", 10, MPFR_RNDN);
+  MPFR_ASSERTN (mpfr_tanpi (y, x, MPFR_RNDN) == 0);
+  MPFR_ASSERTN (mpfr_cmp_si (y, -1) == 0);
+
+  mpfr_clear (x);
+  mpfr_clear (y);
+}
+
+/* Compute f(2*Pi*x/u) with mpfr_sin, mpfr_cos or mpfr_tan */
+static int
+reference (int i, mpfr_ptr y, mpfr_srcptr x, unsigned long u,
+           mpfr_rnd_t rnd)
+{
+  mpfr_t t;
+  mpfr_prec_t p = MPFR_PREC (y) + MPFR_GET_EXP (x) + 64;
+  mpfr_exp_t e;
+  int inex;
+
+  mpfr_init2 (t, p);
+  for (;;)
+    {
+      mpfr_const_pi (t, MPFR_RNDN);
+      mpfr_mul (t, t, x, MPFR_RNDN);
+      mpfr_mul_2ui (t, t, 1, MPFR_RNDN);
+      mpfr_div_ui (t, t, u, MPFR_RNDN);
+      /* |t - 2*Pi*x/u| < 2^(EXP(x)+5-p) since |2*Pi/u| < 8 */
+      f[i] (t, t, MPFR_RNDN);
+      /* The derivative of sin and cos is bounded by 1, the one of tan by
+         2^(2*MAX(0,EXP(t))+1). Adding the final rounding, the error is
+         less than 2^(MAX(e,EXP(t))-p). */
+      e = MPFR_GET_EXP (x) + 6;
+      if (i == 2)
+        e += 2 * MAX (0, MPFR_GET_EXP (t)) + 1;
+      e = MAX (e, MPFR_GET_EXP (t));
+      if (mpfr_can_round (t, p + MPFR_GET_EXP (t) - e, MPFR_RNDN, MPFR_RNDZ,
+                          MPFR_PREC (y) + (rnd == MPFR_RNDN)))
+        break;
+      p += p;
+      mpfr_set_prec (t, p);
+    }
+  inex = mpfr_set (y, t, rnd);
+  mpfr_clear (t);
+  return inex;
+}
+
+static void
+check_random (void)
+{
+  mpfr_t x, y, z;
+  unsigned long u;
+  mpfr_rnd_t rnd;
+  int i, n, inex1, inex2;
+
+  mpfr_init2 (x, 100);
+  for (n = 0; n < 200; n++)
+    for (i = 0; i < 3; i++)
+      {
+        mpfr_inits2 (2 + (randlimb () % 100), y, z, (mpfr_ptr) 0);
+        mpfr_urandomb (x, RANDS);
+        mpfr_mul_2si (x, x, (int) (randlimb () % 40) - 20, MPFR_RNDN);
+        if (randlimb () & 1)
+          mpfr_neg (x, x, MPFR_RNDN);
+        u = (n & 1) ? 1 + randlimb () % 100 : randlimb ();
+        if (u == 0)
+          u = 1;
+        if (MPFR_IS_ZERO (x))
+          mpfr_set_str (x, "0.3", 10, MPFR_RNDN);
+        rnd = RND_RAND ();
+        inex1 = fu[i] (y, x, u, rnd);
+        inex2 = reference (i, z, x, u, rnd);
+        if (! mpfr_equal_p (y, z) || ! SAME_SIGN (inex1, inex2))
+          {
+            printf ("Error in %s for u=%lu rnd=%s\nx=", name[i], u,
+                    mpfr_print_rnd_mode (rnd));
+            mpfr_dump (x);
+            printf ("expected ");
+            mpfr_dump (z);
+            printf ("got      ");
+            mpfr_dump (y);
+            printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+            exit (1);
+          }
+        mpfr_clears (y, z, (mpfr_ptr) 0);
+      }
+  mpfr_clear (x);
+}
+
+/* For x = 2^e + r with e >= 2, f(2*Pi*x/4) = f(2*Pi*r/4): the argument
+   reduction is exact, whatever the size of x. */
+static void
+check_huge (void)
+{
+  mpfr_exp_t e[] = { 2, 100, 10000, 1000000 };
+  mpfr_t x, r, y, z;
+  mpfr_rnd_t rnd;
+  int i, j, inex1, inex2;
+
+  mpfr_init2 (r, 20);
+  mpfr_init2 (y, 53);
+  mpfr_init2 (z, 53);
+  for (j = 0; j < (int) (sizeof (e) / sizeof (e[0])); j++)
+    for (i = 0; i < 3; i++)
+      {
+        mpfr_urandomb (r, RANDS);
+        if (MPFR_IS_ZERO (r))
+          continue;
+        /* x = 2^e + r is exact */
+        mpfr_init2 (x, e[j] + 21 - MPFR_GET_EXP (r));
+        mpfr_set_ui_2exp (x, 1, e[j], MPFR_RNDN);
+        inex1 = mpfr_add (x, x, r, MPFR_RNDN);
+        MPFR_ASSERTN (inex1 == 0);
+        rnd = RND_RAND ();
+        inex1 = fu[i] (y, x, 4, rnd);
+        inex2 = fu[i] (z, r, 4, rnd);
+        if (! mpfr_equal_p (y, z) || ! SAME_SIGN (inex1, inex2))
+          {
+            printf ("Error in %s for x = 2^%ld + r, rnd=%s\nr=", name[i],
+                    (long) e[j], mpfr_print_rnd_mode (rnd));
+            mpfr_dump (r);
+            printf ("expected ");
+            mpfr_dump (z);
+            printf ("got      ");
+            mpfr_dump (y);
+            exit (1);
+          }
+        mpfr_clear (x);
+      }
+  mpfr_clears (r, y, z, (mpfr_ptr) 0);
+}
+
+#define TEST_FUNCTION mpfr_sinpi
+#define test_generic test_generic_sinpi
+#include "tgeneric.c"
+
+#define TEST_FUNCTION mpfr_cospi
+#define test_generic test_generic_cospi
+#include "tgeneric.c"
+
+#define TEST_FUNCTION mpfr_tanpi
+#define test_generic test_generic_tanpi
+#include "tgeneric.c"
+
+#define TEST_FUNCTION mpfr_sinu
+#define INTEGER_TYPE unsigned long
+#define INT_RAND_FUNCTION() (INTEGER_TYPE) (randlimb () | 1)
+#define test_generic_ui test_generic_sinu
+#include "tgeneric_ui.c"
+
+#define TEST_FUNCTION mpfr_cosu
+#define INTEGER_TYPE unsigned long
+#define INT_RAND_FUNCTION() (INTEGER_TYPE) (randlimb () | 1)
+#define test_generic_ui test_generic_cosu
+#include "tgeneric_ui.c"
+
+#define TEST_FUNCTION mpfr_tanu
+#define INTEGER_TYPE unsigned long
+#define INT_RAND_FUNCTION() (INTEGER_TYPE) (randlimb () | 1)
+#define test_generic_ui test_generic_tanu
+#include "tgeneric_ui.c"
+
+int
+main (int argc, char *argv[])
+{
+  tests_start_mpfr ();
+
+  check_special ();
+  check_random ();
+  check_huge ();
+
+  test_generic_sinpi (2, 100, 20);
+  test_generic_cospi (2, 100, 20);
+  test_generic_tanpi (2, 100, 20);
+  test_generic_sinu (2, 100, 20);
+  test_generic_cosu (2, 100, 20);
+  test_generic_tanu (2, 100, 20);
+
+  tests_end_mpfr ();
+  return 0;
+}
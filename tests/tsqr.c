@@ -153,6 +153,95 @@ check_mpn_sqr (void)
 #endif
 }
 
+/* The operands with zero low limbs give the same results as the same
+   values in a small precision. */
+static void
+check_few_bits (void)
+{
+  mpfr_t a1, a2, b1, b2;
+  mpfr_prec_t pb;
+  int i, inex1, inex2;
+  mpfr_rnd_t rnd;
+
+  mpfr_inits2 (MPFR_PREC_MIN, a1, a2, b1, b2, (mpfr_ptr) 0);
+  for (i = 0; i < 500; i++)
+    {
+      pb = MPFR_PREC_MIN + randlimb () % 2000;
+      tests_few_bits_random (b1, b2, pb, MPFR_PREC_MIN + randlimb () % pb);
+      mpfr_set_prec (a1, MPFR_PREC_MIN + randlimb () % 4000);
+      mpfr_set_prec (a2, MPFR_PREC (a1));
+      rnd = RND_RAND ();
+      inex1 = mpfr_sqr (a1, b1, rnd);
+      inex2 = mpfr_sqr (a2, b2, rnd);
+      if (! mpfr_equal_p (a1, a2)
+          || inexact_sign (inex1) != inexact_sign (inex2))
+        {
+          printf ("Error in check_few_bits for %s\nb = ",
+                  mpfr_print_rnd_mode (rnd));
+          mpfr_dump (b1);
+          printf ("got      ");
+          mpfr_dump (a1);
+          printf ("expected ");
+          mpfr_dump (a2);
+          printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+          exit (1);
+        }
+    }
+  mpfr_clears (a1, a2, b1, b2, (mpfr_ptr) 0);
+}
+
+/* Check the squares in a destination with much fewer limbs than the
+   operand, against the exact square rounded by mpfr_set. With MPFR_RNDF,
+   the result must be the exact square rounded toward -Inf or toward
+   +Inf. */
+static void
+check_truncated (void)
+{
+  mpfr_t a1, a2, b, t;
+  int i, inex1, inex2, ok;
+  mpfr_rnd_t rnd;
+
+  mpfr_inits2 (MPFR_PREC_MIN, a1, a2, b, t, (mpfr_ptr) 0);
+  for (i = 0; i < 1000; i++)
+    {
+      mpfr_set_prec (a1, MPFR_PREC_MIN + randlimb () % 300);
+      mpfr_set_prec (a2, MPFR_PREC (a1));
+      mpfr_set_prec (b, MPFR_PREC (a1) + randlimb () % 2000);
+      mpfr_random2 (b, MPFR_LIMB_SIZE (b), 0, RANDS);
+      if (MPFR_IS_ZERO (b))
+        continue;
+      mpfr_set_prec (t, 2 * MPFR_PREC (b));
+      MPFR_ASSERTN (mpfr_mul (t, b, b, MPFR_RNDN) == 0);
+      rnd = (i % 5 == 0) ? MPFR_RNDF : RND_RAND ();
+      inex1 = mpfr_sqr (a1, b, rnd);
+      if (rnd == MPFR_RNDF)
+        {
+          inex2 = mpfr_set (a2, t, MPFR_RNDD);
+          if (! mpfr_equal_p (a1, a2))
+            inex2 = mpfr_set (a2, t, MPFR_RNDU);
+          ok = mpfr_equal_p (a1, a2);
+        }
+      else
+        {
+          inex2 = mpfr_set (a2, t, rnd);
+          ok = mpfr_equal_p (a1, a2) && SAME_SIGN (inex1, inex2);
+        }
+      if (! ok)
+        {
+          printf ("Error in check_truncated for %s\nb = ",
+                  mpfr_print_rnd_mode (rnd));
+          mpfr_dump (b);
+          printf ("got      ");
+          mpfr_dump (a1);
+          printf ("expected ");
+          mpfr_dump (a2);
+          printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+          exit (1);
+        }
+    }
+  mpfr_clears (a1, a2, b, t, (mpfr_ptr) 0);
+}
+
 int
 main (void)
 {
@@ -163,6 +252,8 @@ main (void)
   check_mpn_sqr ();
 
   check_special ();
+  check_few_bits ();
+  check_truncated ();
   for (p = 2; p < 200; p++)
     check_random (p);
 
@@ -627,6 +627,67 @@ check_rounding (void)
     }
 }
 
+/* Check the subtraction of operands with a large precision into a small
+   one (only the limbs of the operands that are needed are read), against
+   the exact difference rounded by mpfr_set. */
+static void
+check_large_operands (void)
+{
+  mpfr_t a1, a2, b, c, t;
+  mpfr_exp_t eb, ec;
+  int i, inex1, inex2;
+  mpfr_rnd_t rnd;
+
+  mpfr_inits2 (MPFR_PREC_MIN, a1, a2, b, c, t, (mpfr_ptr) 0);
+  for (i = 0; i < 2000; i++)
+    {
+      mpfr_set_prec (a1, MPFR_PREC_MIN + randlimb () % 200);
+      mpfr_set_prec (a2, MPFR_PREC (a1));
+      mpfr_set_prec (b, MPFR_PREC_MIN + randlimb () % 3000);
+      mpfr_set_prec (c, (i & 1) ? MPFR_PREC (b)
+                     : MPFR_PREC_MIN + randlimb () % 3000);
+      /* random2 gives long runs of zeros and ones, hence cancellations
+         and hard cases for the rounding */
+      mpfr_random2 (b, MPFR_LIMB_SIZE (b), 0, RANDS);
+      if (i % 8 == 0)
+        {
+          /* c close to b */
+          mpfr_set (c, b, MPFR_RNDN);
+          mpfr_nextabove (c);
+        }
+      else
+        mpfr_random2 (c, MPFR_LIMB_SIZE (c), 0, RANDS);
+      if (MPFR_IS_ZERO (b) || MPFR_IS_ZERO (c))
+        continue;
+      mpfr_mul_2si (c, c, (long) (randlimb () % 300) - 150, MPFR_RNDN);
+      if (randlimb () & 1)
+        mpfr_neg (c, c, MPFR_RNDN);
+      eb = mpfr_get_exp (b);
+      ec = mpfr_get_exp (c);
+      mpfr_set_prec (t, MAX (eb, ec) + 1
+                     - MIN (eb - MPFR_PREC (b), ec - MPFR_PREC (c)));
+      MPFR_ASSERTN (mpfr_sub (t, b, c, MPFR_RNDN) == 0);
+      rnd = RND_RAND ();
+      inex1 = test_sub (a1, b, c, rnd);
+      inex2 = mpfr_set (a2, t, rnd);
+      if (! mpfr_equal_p (a1, a2) || ! SAME_SIGN (inex1, inex2))
+        {
+          printf ("Error in check_large_operands for %s\nb = ",
+                  mpfr_print_rnd_mode (rnd));
+          mpfr_dump (b);
+          printf ("c = ");
+          mpfr_dump (c);
+          printf ("got      ");
+          mpfr_dump (a1);
+          printf ("expected ");
+          mpfr_dump (a2);
+          printf ("inex1 = %d, inex2 = %d\n", inex1, inex2);
+          exit (1);
+        }
+    }
+  mpfr_clears (a1, a2, b, c, t, (mpfr_ptr) 0);
+}
+
 #define TEST_FUNCTION test_sub
 #define TWO_ARGS
 #define RAND_FUNCTION(x) mpfr_random2(x, MPFR_LIMB_SIZE (x), randlimb () % 100, RANDS)
@@ -645,6 +706,7 @@ main (void)
   check_diverse ();
   check_inexact ();
   bug_ddefour ();
+  check_large_operands ();
   for (p=2; p<200; p++)
     for (i=0; i<50; i++)
       check_two_sum (p);
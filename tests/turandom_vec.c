@@ -0,0 +1,232 @@
+/* Test file for mpfr_urandom_vec and mpfr_urandomb_vec
+
+Copyright 2013 Free Software Foundation, Inc.
+Contributed by the AriC and Caramel projects, INRIA.
+
+This file is part of the GNU MPFR Library.
+
+The GNU MPFR Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at your
+option) any later version.
+
+The GNU MPFR Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with the GNU MPFR Library; see the file COPYING.LESSER.  If not, see
+http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpfr-test.h"
+
+#define NMAX 5000
+
+static mpfr_t xt[NMAX], yt[NMAX];
+static mpfr_ptr x[NMAX], y[NMAX];
+
+/* Set the precisions of x[0..n-1] and y[0..n-1]: all equal to prec if
+   prec != 0, random otherwise (with a few large ones). */
+static void
+set_precs (unsigned long n, mpfr_prec_t prec)
+{
+  unsigned long i;
+  mpfr_prec_t p;
+
+  for (i = 0; i < n; i++)
+    {
+      p = prec;
+      if (p == 0)
+        p = MPFR_PREC_MIN + randlimb () % (randlimb () % 16 ? 200 : 20000);
+      mpfr_set_prec (x[i], p);
+      mpfr_set_prec (y[i], p);
+    }
+}
+
+/* Check that the values are in [0,1), are multiples of 2^(-prec), and that
+   their average is close to 1/2 (for n = NMAX, the standard deviation of
+   the average is about 0.004). */
+static void
+check_urandomb (unsigned long n)
+{
+  unsigned long i;
+  double av = 0.0;
+
+  if (mpfr_urandomb_vec (x, n, RANDS) != 0)
+    {
+      printf ("Error: mpfr_urandomb_vec() returns a non-zero value\n");
+      exit (1);
+    }
+  for (i = 0; i < n; i++)
+    {
+      if (mpfr_cmp_ui (x[i], 0) < 0 || mpfr_cmp_ui (x[i], 1) >= 0
+          || (! MPFR_IS_ZERO (x[i])
+              && MPFR_GET_EXP (x[i]) - (mpfr_exp_t) mpfr_min_prec (x[i])
+              < - (mpfr_exp_t) MPFR_PREC (x[i])))
+        {
+          printf ("Error: mpfr_urandomb_vec() returns an invalid number for"
+                  " i=%lu\n", i);
+          mpfr_dump (x[i]);
+          exit (1);
+        }
+      av += mpfr_get_d (x[i], MPFR_RNDN);
+    }
+  av /= n;
+  if (n == NMAX && (av < 0.47 || av > 0.53))
+    {
+      printf ("Error: mpfr_urandomb_vec() gives average %f\n", av);
+      exit (1);
+    }
+}
+
+/* Fill x and y with the same random state in the directions rnd and
+   MPFR_RNDD, and check the results. */
+static void
+check_urandom (unsigned long n, mpfr_rnd_t rnd)
+{
+  gmp_randstate_t s;
+  unsigned long i, seed;
+  double av = 0.0;
+
+  seed = randlimb ();
+  gmp_randinit_default (s);
+  gmp_randseed_ui (s, seed);
+  if (n != 0 && mpfr_urandom_vec (x, n, s, rnd) == 0)
+    {
+      printf ("Error: mpfr_urandom_vec() returns a zero value\n");
+      exit (1);
+    }
+  gmp_randseed_ui (s, seed);
+  mpfr_urandom_vec (y, n, s, MPFR_RNDD);
+  gmp_randclear (s);
+
+  for (i = 0; i < n; i++)
+    {
+      if (mpfr_cmp_ui (x[i], 0) < 0 || mpfr_cmp_ui (x[i], 1) > 0)
+        {
+          printf ("Error: mpfr_urandom_vec() returns a number outside"
+                  " [0,1] for i=%lu\n", i);
+          mpfr_dump (x[i]);
+          exit (1);
+        }
+      /* For all rounding modes except MPFR_RNDN, the same bits are read,
+         thus x[i] is y[i] rounded upward or downward. */
+      if (rnd != MPFR_RNDN)
+        {
+          if (rnd == MPFR_RNDU || rnd == MPFR_RNDA)
+            mpfr_nextabove (y[i]);
+          if (! mpfr_equal_p (x[i], y[i]))
+            {
+              printf ("Error: mpfr_urandom_vec() is inconsistent for %s,"
+                      " i=%lu\n", mpfr_print_rnd_mode (rnd), i);
+              mpfr_dump (x[i]);
+              mpfr_dump (y[i]);
+              exit (1);
+            }
+        }
+      av += mpfr_get_d (x[i], MPFR_RNDN);
+    }
+  if (n == NMAX && (av / n < 0.47 || av / n > 0.53))
+    {
+      printf ("Error: mpfr_urandom_vec() gives average %f\n", av / n);
+      exit (1);
+    }
+}
+
+/* The results only depend on the random state and on the precisions. */
+static void
+check_reproducible (unsigned long n)
+{
+  gmp_randstate_t s;
+  unsigned long i;
+
+  gmp_randinit_default (s);
+  gmp_randseed_ui (s, 17);
+  mpfr_urandom_vec (x, n, s, MPFR_RNDN);
+  mpfr_urandomb_vec (x + n, n, s);
+  gmp_randseed_ui (s, 17);
+  mpfr_urandom_vec (y, n, s, MPFR_RNDN);
+  mpfr_urandomb_vec (y + n, n, s);
+  gmp_randclear (s);
+  for (i = 0; i < 2 * n; i++)
+    if (! mpfr_equal_p (x[i], y[i]))
+      {
+        printf ("Error: mpfr_urandom_vec() is not reproducible, i=%lu\n", i);
+        exit (1);
+      }
+}
+
+/* In a reduced exponent range, the results are those of mpfr_urandom:
+   0 or 2^(emin-1) for emin > 0, and no number in (0, 2^(emin-1)). */
+static void
+check_exp_range (void)
+{
+  mpfr_exp_t emin;
+  unsigned long i;
+  int r, k;
+
+  emin = mpfr_get_emin ();
+  set_precs (NMAX, 2);
+  for (k = -4; k <= 2; k++)
+    RND_LOOP (r)
+      {
+        set_emin (k);
+        mpfr_urandom_vec (x, 1000, RANDS, (mpfr_rnd_t) r);
+        set_emin (emin);
+        for (i = 0; i < 1000; i++)
+          if (mpfr_cmp_ui (x[i], 0) < 0
+              || (! MPFR_IS_ZERO (x[i]) && MPFR_GET_EXP (x[i]) < k)
+              || (k > 0 && ! MPFR_IS_ZERO (x[i])
+                  && mpfr_cmp_ui_2exp (x[i], 1, k - 1) != 0))
+            {
+              printf ("Error: mpfr_urandom_vec() with emin=%d, %s\n", k,
+                      mpfr_print_rnd_mode ((mpfr_rnd_t) r));
+              mpfr_dump (x[i]);
+              exit (1);
+            }
+      }
+}
+
+int
+main (void)
+{
+  unsigned long i;
+  int r;
+
+  tests_start_mpfr ();
+
+  for (i = 0; i < NMAX; i++)
+    {
+      x[i] = xt[i];
+      y[i] = yt[i];
+      mpfr_init2 (x[i], MPFR_PREC_MIN);
+      mpfr_init2 (y[i], MPFR_PREC_MIN);
+    }
+
+  set_precs (NMAX, 53);
+  check_urandomb (NMAX);
+  RND_LOOP (r)
+    check_urandom (NMAX, (mpfr_rnd_t) r);
+  for (i = 0; i < 10; i++)
+    {
+      set_precs (NMAX, i < 5 ? 0 : MPFR_PREC_MIN + randlimb () % 100);
+      check_urandomb (1 + randlimb () % 100);
+      check_urandom (randlimb () % 100, RND_RAND ());
+      check_reproducible (1 + randlimb () % (NMAX / 2));
+    }
+  check_exp_range ();
+
+  for (i = 0; i < NMAX; i++)
+    {
+      mpfr_clear (x[i]);
+      mpfr_clear (y[i]);
+    }
+
+  tests_end_mpfr ();
+  return 0;
+}
@@ -184,6 +184,43 @@ test2 (void)
   mpfr_clears (x, y, (mpfr_ptr) 0);
 }
 
+/* the coefficients of the Euler-Maclaurin summation are kept across calls
+   with the same precision: check that the results do not depend on the
+   order of the calls */
+static void
+test_cache (void)
+{
+  mpfr_t x, y[10], z;
+  int i;
+
+  mpfr_init2 (x, 20);
+  mpfr_init2 (z, 200);
+  for (i = 0; i < 10; i++)
+    {
+      mpfr_init2 (y[i], 200);
+      mpfr_set_ui (x, 11 * i + 3, MPFR_RNDN);
+      mpfr_div_ui (x, x, 4, MPFR_RNDN);
+      mpfr_zeta (y[i], x, MPFR_RNDN);
+    }
+  for (i = 9; i >= 0; i--)
+    {
+      mpfr_free_cache ();
+      mpfr_set_ui (x, 11 * i + 3, MPFR_RNDN);
+      mpfr_div_ui (x, x, 4, MPFR_RNDN);
+      mpfr_zeta (z, x, MPFR_RNDN);
+      if (! mpfr_equal_p (z, y[i]))
+        {
+          printf ("Error in test_cache for s=%d/4\nexpected ", 11 * i + 3);
+          mpfr_dump (z);
+          printf ("got      ");
+          mpfr_dump (y[i]);
+          exit (1);
+        }
+      mpfr_clear (y[i]);
+    }
+  mpfr_clears (x, z, (mpfr_ptr) 0);
+}
+
 #define TEST_FUNCTION mpfr_zeta
 #define TEST_RANDOM_EMIN -48
 #define TEST_RANDOM_EMAX 31
@@ -397,6 +434,7 @@ main (int argc, char *argv[])
 
   test_generic (2, 70, 5);
   test2 ();
+  test_cache ();
 
   tests_end_mpfr ();
   return 0;
@@ -24,6 +24,60 @@ http://www.gnu.org/licenses/ or write to the Free Software Foundation, Inc.,
 
 #define TEST_FUNCTION mpfr_zeta_ui
 
+#define NVEC 80
+
+/* compare mpfr_zeta_ui_vec with mpfr_zeta_ui */
+static void
+check_vec (void)
+{
+  mpfr_t zt[NVEC], y;
+  mpfr_ptr z[NVEC];
+  unsigned long m0, n, i;
+  int j, inex, inex_ref;
+  mpfr_rnd_t rnd;
+
+  mpfr_init (y);
+  for (i = 0; i < NVEC; i++)
+    {
+      z[i] = zt[i];
+      mpfr_init (z[i]);
+    }
+  for (j = 0; j < 30; j++)
+    {
+      m0 = (j < 3) ? (unsigned long) j : randlimb () % 100;
+      n = 1 + randlimb () % NVEC;
+      rnd = RND_RAND ();
+      for (i = 0; i < n; i++)
+        mpfr_set_prec (z[i], (j & 1) ? 2 + randlimb () % 200 : 150);
+      inex = mpfr_zeta_ui_vec (z, m0, n, rnd);
+      inex_ref = 0;
+      for (i = 0; i < n; i++)
+        {
+          mpfr_set_prec (y, MPFR_PREC (z[i]));
+          inex_ref |= mpfr_zeta_ui (y, m0 + i, rnd) != 0;
+          if (! mpfr_equal_p (y, z[i]))
+            {
+              printf ("Error in mpfr_zeta_ui_vec for m=%lu, prec=%lu, "
+                      "rnd=%s\nexpected ", m0 + i,
+                      (unsigned long) MPFR_PREC (y), mpfr_print_rnd_mode (rnd));
+              mpfr_dump (y);
+              printf ("got      ");
+              mpfr_dump (z[i]);
+              exit (1);
+            }
+        }
+      if ((inex != 0) != inex_ref)
+        {
+          printf ("Wrong ternary value in mpfr_zeta_ui_vec for m0=%lu, "
+                  "n=%lu\n", m0, n);
+          exit (1);
+        }
+    }
+  for (i = 0; i < NVEC; i++)
+    mpfr_clear (z[i]);
+  mpfr_clear (y);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -107,6 +161,8 @@ main (int argc, char *argv[])
           }
     }
 
+  check_vec ();
+
  clear_and_exit:
   mpfr_clear (x);
   mpfr_clear (y);
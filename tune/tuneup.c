@@ -273,6 +273,17 @@ speed_mpfr_sincos (struct speed_params *s)
   SPEED_MPFR_FUNC2 (mpfr_sin_cos);
 }
 
+/* Setup mpfr_atan */
+mpfr_prec_t mpfr_atan_threshold;
+#undef MPFR_ATAN_THRESHOLD
+#define MPFR_ATAN_THRESHOLD mpfr_atan_threshold
+#include "atan.c"
+static double
+speed_mpfr_atan (struct speed_params *s)
+{
+  SPEED_MPFR_FUNC (mpfr_atan);
+}
+
 /* Setup mpfr_mul, mpfr_sqr and mpfr_div */
 mpfr_prec_t mpfr_mul_threshold;
 mpfr_prec_t mpfr_sqr_threshold;
@@ -1108,6 +1119,14 @@ all (const char *filename)
   fprintf (f, "#define MPFR_SINCOS_THRESHOLD %lu /* bits */\n",
            (unsigned long) mpfr_sincos_threshold);
 
+  /* Tune mpfr_atan */
+  if (verbose)
+    printf ("Tuning mpfr_atan...\n");
+  tune_simple_func (&mpfr_atan_threshold, speed_mpfr_atan,
+                    MPFR_PREC_MIN+3*GMP_NUMB_BITS);
+  fprintf (f, "#define MPFR_ATAN_THRESHOLD %lu /* bits */\n",
+           (unsigned long) mpfr_atan_threshold);
+
   /* Tune mpfr_ai */
   if (verbose)
     printf ("Tuning mpfr_ai...\n");